@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.eschao.android.widget.jni.pageflip;
+
+import android.os.Build;
+import android.os.SystemClock;
+import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
+
+import org.junit.AfterClass;
+import org.junit.BeforeClass;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Microbenchmark of JNI call overhead
+ * <p>Every getter annotated with @CriticalNative is timed against its
+ * regular twin, e.g. getFlipState() against getFlipStateRegular(), both are
+ * bound to the same native function, so the difference is only the JNI
+ * transition. Results are printed to logcat with tag JNICallBenchmark. Run
+ * it on a device:</p>
+ * <pre>
+ *     ./gradlew :PageFlipLib:connectedAndroidTest
+ * </pre>
+ * <p>Critical natives are only registered on Android 8.0+, on old devices
+ * both columns are regular natives. Finger events and drawing aren't timed,
+ * they may wait for geometry worker and stay regular natives.</p>
+ *
+ * @author eschao
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNICallBenchmark {
+
+    private static final String TAG = "JNICallBenchmark";
+    private static final int WARM_UP_CALLS = 100000;
+    private static final int CALLS = 1000000;
+    private static final int ROUNDS = 5;
+
+    // sink of results, so calls can't be optimized out
+    private static int mSink = 0;
+
+    private interface Call {
+        void run(int count);
+    }
+
+    @BeforeClass
+    public static void setUp() {
+        assertTrue(PageFlipLib.init());
+    }
+
+    @AfterClass
+    public static void tearDown() {
+        PageFlipLib.release();
+    }
+
+    /**
+     * Time calls and return the best nanoseconds per call of all rounds
+     */
+    private static double time(Call call) {
+        call.run(WARM_UP_CALLS);
+        long best = Long.MAX_VALUE;
+        for (int i = 0; i < ROUNDS; ++i) {
+            final long start = SystemClock.elapsedRealtimeNanos();
+            call.run(CALLS);
+            best = Math.min(best, SystemClock.elapsedRealtimeNanos() - start);
+        }
+
+        return (double)best / CALLS;
+    }
+
+    private static void report(String name, double critical, double regular) {
+        Log.i(TAG, String.format("%s: critical %.1f ns, regular %.1f ns "
+                                 + "(API %d)", name, critical, regular,
+                                 Build.VERSION.SDK_INT));
+    }
+
+    @Test
+    public void intGetter() {
+        final double critical = time(new Call() {
+            public void run(int count) {
+                for (int i = 0; i < count; ++i) {
+                    mSink += PageFlipLib.getFlipState();
+                }
+            }
+        });
+        final double regular = time(new Call() {
+            public void run(int count) {
+                for (int i = 0; i < count; ++i) {
+                    mSink += PageFlipLib.getFlipStateRegular();
+                }
+            }
+        });
+        report("getFlipState()", critical, regular);
+    }
+
+    @Test
+    public void booleanGetter() {
+        final double critical = time(new Call() {
+            public void run(int count) {
+                for (int i = 0; i < count; ++i) {
+                    mSink += PageFlipLib.isAnimating() ? 1 : 0;
+                }
+            }
+        });
+        final double regular = time(new Call() {
+            public void run(int count) {
+                for (int i = 0; i < count; ++i) {
+                    mSink += PageFlipLib.isAnimatingRegular() ? 1 : 0;
+                }
+            }
+        });
+        report("isAnimating()", critical, regular);
+    }
+
+    @Test
+    public void booleanGetterWithArgument() {
+        final double critical = time(new Call() {
+            public void run(int count) {
+                for (int i = 0; i < count; ++i) {
+                    mSink += PageFlipLib.isFirstTextureSet(true) ? 1 : 0;
+                }
+            }
+        });
+        final double regular = time(new Call() {
+            public void run(int count) {
+                for (int i = 0; i < count; ++i) {
+                    mSink += PageFlipLib.isFirstTextureSetRegular(true)
+                             ? 1 : 0;
+                }
+            }
+        });
+        report("isFirstTextureSet(boolean)", critical, regular);
+    }
+}
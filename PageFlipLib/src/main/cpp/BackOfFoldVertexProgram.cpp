@@ -15,7 +15,7 @@
  */
 
 #include "BackOfFoldVertexProgram.h"
-#include "constant.h"
+#include "Constant.h"
 
 namespace eschao {
 
@@ -16,34 +16,20 @@
 
 #include "Page.h"
 #include "BackOfFoldVertexes.h"
-#include "BackOfFoldVertexProgram.h"
+#include "RenderBackend.h"
 
 namespace eschao {
 
-void BackOfFoldVertexes::draw(BackOfFoldVertexProgram &program,
+void BackOfFoldVertexes::draw(RenderBackend &backend,
                               Page &page,
                               bool hasSecondPage,
                               GLuint gradientLightId) {
-    glUniformMatrix4fv(program.mvpMatrixLoc(), 1, GL_FALSE,
-                       VertexProgram::MVPMatrix);
-
-    glBindTexture(GL_TEXTURE_2D, page.textures.backTextureId());
-    glUniform1i(program.textureLoc(), 0);
-
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, gradientLightId);
-    glUniform1i(program.shadowLoc(), 1);
-
-    glUniform1f(program.texXOffsetLoc(), hasSecondPage ? 1.0f : 0);
-
-    const float *maskColor = page.textures.getMaskColorOfFirstTexture();
-    glUniform4f(program.maskColorLoc(),
-                maskColor[0], maskColor[1], maskColor[2],
-                hasSecondPage ? 0 : mMaskAlpha);
-
-    drawWith(GL_TRIANGLE_STRIP,
-             program.vertexPosLoc(),
-             program.texCoordLoc());
+    backend.drawBackOfFold(mVertexes.data(), mTexCoords.data(), count(),
+                           page.textures.backTextureId(),
+                           gradientLightId,
+                           page.textures.getMaskColorOfFirstTexture(),
+                           hasSecondPage ? 0 : mMaskAlpha,
+                           hasSecondPage ? 1.0f : 0);
 }
 
 }
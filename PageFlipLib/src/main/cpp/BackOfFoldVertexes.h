@@ -24,7 +24,7 @@ namespace eschao {
 
 class Page;
 
-class BackOfFoldVertexProgram;
+class RenderBackend;
 
 class BackOfFoldVertexes : public Vertexes {
 
@@ -32,7 +32,7 @@ public:
     BackOfFoldVertexes() : mMaskAlpha(0.6f) { };
     ~BackOfFoldVertexes() { };
 
-    void draw(BackOfFoldVertexProgram &program, Page &page,
+    void draw(RenderBackend &backend, Page &page,
               bool hasSecondPage, GLuint gradientLightId);
 
     //inline
@@ -40,6 +40,18 @@ public:
         Vertexes::set(meshCount << 1, 4, true);
     }
 
+    inline int set(VertexArena &arena, int meshCount) {
+        return Vertexes::set(arena, meshCount << 1, 4, true);
+    }
+
+    static inline size_t sizeInArena(int meshCount) {
+        return Vertexes::sizeInArena(meshCount << 1, 4, true);
+    }
+
+    inline float maskAlpha() {
+        return mMaskAlpha;
+    }
+
     inline int setMaskAlpha(int alpha) {
         if (alpha < 0 || alpha > 255) {
             return gError.set(Error::ERR_INVALID_PARAMETER);
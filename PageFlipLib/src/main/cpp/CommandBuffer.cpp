@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "CommandBuffer.h"
+#include "PageFlip.h"
+
+namespace eschao {
+
+static const auto TAG = "CommandBuffer";
+
+const int CommandBuffer::mArgCounts[CMD_COUNT] = {
+        -1, // invalid
+        2,  // CMD_FINGER_DOWN: x, y
+        4,  // CMD_FINGER_MOVE: x, y, can forward, can backward
+        5,  // CMD_FINGER_UP: x, y, duration, can forward, can backward
+        2,  // CMD_CAN_ANIMATE: x, y
+        0,  // CMD_ANIMATING
+        0,  // CMD_ABORT_ANIMATING
+        0,  // CMD_RECYCLE_TEXTURES
+        0,  // CMD_SET_FIRST_TEXTURE_WITH_SECOND
+        0,  // CMD_SET_SECOND_TEXTURE_WITH_FIRST
+        0,  // CMD_SWAP_SECOND_TEXTURES_WITH_FIRST
+        4,  // CMD_SET_TEXTURE_OF_PAGE: texture, is first page, page index,
+            //                          only if texture isn't set
+        0,  // CMD_DRAW_FLIP_FRAME
+        0,  // CMD_DRAW_PAGE_FRAME
+};
+
+CommandBuffer::CommandBuffer(void *buffer, size_t size)
+        : mWords((int32_t *)buffer),
+          mCapacity(size / sizeof(int32_t)) {
+}
+
+/**
+ * Execute all commands and write back state
+ *
+ * @param pageFlip PageFlip object
+ * @return Error::OK if all commands are executed successfully, otherwise
+ *         the first error
+ */
+int CommandBuffer::execute(PageFlip &pageFlip) {
+    if (mWords == NULL || mCapacity < kHeaderSize) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    int error = Error::OK;
+    size_t end = kHeaderSize + (size_t)mWords[0];
+    if (mWords[0] < 0 || end > mCapacity) {
+        LOGE(TAG, "Invalid word count of commands: %d", mWords[0]);
+        error = Error::ERR_INVALID_PARAMETER;
+        end = kHeaderSize;
+    }
+
+    for (size_t i = kHeaderSize; i < end;) {
+        const int command = mWords[i];
+        if (command < CMD_FINGER_DOWN || command >= CMD_COUNT ||
+            i + 2 + mArgCounts[command] > end) {
+            LOGE(TAG, "Invalid command: %d at word: %zu", command, i);
+            error = Error::ERR_INVALID_PARAMETER;
+            break;
+        }
+
+        int ret = execute(pageFlip, command, mWords + i + 2, mWords[i + 1]);
+        if (ret != Error::OK && error == Error::OK) {
+            error = ret;
+        }
+        i += 2 + mArgCounts[command];
+    }
+
+    writeState(pageFlip);
+    mWords[3] = error;
+    return gError.set(error);
+}
+
+int CommandBuffer::execute(PageFlip &pageFlip, int command,
+                           const int32_t *args, int32_t &result) {
+    int ret = Error::OK;
+    switch (command) {
+        case CMD_FINGER_DOWN:
+            result = pageFlip.onFingerDown(toFloat(args[0]),
+                                           toFloat(args[1]));
+            return Error::OK;
+
+        case CMD_FINGER_MOVE:
+            result = pageFlip.onFingerMove(toFloat(args[0]),
+                                           toFloat(args[1]),
+                                           args[2] != 0, args[3] != 0);
+            return Error::OK;
+
+        case CMD_FINGER_UP:
+            result = pageFlip.onFingerUp(toFloat(args[0]), toFloat(args[1]),
+                                         args[2], args[3] != 0, args[4] != 0);
+            return Error::OK;
+
+        case CMD_CAN_ANIMATE:
+            result = pageFlip.canAnimate(toFloat(args[0]), toFloat(args[1]));
+            return Error::OK;
+
+        case CMD_ANIMATING:
+            result = pageFlip.animating();
+            return Error::OK;
+
+        case CMD_ABORT_ANIMATING:
+            pageFlip.abortAnimating();
+            break;
+
+        case CMD_RECYCLE_TEXTURES:
+            pageFlip.recycleTextures();
+            break;
+
+        case CMD_SET_FIRST_TEXTURE_WITH_SECOND:
+        case CMD_SET_SECOND_TEXTURE_WITH_FIRST: {
+            Page *page = pageFlip.getPage(true);
+            if (page == NULL) {
+                ret = Error::ERR_NULL_PAGE;
+            }
+            else if (command == CMD_SET_FIRST_TEXTURE_WITH_SECOND) {
+                page->textures.setFirstTextureWithSecond();
+            }
+            else {
+                page->textures.setSecondTextureWithFirst();
+            }
+            break;
+        }
+
+        case CMD_SWAP_SECOND_TEXTURES_WITH_FIRST: {
+            Page *first = pageFlip.getPage(true);
+            Page *second = pageFlip.getPage(false);
+            if (first == NULL || second == NULL) {
+                ret = Error::ERR_NULL_PAGE;
+            }
+            else {
+                second->textures.swapTexturesWith(first->textures);
+            }
+            break;
+        }
+
+        case CMD_SET_TEXTURE_OF_PAGE: {
+            const int index = args[0];
+            const bool isFirstPage = args[1] != 0;
+            Page *page = pageFlip.getPage(isFirstPage);
+            if (index < FIRST_TEXTURE_ID || index > BACK_TEXTURE_ID) {
+                ret = Error::ERR_INVALID_PARAMETER;
+            }
+            else if (page == NULL) {
+                ret = Error::ERR_NULL_PAGE;
+            }
+            else if (!args[3] || !page->textures.isSet(index)) {
+                ret = pageFlip.setTextureOfPage(index, isFirstPage, args[2]);
+            }
+            break;
+        }
+
+        case CMD_DRAW_FLIP_FRAME:
+            pageFlip.drawFlipFrame();
+            break;
+
+        case CMD_DRAW_PAGE_FRAME:
+            pageFlip.drawPageFrame();
+            break;
+
+        default:
+            ret = Error::ERR_INVALID_PARAMETER;
+            break;
+    }
+
+    result = ret;
+    return ret;
+}
+
+/**
+ * Write flip state and state flags to header
+ */
+void CommandBuffer::writeState(PageFlip &pageFlip) {
+    int32_t flags = 0;
+    if (pageFlip.isAnimating()) {
+        flags |= STATE_ANIMATING;
+    }
+
+    Page *first = pageFlip.getPage(true);
+    if (first) {
+        flags |= STATE_HAS_FIRST_PAGE;
+        if (first->textures.isFirstTextureSet()) {
+            flags |= STATE_FIRST_PAGE_FIRST_TEXTURE;
+        }
+        if (first->textures.isSecondTextureSet()) {
+            flags |= STATE_FIRST_PAGE_SECOND_TEXTURE;
+        }
+        if (first->textures.isBackTextureSet()) {
+            flags |= STATE_FIRST_PAGE_BACK_TEXTURE;
+        }
+    }
+
+    Page *second = pageFlip.getPage(false);
+    if (second) {
+        flags |= STATE_HAS_SECOND_PAGE;
+        if (second->textures.isFirstTextureSet()) {
+            flags |= STATE_SECOND_PAGE_FIRST_TEXTURE;
+        }
+        if (second->textures.isSecondTextureSet()) {
+            flags |= STATE_SECOND_PAGE_SECOND_TEXTURE;
+        }
+        if (second->textures.isBackTextureSet()) {
+            flags |= STATE_SECOND_PAGE_BACK_TEXTURE;
+        }
+    }
+
+    mWords[1] = pageFlip.flipState();
+    mWords[2] = flags;
+}
+
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_COMMANDBUFFER_H
+#define ANDROID_PAGEFLIP_COMMANDBUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace eschao {
+
+class PageFlip;
+
+/**
+ * Commands of command buffer, they must be same with PageFlipCommands.java
+ */
+enum Command {
+    CMD_FINGER_DOWN = 1,
+    CMD_FINGER_MOVE,
+    CMD_FINGER_UP,
+    CMD_CAN_ANIMATE,
+    CMD_ANIMATING,
+    CMD_ABORT_ANIMATING,
+    CMD_RECYCLE_TEXTURES,
+    CMD_SET_FIRST_TEXTURE_WITH_SECOND,
+    CMD_SET_SECOND_TEXTURE_WITH_FIRST,
+    CMD_SWAP_SECOND_TEXTURES_WITH_FIRST,
+    CMD_SET_TEXTURE_OF_PAGE,
+    CMD_DRAW_FLIP_FRAME,
+    CMD_DRAW_PAGE_FRAME,
+    CMD_COUNT,
+};
+
+/**
+ * State flags written back after executing command buffer
+ */
+enum CommandState {
+    STATE_ANIMATING                  = 0x0001,
+    STATE_HAS_FIRST_PAGE             = 0x0002,
+    STATE_HAS_SECOND_PAGE            = 0x0004,
+    STATE_FIRST_PAGE_FIRST_TEXTURE   = 0x0008,
+    STATE_FIRST_PAGE_SECOND_TEXTURE  = 0x0010,
+    STATE_FIRST_PAGE_BACK_TEXTURE    = 0x0020,
+    STATE_SECOND_PAGE_FIRST_TEXTURE  = 0x0040,
+    STATE_SECOND_PAGE_SECOND_TEXTURE = 0x0080,
+    STATE_SECOND_PAGE_BACK_TEXTURE   = 0x0100,
+};
+
+/**
+ * Execute a batch of commands written by Java in a direct ByteBuffer with
+ * only one JNI call per frame
+ * <p>Buffer is an array of 32-bit words in native byte order, floats are
+ * stored with their raw bits:</p>
+ * <pre>
+ *     header:  [word count of commands][flip state][state flags][error]
+ *     command: [command][result][arguments ...]
+ * </pre>
+ * <p>Word count is written by Java, flip state, state flags and error(the
+ * first error of commands) are written back by native. Result of a command
+ * is 0 or 1 for boolean command and error code for others. Execution stops
+ * at the first invalid command.</p>
+ */
+class CommandBuffer {
+
+public:
+    CommandBuffer(void *buffer, size_t size);
+
+    int execute(PageFlip &pageFlip);
+
+    static const int kHeaderSize = 4;
+
+private:
+    int execute(PageFlip &pageFlip, int command, const int32_t *args,
+                int32_t &result);
+    void writeState(PageFlip &pageFlip);
+
+    inline float toFloat(int32_t bits) {
+        union {
+            int32_t i;
+            float f;
+        } v;
+
+        v.i = bits;
+        return v.f;
+    }
+
+private:
+    int32_t *mWords;
+    size_t mCapacity;
+
+    // argument count of every command
+    static const int mArgCounts[CMD_COUNT];
+};
+
+}
+#endif //ANDROID_PAGEFLIP_COMMANDBUFFER_H
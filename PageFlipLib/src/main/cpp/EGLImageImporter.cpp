@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EGLImageImporter.h"
+#include "Error.h"
+#include "Utility.h"
+
+#ifndef EGL_NATIVE_BUFFER_ANDROID
+#define EGL_NATIVE_BUFFER_ANDROID   0x3140
+#endif
+
+#ifndef EGL_IMAGE_PRESERVED_KHR
+#define EGL_IMAGE_PRESERVED_KHR     0x30D2
+#endif
+
+namespace eschao {
+
+static const auto TAG = "EGLImageImporter";
+
+EGLImageImporter::EGLImageImporter()
+        : mIsLoaded(false),
+          mGetNativeClientBuffer(NULL),
+          mCreateImage(NULL),
+          mDestroyImage(NULL),
+          mImageTargetTexture(NULL) {
+}
+
+/**
+ * Load extension functions, it should be called in GL thread
+ */
+bool EGLImageImporter::loadFunctions() {
+    if (!mIsLoaded) {
+        mIsLoaded = true;
+        mGetNativeClientBuffer = (GetNativeClientBufferFunc)
+                eglGetProcAddress("eglGetNativeClientBufferANDROID");
+        mCreateImage = (CreateImageFunc)
+                eglGetProcAddress("eglCreateImageKHR");
+        mDestroyImage = (DestroyImageFunc)
+                eglGetProcAddress("eglDestroyImageKHR");
+        mImageTargetTexture = (ImageTargetTextureFunc)
+                eglGetProcAddress("glEGLImageTargetTexture2DOES");
+    }
+
+    return mGetNativeClientBuffer && mCreateImage &&
+           mDestroyImage && mImageTargetTexture;
+}
+
+bool EGLImageImporter::isSupported() {
+    return loadFunctions();
+}
+
+int EGLImageImporter::import(void *buffer, GLuint &texId, void *&image) {
+    if (buffer == NULL) {
+        return gError.set(Error::ERR_NULL_PARAMETER);
+    }
+
+    if (!loadFunctions()) {
+        LOGE(TAG, "EGLImage from hardware buffer is not supported!");
+        return gError.set(Error::ERR_UNSUPPORT_HARDWARE_BUFFER);
+    }
+
+    EGLDisplay display = eglGetCurrentDisplay();
+    EGLClientBuffer clientBuffer = mGetNativeClientBuffer(buffer);
+    if (display == EGL_NO_DISPLAY || clientBuffer == NULL) {
+        return gError.set(Error::ERR_IMPORT_HARDWARE_BUFFER);
+    }
+
+    const EGLint attribs[] = { EGL_IMAGE_PRESERVED_KHR, EGL_TRUE, EGL_NONE };
+    EGLImageKHR eglImage = mCreateImage(display, EGL_NO_CONTEXT,
+                                        EGL_NATIVE_BUFFER_ANDROID,
+                                        clientBuffer, attribs);
+    if (eglImage == EGL_NO_IMAGE_KHR) {
+        LOGE(TAG, "Can't create EGLImage, error: 0x%x", eglGetError());
+        return gError.set(Error::ERR_IMPORT_HARDWARE_BUFFER);
+    }
+
+    GLuint id;
+    glGenTextures(1, &id);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    mImageTargetTexture(GL_TEXTURE_2D, eglImage);
+
+    if (gError.checkGlError("When bind EGLImage to texture") != Error::OK) {
+        glDeleteTextures(1, &id);
+        mDestroyImage(display, eglImage);
+        return gError.set(Error::ERR_IMPORT_HARDWARE_BUFFER);
+    }
+
+    texId = id;
+    image = eglImage;
+    return Error::OK;
+}
+
+void EGLImageImporter::release(void *image) {
+    if (image && loadFunctions()) {
+        mDestroyImage(eglGetCurrentDisplay(), (EGLImageKHR)image);
+    }
+}
+
+}
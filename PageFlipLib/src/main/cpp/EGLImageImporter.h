@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_EGLIMAGEIMPORTER_H
+#define ANDROID_PAGEFLIP_EGLIMAGEIMPORTER_H
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include "TextureImporter.h"
+
+namespace eschao {
+
+/**
+ * Import AHardwareBuffer as texture through EGLImage
+ * <p>All extension functions are loaded at runtime, so library still works
+ * on old devices which don't support EGL_ANDROID_get_native_client_buffer
+ * (Android 8.0+), {@link #isSupported()} will return false on them</p>
+ */
+class EGLImageImporter : public TextureImporter {
+
+public:
+    EGLImageImporter();
+
+    virtual bool isSupported();
+    virtual int import(void *buffer, GLuint &texId, void *&image);
+    virtual void release(void *image);
+
+private:
+    bool loadFunctions();
+
+private:
+    typedef EGLClientBuffer (*GetNativeClientBufferFunc)(const void *buffer);
+    typedef EGLImageKHR (*CreateImageFunc)(EGLDisplay dpy, EGLContext ctx,
+                                           EGLenum target,
+                                           EGLClientBuffer buffer,
+                                           const EGLint *attribs);
+    typedef EGLBoolean (*DestroyImageFunc)(EGLDisplay dpy, EGLImageKHR image);
+    typedef void (*ImageTargetTextureFunc)(GLenum target, void *image);
+
+    // is extension functions loaded
+    bool mIsLoaded;
+    GetNativeClientBufferFunc mGetNativeClientBuffer;
+    CreateImageFunc mCreateImage;
+    DestroyImageFunc mDestroyImage;
+    ImageTargetTextureFunc mImageTargetTexture;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_EGLIMAGEIMPORTER_H
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <string.h>
 #include <string>
 #include "Error.h"
 
@@ -33,8 +34,8 @@ void Error::setDesc(const char *desc) {
             len = MAX_ERR_DESC_LENGTH;
         }
 
-        strncpy(mDesc, desc, len);
-        mDesc[len + 1] = '\0';
+        memcpy(mDesc, desc, len);
+        mDesc[len] = '\0';
     }
 }
 
@@ -45,7 +46,8 @@ int Error::checkGlError(const char *desc) {
 
     GLenum err;
     while ((err = glGetError()) != GL_NO_ERROR) {
-        sprintf(mDesc, "%s, glGetError() return 0x%x", mDesc, err);
+        snprintf(mDesc, sizeof(mDesc), "%s, glGetError() return 0x%x",
+                 desc, err);
         return Error::ERR_GL_ERROR;
     }
 
@@ -81,6 +81,12 @@ public:
     static const int ERR_GET_BITMAP_DATA            = OK - 14;
     static const int ERR_NO_TWO_PAGES               = OK - 15;
     static const int ERR_NULL_PAGE                  = OK - 16;
+    static const int ERR_UNSUPPORT_HARDWARE_BUFFER  = OK - 17;
+    static const int ERR_IMPORT_HARDWARE_BUFFER     = OK - 18;
+    static const int ERR_UNSUPPORT_IMAGE_DECODER    = OK - 19;
+    static const int ERR_DECODE_IMAGE               = OK - 20;
+    static const int ERR_NO_PAGE_SOURCE             = OK - 21;
+    static const int ERR_UNSUPPORT_GLES3            = OK - 22;
 
 private:
     int mCode;
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "FixedPoint.h"
+
+namespace eschao {
+
+// sin(i * PI / 512) in Q16.16, i = [0 .. 256]
+static const int32_t kQuarterSine[] = {
+        0, 402, 804, 1206, 1608, 2010, 2412, 2814,
+        3216, 3617, 4019, 4420, 4821, 5222, 5623, 6023,
+        6424, 6824, 7224, 7623, 8022, 8421, 8820, 9218,
+        9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391,
+        12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+        15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+        19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699,
+        22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708,
+        25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+        28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+        30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347,
+        33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+        36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716,
+        39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264,
+        41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+        44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056,
+        46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288,
+        48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+        50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398,
+        52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+        54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+        56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607,
+        57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071,
+        59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+        60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+        61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596,
+        62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+        63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197,
+        64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766,
+        64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+        65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436,
+        65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535,
+        65536
+};
+
+// 1 / (2 * PI) in Q0.32
+static const int64_t kInvTwoPI = 683565276;
+
+// bits of phase in one turn, a quarter has 2^22 steps
+static const int kPhaseBits = 24;
+static const int kQuarterBits = kPhaseBits - 2;
+static const int kLerpBits = kQuarterBits - 8;
+
+/**
+ * Convert radian to phase of one turn, the phase wraps around naturally
+ */
+static inline uint32_t phaseOf(Fixed rad) {
+    // Q16.16 * Q0.32 = Q16.48, keep the top bits of fraction part
+    const uint64_t turns = (uint64_t)((int64_t)rad.raw() * kInvTwoPI);
+    return (uint32_t)(turns >> (48 - kPhaseBits)) & ((1 << kPhaseBits) - 1);
+}
+
+/**
+ * Look up sine of phase in the first quarter, [0 .. 2^22]
+ */
+static inline int32_t quarterSine(uint32_t phase) {
+    const uint32_t i = phase >> kLerpBits;
+    if (i >= 256) {
+        return kQuarterSine[256];
+    }
+
+    const int32_t f = phase & ((1 << kLerpBits) - 1);
+    const int32_t s0 = kQuarterSine[i];
+    return s0 + (((kQuarterSine[i + 1] - s0) * f) >> kLerpBits);
+}
+
+static inline int32_t sineOfPhase(uint32_t phase) {
+    phase &= (1 << kPhaseBits) - 1;
+    const uint32_t quadrant = phase >> kQuarterBits;
+    const uint32_t p = phase & ((1 << kQuarterBits) - 1);
+    switch (quadrant) {
+        case 0:
+            return quarterSine(p);
+        case 1:
+            return quarterSine((1 << kQuarterBits) - p);
+        case 2:
+            return -quarterSine(p);
+        default:
+            return -quarterSine((1 << kQuarterBits) - p);
+    }
+}
+
+Fixed Fixed::sin(Fixed rad) {
+    return fromRaw(sineOfPhase(phaseOf(rad)));
+}
+
+Fixed Fixed::cos(Fixed rad) {
+    return fromRaw(sineOfPhase(phaseOf(rad) + (1 << kQuarterBits)));
+}
+
+/**
+ * Hypotenuse with 64 bits integer square root, it won't overflow for
+ * any two Q16.16 numbers
+ */
+Fixed Fixed::hypot(Fixed x, Fixed y) {
+    const uint64_t sum = (uint64_t)((int64_t)x.mRaw * x.mRaw) +
+                         (uint64_t)((int64_t)y.mRaw * y.mRaw);
+
+    // bitwise square root
+    uint64_t rest = sum;
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > rest) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (rest >= root + bit) {
+            rest -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return fromRaw(root > INT32_MAX ? INT32_MAX : (int32_t)root);
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_FIXEDPOINT_H
+#define ANDROID_PAGEFLIP_FIXEDPOINT_H
+
+#include <stdint.h>
+#include <math.h>
+
+namespace eschao {
+
+/**
+ * Q16.16 fixed point number
+ * <p>It is used by fold geometry on devices without fast FPU. All operations
+ * are integer only, trigonometric functions are looked up from a quarter
+ * sine table with linear interpolation, so results are bit-stable on every
+ * device</p>
+ * <p>The range is about [-32768, 32768) with precision 1/65536, it is
+ * enough for page coordinates in pixels</p>
+ */
+class Fixed {
+
+public:
+    static const int kFracBits = 16;
+    static const int32_t kOne = 1 << kFracBits;
+
+    Fixed() : mRaw(0) { }
+    Fixed(int value) : mRaw(value * kOne) { }
+    Fixed(float value) : mRaw((int32_t)floorf(value * kOne + 0.5f)) { }
+
+    static inline Fixed fromRaw(int32_t raw) {
+        Fixed f;
+        f.mRaw = raw;
+        return f;
+    }
+
+    // inline
+    inline int32_t raw() const {
+        return mRaw;
+    }
+
+    inline float toFloat() const {
+        return mRaw * (1.0f / kOne);
+    }
+
+    inline Fixed operator-() const {
+        return fromRaw(-mRaw);
+    }
+
+    inline Fixed operator+(Fixed b) const {
+        return fromRaw(mRaw + b.mRaw);
+    }
+
+    inline Fixed operator-(Fixed b) const {
+        return fromRaw(mRaw - b.mRaw);
+    }
+
+    inline Fixed operator*(Fixed b) const {
+        return fromRaw((int32_t)(((int64_t)mRaw * b.mRaw) >> kFracBits));
+    }
+
+    // dividing by zero is saturated instead of trapping
+    inline Fixed operator/(Fixed b) const {
+        if (b.mRaw == 0) {
+            return fromRaw(mRaw < 0 ? INT32_MIN : INT32_MAX);
+        }
+
+        return fromRaw((int32_t)(((int64_t)mRaw << kFracBits) / b.mRaw));
+    }
+
+    inline bool operator<(Fixed b) const {
+        return mRaw < b.mRaw;
+    }
+
+    static Fixed sin(Fixed rad);
+    static Fixed cos(Fixed rad);
+    static Fixed hypot(Fixed x, Fixed y);
+
+    // overloads are only found by argument dependent lookup, they won't
+    // hide sin/cos of float in this namespace
+    friend inline Fixed sin(Fixed rad) {
+        return Fixed::sin(rad);
+    }
+
+    friend inline Fixed cos(Fixed rad) {
+        return Fixed::cos(rad);
+    }
+
+    friend inline Fixed hypot(Fixed x, Fixed y) {
+        return Fixed::hypot(x, y);
+    }
+
+private:
+    int32_t mRaw;
+};
+
+inline float toFloat(Fixed value) {
+    return value.toFloat();
+}
+
+inline float toFloat(float value) {
+    return value;
+}
+
+}
+#endif //ANDROID_PAGEFLIP_FIXEDPOINT_H
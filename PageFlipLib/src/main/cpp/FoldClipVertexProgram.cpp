@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "FoldClipVertexProgram.h"
+#include "Constant.h"
+
+namespace eschao {
+
+// fold line is (a, b, c) of a * x + b * y + c = 0, the distance is linear
+// on flat page so it is computed per vertex
+static const auto g_vertex_shader =
+        "precision mediump float;\n"
+        FOLD_SHADOW_VERTEX_GLSL
+        "uniform mat4 u_MVPMatrix;\n"
+        "uniform vec3 u_foldLine;\n"
+        "uniform float u_vexZ;\n"
+        "attribute vec2 a_vexPosition;\n"
+        "attribute vec2 a_texCoord;\n"
+        "varying vec2 v_texCoord;\n"
+        "varying float v_foldDistance;\n"
+        "\n"
+        "void main() {\n"
+        "    gl_Position = u_MVPMatrix * vec4(a_vexPosition, u_vexZ, 1);\n"
+        "    v_texCoord = a_texCoord;\n"
+        "    v_foldDistance = dot(u_foldLine, vec3(a_vexPosition, 1));\n"
+        "    computeFoldShadow(toFoldAxis(a_vexPosition));\n"
+        "}";
+
+static const auto g_fragment_shader =
+        "precision mediump float;\n"
+        FOLD_SHADOW_FRAGMENT_GLSL
+        "uniform sampler2D u_texture;\n"
+        "uniform sampler2D u_secondTexture;\n"
+        "varying vec2 v_texCoord;\n"
+        "varying float v_foldDistance;\n"
+        "\n"
+        "void main() {\n"
+        "    vec4 color = v_foldDistance > 0.0 ?\n"
+        "                 texture2D(u_secondTexture, v_texCoord) :\n"
+        "                 texture2D(u_texture, v_texCoord);\n"
+        "    gl_FragColor = vec4(castFoldShadows(color.rgb), color.a);\n"
+        "}";
+
+static const char *VAR_SECOND_TEXTURE   = "u_secondTexture";
+static const char *VAR_FOLD_LINE        = "u_foldLine";
+static const char *VAR_VERTEX_Z         = "u_vexZ";
+
+FoldClipVertexProgram::FoldClipVertexProgram()
+        : mSecondTextureLoc(Constant::kGlInValidLocation),
+          mFoldLineLoc(Constant::kGlInValidLocation),
+          mVertexZLoc(Constant::kGlInValidLocation) {
+}
+
+FoldClipVertexProgram::~FoldClipVertexProgram() {
+    clean();
+}
+
+void FoldClipVertexProgram::clean() {
+    mVertexZLoc = Constant::kGlInValidLocation;
+    mFoldLineLoc = Constant::kGlInValidLocation;
+    mSecondTextureLoc = Constant::kGlInValidLocation;
+
+    VertexProgram::clean();
+}
+
+int FoldClipVertexProgram::init() {
+    clean();
+    return GLProgram::init(g_vertex_shader, g_fragment_shader);
+}
+
+void FoldClipVertexProgram::getVarsLocation() {
+    VertexProgram::getVarsLocation();
+
+    mSecondTextureLoc = glGetUniformLocation(mProgramRef, VAR_SECOND_TEXTURE);
+    mFoldLineLoc = glGetUniformLocation(mProgramRef, VAR_FOLD_LINE);
+    mVertexZLoc = glGetUniformLocation(mProgramRef, VAR_VERTEX_Z);
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_FOLDCLIPVERTEXPROGRAM_H
+#define ANDROID_PAGEFLIP_FOLDCLIPVERTEXPROGRAM_H
+
+#include "VertexProgram.h"
+
+namespace eschao {
+
+/**
+ * Program of flat page quad clipped by fold line
+ * <p>Signed distance to fold line is interpolated from vertexes, fragments
+ * on the positive side are revealed by fold and shaded with the second
+ * texture, the others with the first texture. Fold shadows can be cast on
+ * both of them like {@link VertexProgram}</p>
+ */
+class FoldClipVertexProgram : public VertexProgram {
+
+public:
+    FoldClipVertexProgram();
+    virtual ~FoldClipVertexProgram();
+
+    virtual void clean();
+    virtual int init();
+
+    // inline
+    inline GLint secondTextureLoc() {
+        return mSecondTextureLoc;
+    }
+
+    inline GLint foldLineLoc() {
+        return mFoldLineLoc;
+    }
+
+    inline GLint vertexZLoc() {
+        return mVertexZLoc;
+    }
+
+protected:
+    virtual void getVarsLocation();
+
+protected:
+    GLint mSecondTextureLoc;
+    GLint mFoldLineLoc;
+    GLint mVertexZLoc;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_FOLDCLIPVERTEXPROGRAM_H
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_FOLDCYLINDER_H
+#define ANDROID_PAGEFLIP_FOLDCYLINDER_H
+
+#include <math.h>
+#include "FixedPoint.h"
+#include "Vec4.h"
+
+namespace eschao {
+
+/**
+ * Cylinder kernel of fold page
+ * <p>It maps points of flat page onto the fold cylinder: rotate point with
+ * degree A, map it on cylinder and then rotate back with degree -A. The
+ * computation is done with type T, float or {@link Fixed}, input and output
+ * are always float as vertex buffers</p>
+ *
+ * @param T number type of computation
+ */
+template <typename T>
+class FoldCylinder {
+
+public:
+    FoldCylinder() { }
+
+    /**
+     * Set parameters of cylinder
+     *
+     * @param radius radius of cylinder
+     * @param xfx x of xFoldP1 point in rotated coordinate system
+     * @param sinA sin value of page curling angle
+     * @param cosA cos value of page curling angel
+     * @param oX x of originate point
+     * @param oY y of originate point
+     */
+    inline void set(float radius, float xfx, float sinA, float cosA,
+                    float oX, float oY) {
+        mRadius = T(radius);
+        mXFX = T(xfx);
+        mSinA = T(sinA);
+        mCosA = T(cosA);
+        mOX = T(oX);
+        mOY = T(oY);
+    }
+
+    /**
+     * Map point (x0, y0) which is relative to originate point
+     *
+     * @return sin value of point radian on cylinder
+     */
+    inline float map(float x0, float y0, float &cx, float &cy,
+                     float &cz) const {
+        const T tx(x0);
+        const T ty(y0);
+        const T x = tx * mCosA - ty * mSinA;
+        const T y = tx * mSinA + ty * mCosA;
+
+        const T rad = (x - mXFX) / mRadius;
+        const T sinR = sin(rad);
+        const T mx = mXFX + mRadius * sinR;
+        cz = toFloat(mRadius * (T(1) - cos(rad)));
+        cx = toFloat(mx * mCosA + y * mSinA + mOX);
+        cy = toFloat(y * mCosA - mx * mSinA + mOY);
+        return toFloat(sinR);
+    }
+
+    /**
+     * Map 4 points at a time, it is same as calling {@link #map} 4 times
+     *
+     * @param tx x of 4 points which are relative to originate point
+     * @param ty y of 4 points which are relative to originate point
+     * @param out 4 mapped vertexes of (x, y, z, sin value of radian)
+     */
+    inline void map4(const Vec4 &tx, const Vec4 &ty, float *out) const {
+        float x0[4], y0[4];
+        tx.store(x0);
+        ty.store(y0);
+        for (int i = 0; i < 4; ++i, out += 4) {
+            out[3] = map(x0[i], y0[i], out[0], out[1], out[2]);
+        }
+    }
+
+    /**
+     * Map x of rotated coordinate system on cylinder
+     */
+    inline float mapX(float x) const {
+        return toFloat(mXFX + mRadius * sin((T(x) - mXFX) / mRadius));
+    }
+
+private:
+    T mRadius;
+    T mXFX;
+    T mSinA;
+    T mCosA;
+    T mOX;
+    T mOY;
+};
+
+/**
+ * Map 4 points with {@link Vec4}, a lane is a point
+ * <p>Rotations and translations are done with vector operations, sin and
+ * cos are still computed lane by lane. Mapped lanes are transposed to 4
+ * vertexes as the layout of back of fold vertexes</p>
+ */
+template <>
+inline void FoldCylinder<float>::map4(const Vec4 &tx, const Vec4 &ty,
+                                      float *out) const {
+    const Vec4 sinA(mSinA);
+    const Vec4 cosA(mCosA);
+    const Vec4 xfx(mXFX);
+    const Vec4 radius(mRadius);
+    const Vec4 x = tx * cosA - ty * sinA;
+    const Vec4 y = tx * sinA + ty * cosA;
+
+    float rad[4];
+    ((x - xfx) / radius).store(rad);
+    Vec4 w(sin(rad[0]), sin(rad[1]), sin(rad[2]), sin(rad[3]));
+    const Vec4 cosR(cos(rad[0]), cos(rad[1]), cos(rad[2]), cos(rad[3]));
+    const Vec4 mx = xfx + radius * w;
+    Vec4 cz = radius * (Vec4(1) - cosR);
+    Vec4 cx = mx * cosA + y * sinA + Vec4(mOX);
+    Vec4 cy = y * cosA - mx * sinA + Vec4(mOY);
+    Vec4::transpose(cx, cy, cz, w);
+    cx.store(out);
+    cy.store(out + 4);
+    cz.store(out + 8);
+    w.store(out + 12);
+}
+
+// number type of fold geometry, selected at compile time
+#ifdef PAGEFLIP_FIXED_POINT_GEOMETRY
+typedef Fixed GeometryReal;
+#else
+typedef float GeometryReal;
+#endif
+
+}
+#endif //ANDROID_PAGEFLIP_FOLDCYLINDER_H
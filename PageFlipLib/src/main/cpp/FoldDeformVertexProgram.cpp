@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "FoldDeformVertexProgram.h"
+#include "Constant.h"
+
+namespace eschao {
+
+// u_isFlat: draw page without deforming, it is the second texture part
+// v_lightX: x of gradient light on back of fold, shadows of fold only come
+// from FOLD_SHADOW_*_GLSL
+static const auto g_vertex_shader =
+        FOLD_SHADOW_VERTEX_GLSL
+        "uniform mat4 u_MVPMatrix;\n"
+        "uniform mediump float u_isFlat;\n"
+        "uniform float u_texXOffset;\n"
+        "attribute vec2 a_vexPosition;\n"
+        "attribute vec2 a_texCoord;\n"
+        "varying vec2 v_texCoord;\n"
+        "varying vec2 v_backTexCoord;\n"
+        "varying float v_lightX;\n"
+        "\n"
+        "void main() {\n"
+        "    float xfx = u_cylinder.x;\n"
+        "    float r = max(u_cylinder.y, 0.0001);\n"
+        "    float xpi = xfx + 3.14159265 * r;\n"
+        "    vec2 p = toFoldAxis(a_vexPosition);\n"
+        "    float z = -1.0;\n"
+        "    float sinR = 0.0;\n"
+        "\n"
+        "    if (u_isFlat < 0.5) {\n"
+        "        z = 0.0;\n"
+        "        // flat part of back of fold ends at touch point\n"
+        "        if (p.x > xpi) {\n"
+        "            float t = (p.x - xpi) / max(-xpi, 0.0001);\n"
+        "            p.x = mix(xfx, u_cylinder.z, t);\n"
+        "            z = mix(2.0 * r, 1.0, t);\n"
+        "        }\n"
+        "        else if (p.x > xfx) {\n"
+        "            float rad = (p.x - xfx) / r;\n"
+        "            sinR = sin(rad);\n"
+        "            p.x = xfx + r * sinR;\n"
+        "            z = r * (1.0 - cos(rad));\n"
+        "        }\n"
+        "    }\n"
+        "\n"
+        "    computeFoldShadow(p);\n"
+        "    v_texCoord = a_texCoord;\n"
+        "    v_backTexCoord = vec2(abs(a_texCoord.x - u_texXOffset), a_texCoord.y);\n"
+        "    v_lightX = clamp(abs(sinR), 0.01, 1.0);\n"
+        "    gl_Position = u_MVPMatrix * vec4(fromFoldAxis(p), z, 1.0);\n"
+        "}";
+
+static const auto g_fragment_shader =
+        "precision mediump float;\n"
+        FOLD_SHADOW_FRAGMENT_GLSL
+        "uniform sampler2D u_texture;\n"
+        "uniform sampler2D u_backTexture;\n"
+        "uniform sampler2D u_gradientLight;\n"
+        "uniform vec4 u_maskColor;\n"
+        "uniform mediump float u_isFlat;\n"
+        "varying vec2 v_texCoord;\n"
+        "varying vec2 v_backTexCoord;\n"
+        "varying float v_lightX;\n"
+        "\n"
+        "void main() {\n"
+        "    if (u_isFlat > 0.5 || gl_FrontFacing) {\n"
+        "        vec3 color = texture2D(u_texture, v_texCoord).rgb;\n"
+        "        gl_FragColor = vec4(castFoldShadows(color), 1.0);\n"
+        "    }\n"
+        "    else {\n"
+        "        vec4 texture = texture2D(u_backTexture, v_backTexCoord);\n"
+        "        vec4 light = texture2D(u_gradientLight, vec2(v_lightX, 0));\n"
+        "        vec3 masked = mix(texture.rgb, u_maskColor.rgb, u_maskColor.a);\n"
+        "        gl_FragColor = vec4(masked * (1.0 - light.a) + light.rgb, 1.0);\n"
+        "    }\n"
+        "}";
+
+static const char *VAR_VERTEX_POS       = "a_vexPosition";
+static const char *VAR_TEXTURE_COORD    = "a_texCoord";
+static const char *VAR_IS_FLAT          = "u_isFlat";
+static const char *VAR_TEXTURE          = "u_texture";
+static const char *VAR_BACK_TEXTURE     = "u_backTexture";
+static const char *VAR_GRADIENT_LIGHT   = "u_gradientLight";
+static const char *VAR_MASK_COLOR       = "u_maskColor";
+static const char *VAR_TEXTURE_OFFSET   = "u_texXOffset";
+
+FoldDeformVertexProgram::FoldDeformVertexProgram()
+        : mVertexPosLoc(Constant::kGlInValidLocation),
+          mTexCoordLoc(Constant::kGlInValidLocation),
+          mIsFlatLoc(Constant::kGlInValidLocation),
+          mTextureLoc(Constant::kGlInValidLocation),
+          mBackTextureLoc(Constant::kGlInValidLocation),
+          mGradientLightLoc(Constant::kGlInValidLocation),
+          mMaskColorLoc(Constant::kGlInValidLocation),
+          mTexXOffsetLoc(Constant::kGlInValidLocation) {
+}
+
+FoldDeformVertexProgram::~FoldDeformVertexProgram() {
+    clean();
+}
+
+void FoldDeformVertexProgram::clean() {
+    mVertexPosLoc = Constant::kGlInValidLocation;
+    mTexCoordLoc = Constant::kGlInValidLocation;
+    mIsFlatLoc = Constant::kGlInValidLocation;
+    mTextureLoc = Constant::kGlInValidLocation;
+    mBackTextureLoc = Constant::kGlInValidLocation;
+    mGradientLightLoc = Constant::kGlInValidLocation;
+    mMaskColorLoc = Constant::kGlInValidLocation;
+    mTexXOffsetLoc = Constant::kGlInValidLocation;
+    mFoldShadowUniforms.clean();
+
+    GLProgram::clean();
+}
+
+int FoldDeformVertexProgram::init() {
+    clean();
+    return GLProgram::init(g_vertex_shader, g_fragment_shader);
+}
+
+void FoldDeformVertexProgram::getVarsLocation() {
+    mVertexPosLoc = glGetAttribLocation(mProgramRef, VAR_VERTEX_POS);
+    mTexCoordLoc = glGetAttribLocation(mProgramRef, VAR_TEXTURE_COORD);
+    mIsFlatLoc = glGetUniformLocation(mProgramRef, VAR_IS_FLAT);
+    mTextureLoc = glGetUniformLocation(mProgramRef, VAR_TEXTURE);
+    mBackTextureLoc = glGetUniformLocation(mProgramRef, VAR_BACK_TEXTURE);
+    mGradientLightLoc = glGetUniformLocation(mProgramRef, VAR_GRADIENT_LIGHT);
+    mMaskColorLoc = glGetUniformLocation(mProgramRef, VAR_MASK_COLOR);
+    mTexXOffsetLoc = glGetUniformLocation(mProgramRef, VAR_TEXTURE_OFFSET);
+    mFoldShadowUniforms.getLocations(mProgramRef);
+}
+
+}
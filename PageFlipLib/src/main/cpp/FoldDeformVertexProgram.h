@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_FOLDDEFORMVERTEXPROGRAM_H
+#define ANDROID_PAGEFLIP_FOLDDEFORMVERTEXPROGRAM_H
+
+#include "GLProgram.h"
+#include "FoldShadow.h"
+
+namespace eschao {
+
+/**
+ * Program of GPU fold deformation
+ * <p>Vertex shader maps the static page grid onto the fold cylinder with
+ * uniforms of fold, fragment shader shades front, back of fold and the
+ * second texture part. Shadows of fold are only evaluated analytically by
+ * {@link FoldShadow}, back of fold is lit by gradient light texture</p>
+ */
+class FoldDeformVertexProgram : public GLProgram {
+
+public:
+    FoldDeformVertexProgram();
+    virtual ~FoldDeformVertexProgram();
+
+    int init();
+    virtual void clean();
+
+    // inline
+    inline GLint vertexPosLoc() {
+        return mVertexPosLoc;
+    }
+
+    inline GLint texCoordLoc() {
+        return mTexCoordLoc;
+    }
+
+    inline GLint isFlatLoc() {
+        return mIsFlatLoc;
+    }
+
+    inline GLint textureLoc() {
+        return mTextureLoc;
+    }
+
+    inline GLint backTextureLoc() {
+        return mBackTextureLoc;
+    }
+
+    inline GLint gradientLightLoc() {
+        return mGradientLightLoc;
+    }
+
+    inline GLint maskColorLoc() {
+        return mMaskColorLoc;
+    }
+
+    inline GLint texXOffsetLoc() {
+        return mTexXOffsetLoc;
+    }
+
+    inline FoldShadowUniforms& foldShadowUniforms() {
+        return mFoldShadowUniforms;
+    }
+
+protected:
+    virtual void getVarsLocation();
+
+protected:
+    GLint mVertexPosLoc;
+    GLint mTexCoordLoc;
+    GLint mIsFlatLoc;
+    GLint mTextureLoc;
+    GLint mBackTextureLoc;
+    GLint mGradientLightLoc;
+    GLint mMaskColorLoc;
+    GLint mTexXOffsetLoc;
+    FoldShadowUniforms mFoldShadowUniforms;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_FOLDDEFORMVERTEXPROGRAM_H
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <math.h>
+#include <vector>
+#include "Page.h"
+#include "Error.h"
+#include "Utility.h"
+#include "Constant.h"
+#include "FoldDeformVertexes.h"
+#include "FoldShadow.h"
+#include "FoldDeformVertexProgram.h"
+
+namespace eschao {
+
+static const auto TAG = "FoldDeformVertexes";
+
+FoldDeformVertexes::FoldDeformVertexes()
+        : mVertexBuffer(Constant::kGlInvalidRef),
+          mIndexBuffer(Constant::kGlInvalidRef),
+          mIndexCount(0),
+          mLeft(0),
+          mRight(0),
+          mTop(0),
+          mBottom(0),
+          mPixelsOfMesh(0) {
+}
+
+FoldDeformVertexes::~FoldDeformVertexes() {
+    release();
+}
+
+/**
+ * Delete vertex buffers, it must be called in GL thread
+ */
+void FoldDeformVertexes::release() {
+    if (mVertexBuffer != Constant::kGlInvalidRef) {
+        glDeleteBuffers(1, &mVertexBuffer);
+    }
+
+    if (mIndexBuffer != Constant::kGlInvalidRef) {
+        glDeleteBuffers(1, &mIndexBuffer);
+    }
+
+    invalidate();
+}
+
+/**
+ * Forget vertex buffers without deleting, it is used when GL context is
+ * re-created and old buffers are gone with old context
+ */
+void FoldDeformVertexes::invalidate() {
+    mVertexBuffer = Constant::kGlInvalidRef;
+    mIndexBuffer = Constant::kGlInvalidRef;
+    mIndexCount = 0;
+    mPixelsOfMesh = 0;
+}
+
+/**
+ * Build page grid and upload it to vertex buffers if page bounds or mesh
+ * size is changed
+ * <p>Grid cell is a square with mesh size, it is enlarged if there are too
+ * many vertexes to be indexed by unsigned short</p>
+ *
+ * @param page page of grid
+ * @param pixelsOfMesh mesh size in pixels
+ * @return Error::OK if grid is ready
+ */
+int FoldDeformVertexes::build(Page &page, int pixelsOfMesh) {
+    if (mIndexCount > 0 &&
+        mPixelsOfMesh == pixelsOfMesh &&
+        mLeft == page.left() && mRight == page.right() &&
+        mTop == page.top() && mBottom == page.bottom()) {
+        return Error::OK;
+    }
+
+    const float width = page.width();
+    const float height = page.height();
+    if (width < 1 || height < 1 || pixelsOfMesh < 1) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    int cols = (int)ceilf(width / pixelsOfMesh);
+    int rows = (int)ceilf(height / pixelsOfMesh);
+    for (int pixels = pixelsOfMesh;
+         (cols + 1) * (rows + 1) > kMaxFoldDeformVexCount; ++pixels) {
+        cols = (int)ceilf(width / pixels);
+        rows = (int)ceilf(height / pixels);
+    }
+
+    // vertexes from bottom to top, every row is from left to right
+    std::vector<float> vertexes((cols + 1) * (rows + 1) * kFoldDeformVexSize);
+    float *v = &vertexes[0];
+    for (int j = 0; j <= rows; ++j) {
+        const float y = page.bottom() + height * j / rows;
+        for (int i = 0; i <= cols; ++i, v += kFoldDeformVexSize) {
+            const float x = page.left() + width * i / cols;
+            v[0] = x;
+            v[1] = y;
+            v[2] = page.textureX(x);
+            v[3] = page.textureY(y);
+        }
+    }
+
+    // two counter-clockwise triangles of every cell, facing of triangle
+    // tells front and back of fold in fragment shader
+    std::vector<GLushort> indexes(cols * rows * 6);
+    GLushort *n = &indexes[0];
+    for (int j = 0; j < rows; ++j) {
+        for (int i = 0; i < cols; ++i, n += 6) {
+            const GLushort k = (GLushort)(j * (cols + 1) + i);
+            const GLushort up = (GLushort)(k + cols + 1);
+            n[0] = k;
+            n[1] = (GLushort)(k + 1);
+            n[2] = (GLushort)(up + 1);
+            n[3] = k;
+            n[4] = (GLushort)(up + 1);
+            n[5] = up;
+        }
+    }
+
+    if (mVertexBuffer == Constant::kGlInvalidRef) {
+        glGenBuffers(1, &mVertexBuffer);
+    }
+
+    if (mIndexBuffer == Constant::kGlInvalidRef) {
+        glGenBuffers(1, &mIndexBuffer);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertexes.size(),
+                 &vertexes[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * indexes.size(),
+                 &indexes[0], GL_STATIC_DRAW);
+
+    mIndexCount = (int)indexes.size();
+    mPixelsOfMesh = pixelsOfMesh;
+    mLeft = page.left();
+    mRight = page.right();
+    mTop = page.top();
+    mBottom = page.bottom();
+    LOGD(TAG, "Build page grid: %d x %d", cols, rows);
+    return Error::OK;
+}
+
+/**
+ * Draw deformed page and the second texture part under it
+ * <p>Program should be in use. Vertex buffers are unbound after drawing
+ * since other programs draw with client side arrays</p>
+ */
+void FoldDeformVertexes::draw(FoldDeformVertexProgram &program,
+                              Page &page,
+                              int pixelsOfMesh,
+                              const FoldShadow &foldShadow,
+                              bool hasSecondPage,
+                              float maskAlpha,
+                              GLuint gradientLightId) {
+    if (build(page, pixelsOfMesh) != Error::OK) {
+        return;
+    }
+
+    program.uploadMVPMatrix();
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, page.textures.backTextureId());
+    glUniform1i(program.backTextureLoc(), 1);
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, gradientLightId);
+    glUniform1i(program.gradientLightLoc(), 2);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, page.textures.firstTextureId());
+    glUniform1i(program.textureLoc(), 0);
+
+    program.foldShadowUniforms().upload(&foldShadow);
+    glUniform1f(program.texXOffsetLoc(), hasSecondPage ? 1.0f : 0);
+    const float *maskColor = page.textures.getMaskColorOfFirstTexture();
+    glUniform4f(program.maskColorLoc(),
+                maskColor[0], maskColor[1], maskColor[2],
+                hasSecondPage ? 0 : maskAlpha);
+
+    const GLsizei stride = sizeof(float) * kFoldDeformVexSize;
+    glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+    glVertexAttribPointer(program.vertexPosLoc(), 2, GL_FLOAT, GL_FALSE,
+                          stride, (const GLvoid *)0);
+    glEnableVertexAttribArray(program.vertexPosLoc());
+    glVertexAttribPointer(program.texCoordLoc(), 2, GL_FLOAT, GL_FALSE,
+                          stride, (const GLvoid *)(sizeof(float) * 2));
+    glEnableVertexAttribArray(program.texCoordLoc());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+
+    // 1. deformed page: front with the first texture and back of fold
+    glUniform1f(program.isFlatLoc(), 0);
+    glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_SHORT, 0);
+
+    // 2. flat page with the second texture, it is behind deformed page
+    glBindTexture(GL_TEXTURE_2D, page.textures.secondTextureId());
+    glUniform1f(program.isFlatLoc(), 1);
+    glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_SHORT, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_FOLDDEFORMVERTEXES_H
+#define ANDROID_PAGEFLIP_FOLDDEFORMVERTEXES_H
+
+#include <GLES2/gl2.h>
+
+namespace eschao {
+
+class Page;
+class FoldShadow;
+class FoldDeformVertexProgram;
+
+// float size of every grid vertex: x, y, tx, ty
+static const int kFoldDeformVexSize = 4;
+// grid is indexed by unsigned short
+static const int kMaxFoldDeformVexCount = 65535;
+
+/**
+ * Static page grid for GPU fold deformation
+ * <p>The grid covers the whole page and is uploaded to vertex buffer once,
+ * it is only rebuilt when page bounds or mesh size is changed. Every frame
+ * only uniforms of fold are set by {@link FoldShadow} and the vertex shader
+ * maps grid onto the fold cylinder, see {@link FoldDeformVertexProgram}</p>
+ * <p>Grid is drawn twice: deformed with the first texture and back of fold,
+ * then flat with the second texture under it</p>
+ */
+class FoldDeformVertexes {
+
+public:
+    FoldDeformVertexes();
+    ~FoldDeformVertexes();
+
+    void release();
+    void invalidate();
+    void draw(FoldDeformVertexProgram &program, Page &page, int pixelsOfMesh,
+              const FoldShadow &foldShadow, bool hasSecondPage,
+              float maskAlpha, GLuint gradientLightId);
+
+    // inline
+    inline int indexCount() {
+        return mIndexCount;
+    }
+
+private:
+    int build(Page &page, int pixelsOfMesh);
+
+private:
+    GLuint mVertexBuffer;
+    GLuint mIndexBuffer;
+    int mIndexCount;
+
+    // page bounds and mesh size of current grid
+    float mLeft;
+    float mRight;
+    float mTop;
+    float mBottom;
+    int mPixelsOfMesh;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_FOLDDEFORMVERTEXES_H
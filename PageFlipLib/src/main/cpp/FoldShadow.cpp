@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <math.h>
+#include <string.h>
+#include "FoldShadow.h"
+#include "Constant.h"
+
+namespace eschao {
+
+static inline float castShadow(float color, const float *shadow, float t) {
+    if (t < 0 || t >= 1) {
+        return color;
+    }
+
+    const float alpha = shadow[1] + (shadow[3] - shadow[1]) * t;
+    const float gray = shadow[0] + (shadow[2] - shadow[0]) * t;
+    return color + (gray - color) * alpha;
+}
+
+FoldShadow::FoldShadow() {
+    memset(mOrigin, 0, sizeof(mOrigin));
+    memset(mPageDir, 0, sizeof(mPageDir));
+    memset(mRotation, 0, sizeof(mRotation));
+    memset(mCylinder, 0, sizeof(mCylinder));
+    memset(mEdgeShadow, 0, sizeof(mEdgeShadow));
+    memset(mBaseShadow, 0, sizeof(mBaseShadow));
+    memset(mShadowWidth, 0, sizeof(mShadowWidth));
+}
+
+/**
+ * Set fold of current frame
+ *
+ * @param originP originate point of page
+ * @param diagonalP diagonal point of page
+ * @param sinA sin value of page curling angle
+ * @param cosA cos value of page curling angle
+ * @param xFoldX1 x of xFoldP1 point in coordinate system of fold
+ * @param radius radius of fold cylinder
+ * @param touchX x of touch point in coordinate system of fold
+ */
+void FoldShadow::setFold(const GLPoint &originP, const GLPoint &diagonalP,
+                         float sinA, float cosA, float xFoldX1, float radius,
+                         float touchX) {
+    mOrigin[0] = originP.x;
+    mOrigin[1] = originP.y;
+    mPageDir[0] = diagonalP.x < originP.x ? -1 : 1;
+    mPageDir[1] = diagonalP.y < originP.y ? -1 : 1;
+    mRotation[0] = sinA;
+    mRotation[1] = cosA;
+    mCylinder[0] = xFoldX1;
+    mCylinder[1] = radius;
+    mCylinder[2] = touchX;
+}
+
+/**
+ * Set colors and widths of edge and base shadow
+ */
+void FoldShadow::setShadows(const ShadowColor &edgeColor, float edgeWidth,
+                            const ShadowColor &baseColor, float baseWidth) {
+    mEdgeShadow[0] = edgeColor.startColor;
+    mEdgeShadow[1] = edgeColor.startAlpha;
+    mEdgeShadow[2] = edgeColor.endColor;
+    mEdgeShadow[3] = edgeColor.endAlpha;
+    mBaseShadow[0] = baseColor.startColor;
+    mBaseShadow[1] = baseColor.startAlpha;
+    mBaseShadow[2] = baseColor.endColor;
+    mBaseShadow[3] = baseColor.endAlpha;
+
+    // avoid dividing by zero in shading
+    mShadowWidth[0] = edgeWidth > 0.01f ? edgeWidth : 0.01f;
+    mShadowWidth[1] = baseWidth > 0.01f ? baseWidth : 0.01f;
+}
+
+/**
+ * Compute varyings of point on screen, same with computeFoldShadow() of
+ * vertex stage GLSL
+ *
+ * @param x x of point
+ * @param y y of point
+ * @param varyings output of {@link kFoldShadowVaryingCount} floats
+ */
+void FoldShadow::computeVaryings(float x, float y, float *varyings) const {
+    const float sinA = mRotation[0];
+    const float cosA = mRotation[1];
+    const float px = (x - mOrigin[0]) * cosA - (y - mOrigin[1]) * sinA;
+    const float py = (x - mOrigin[0]) * sinA + (y - mOrigin[1]) * cosA;
+
+    const float xfx = mCylinder[0];
+    const float xpi = xfx + (float)M_PI * mCylinder[1];
+    const float toTouch = mCylinder[2] - xfx;
+    const float k = (px - xfx) / (toTouch < -0.0001f ? toTouch : -0.0001f);
+    const float qx = xpi - k * xpi;
+
+    varyings[0] = -(qx * cosA + py * sinA) * mPageDir[0];
+    varyings[1] = -(py * cosA - qx * sinA) * mPageDir[1];
+    varyings[2] = px - xfx;
+    varyings[3] = px - xfx - mCylinder[1];
+}
+
+/**
+ * Cast shadows on RGB color with interpolated varyings, same with
+ * castFoldShadows() of fragment stage GLSL
+ */
+void FoldShadow::cast(const float *varyings, float *color) const {
+    if (varyings[2] <= 0) {
+        const float ex = varyings[0];
+        const float ey = varyings[1];
+        const float d = (ex > 0 && ey > 0) ? sqrtf(ex * ex + ey * ey) :
+                        (ex > ey ? ex : ey);
+        for (int i = 0; i < 3; ++i) {
+            color[i] = castShadow(color[i], mEdgeShadow, d / mShadowWidth[0]);
+        }
+    }
+
+    const float t = varyings[3] / mShadowWidth[1];
+    for (int i = 0; i < 3; ++i) {
+        color[i] = castShadow(color[i], mBaseShadow, t);
+    }
+}
+
+FoldShadowUniforms::FoldShadowUniforms() {
+    clean();
+}
+
+void FoldShadowUniforms::clean() {
+    mOriginLoc = Constant::kGlInValidLocation;
+    mRotationLoc = Constant::kGlInValidLocation;
+    mCylinderLoc = Constant::kGlInValidLocation;
+    mPageDirLoc = Constant::kGlInValidLocation;
+    mEdgeShadowLoc = Constant::kGlInValidLocation;
+    mBaseShadowLoc = Constant::kGlInValidLocation;
+    mShadowWidthLoc = Constant::kGlInValidLocation;
+    mHasFoldShadowLoc = Constant::kGlInValidLocation;
+}
+
+void FoldShadowUniforms::getLocations(GLuint program) {
+    mOriginLoc = glGetUniformLocation(program, "u_origin");
+    mRotationLoc = glGetUniformLocation(program, "u_rotation");
+    mCylinderLoc = glGetUniformLocation(program, "u_cylinder");
+    mPageDirLoc = glGetUniformLocation(program, "u_pageDir");
+    mEdgeShadowLoc = glGetUniformLocation(program, "u_edgeShadow");
+    mBaseShadowLoc = glGetUniformLocation(program, "u_baseShadow");
+    mShadowWidthLoc = glGetUniformLocation(program, "u_shadowWidth");
+    mHasFoldShadowLoc = glGetUniformLocation(program, "u_hasFoldShadow");
+}
+
+/**
+ * Upload fold shadow to program in use, NULL disables shadows
+ */
+void FoldShadowUniforms::upload(const FoldShadow *shadow) {
+    if (shadow == NULL) {
+        glUniform1f(mHasFoldShadowLoc, 0);
+        return;
+    }
+
+    glUniform1f(mHasFoldShadowLoc, 1.0f);
+    glUniform2fv(mOriginLoc, 1, shadow->mOrigin);
+    glUniform2fv(mRotationLoc, 1, shadow->mRotation);
+    glUniform3fv(mCylinderLoc, 1, shadow->mCylinder);
+    glUniform2fv(mPageDirLoc, 1, shadow->mPageDir);
+    glUniform4fv(mEdgeShadowLoc, 1, shadow->mEdgeShadow);
+    glUniform4fv(mBaseShadowLoc, 1, shadow->mBaseShadow);
+    glUniform2fv(mShadowWidthLoc, 1, shadow->mShadowWidth);
+}
+
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_FOLDSHADOW_H
+#define ANDROID_PAGEFLIP_FOLDSHADOW_H
+
+#include <GLES2/gl2.h>
+#include "GLPoint.h"
+#include "ShadowColor.h"
+
+namespace eschao {
+
+// float size of varyings: x, y distances outside edges of back of fold,
+// distance to xFoldP1 and distance to crest of cylinder
+static const int kFoldShadowVaryingCount = 4;
+
+/**
+ * GLSL of vertex stage, it declares uniforms of fold and functions:
+ * <ul>
+ *     <li>toFoldAxis: rotate point to coordinate system of fold</li>
+ *     <li>fromFoldAxis: rotate point back</li>
+ *     <li>computeFoldShadow: set varyings of point on screen which is given
+ *     in coordinate system of fold</li>
+ * </ul>
+ * Uniforms: (sinA, cosA) of curling angle; x of xFoldP1, radius and x of
+ * touch point in coordinate system of fold; signs of direction from
+ * originP to diagonalP
+ */
+#define FOLD_SHADOW_VERTEX_GLSL \
+        "precision highp float;\n" \
+        "uniform vec2 u_origin;\n" \
+        "uniform vec2 u_rotation;\n" \
+        "uniform vec3 u_cylinder;\n" \
+        "uniform vec2 u_pageDir;\n" \
+        "varying vec4 v_foldShadow;\n" \
+        "\n" \
+        "vec2 toFoldAxis(vec2 p) {\n" \
+        "    p -= u_origin;\n" \
+        "    return vec2(p.x * u_rotation.y - p.y * u_rotation.x,\n" \
+        "                p.x * u_rotation.x + p.y * u_rotation.y);\n" \
+        "}\n" \
+        "\n" \
+        "vec2 fromFoldAxis(vec2 p) {\n" \
+        "    return vec2(p.x * u_rotation.y + p.y * u_rotation.x,\n" \
+        "                p.y * u_rotation.y - p.x * u_rotation.x) + u_origin;\n" \
+        "}\n" \
+        "\n" \
+        "void computeFoldShadow(vec2 p) {\n" \
+        "    float xfx = u_cylinder.x;\n" \
+        "    float xpi = xfx + 3.14159265 * u_cylinder.y;\n" \
+        "    float k = (p.x - xfx) / min(u_cylinder.z - xfx, -0.0001);\n" \
+        "    vec2 q = fromFoldAxis(vec2(xpi - k * xpi, p.y)) - u_origin;\n" \
+        "    v_foldShadow = vec4(-q * u_pageDir, p.x - xfx,\n" \
+        "                        p.x - xfx - u_cylinder.y);\n" \
+        "}\n"
+
+/**
+ * GLSL of fragment stage, castFoldShadows(color) returns color with edge
+ * and base shadow. Uniforms: start color, start alpha, end color and end
+ * alpha of edge and base shadow; widths of them; is shadow enabled
+ */
+#define FOLD_SHADOW_FRAGMENT_GLSL \
+        "uniform vec4 u_edgeShadow;\n" \
+        "uniform vec4 u_baseShadow;\n" \
+        "uniform vec2 u_shadowWidth;\n" \
+        "uniform float u_hasFoldShadow;\n" \
+        "#ifdef GL_FRAGMENT_PRECISION_HIGH\n" \
+        "varying highp vec4 v_foldShadow;\n" \
+        "#else\n" \
+        "varying vec4 v_foldShadow;\n" \
+        "#endif\n" \
+        "\n" \
+        "vec3 castShadow(vec3 color, vec4 shadow, float t) {\n" \
+        "    if (t < 0.0 || t >= 1.0) {\n" \
+        "        return color;\n" \
+        "    }\n" \
+        "    float alpha = mix(shadow.y, shadow.w, t);\n" \
+        "    return mix(color, vec3(mix(shadow.x, shadow.z, t)), alpha);\n" \
+        "}\n" \
+        "\n" \
+        "vec3 castFoldShadows(vec3 color) {\n" \
+        "    if (u_hasFoldShadow < 0.5) {\n" \
+        "        return color;\n" \
+        "    }\n" \
+        "    if (v_foldShadow.z <= 0.0) {\n" \
+        "        vec2 e = v_foldShadow.xy;\n" \
+        "        float d = (e.x > 0.0 && e.y > 0.0) ? length(e) : max(e.x, e.y);\n" \
+        "        color = castShadow(color, u_edgeShadow, d / u_shadowWidth.x);\n" \
+        "    }\n" \
+        "    return castShadow(color, u_baseShadow,\n" \
+        "                      v_foldShadow.w / u_shadowWidth.y);\n" \
+        "}\n"
+
+/**
+ * Analytic shadows of fold
+ * <p>Instead of shadow meshes, edge and base shadow are evaluated in page
+ * shading from distances in coordinate system of fold, see
+ * {@link FoldCylinder}:</p>
+ * <ul>
+ *     <li>base shadow starts from the crest of cylinder</li>
+ *     <li>edge shadow starts from edges of back of fold, the point is
+ *     mapped back to the page point whose back of fold would cover it,
+ *     its distances outside the page edges through originP are distances
+ *     to edges of back of fold</li>
+ * </ul>
+ * <p>Both distances are linear on flat page, so they are computed per
+ * vertex and interpolated. GLSL is given by macros above, the same
+ * computation in CPU is for software backend</p>
+ */
+class FoldShadow {
+
+public:
+    FoldShadow();
+
+    void setFold(const GLPoint &originP, const GLPoint &diagonalP,
+                 float sinA, float cosA, float xFoldX1, float radius,
+                 float touchX);
+    void setShadows(const ShadowColor &edgeColor, float edgeWidth,
+                    const ShadowColor &baseColor, float baseWidth);
+    void computeVaryings(float x, float y, float *varyings) const;
+    void cast(const float *varyings, float *color) const;
+
+private:
+    float mOrigin[2];
+    float mPageDir[2];
+    float mRotation[2];
+    float mCylinder[3];
+    float mEdgeShadow[4];
+    float mBaseShadow[4];
+    float mShadowWidth[2];
+
+    friend class FoldShadowUniforms;
+};
+
+/**
+ * Uniform locations of {@link FoldShadow} in a GL program whose shaders
+ * include GLSL macros of fold shadow
+ */
+class FoldShadowUniforms {
+
+public:
+    FoldShadowUniforms();
+
+    void clean();
+    void getLocations(GLuint program);
+    void upload(const FoldShadow *shadow);
+
+private:
+    GLint mOriginLoc;
+    GLint mRotationLoc;
+    GLint mCylinderLoc;
+    GLint mPageDirLoc;
+    GLint mEdgeShadowLoc;
+    GLint mBaseShadowLoc;
+    GLint mShadowWidthLoc;
+    GLint mHasFoldShadowLoc;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_FOLDSHADOW_H
@@ -0,0 +1,628 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <string.h>
+#include <EGL/egl.h>
+#include "GLES3RenderBackend.h"
+#include "Error.h"
+#include "Utility.h"
+#include "Constant.h"
+
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER               0x8A11
+#endif
+
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX                0xFFFFFFFFu
+#endif
+
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT                0x0002
+#define GL_MAP_INVALIDATE_RANGE_BIT     0x0004
+#define GL_MAP_UNSYNCHRONIZED_BIT       0x0020
+#endif
+
+#ifndef GL_RGBA8
+#define GL_RGBA8                        0x8058
+#endif
+
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH            0x0CF2
+#endif
+
+namespace eschao {
+
+static const auto TAG = "GLES3RenderBackend";
+
+// all programs share the MVP matrix through this uniform block binding
+static const GLuint kFrameBlockBinding = 0;
+static const char *VAR_FRAME_BLOCK = "Frame";
+
+// fixed attribute locations
+static const GLuint kVertexPosLoc = 0;
+static const GLuint kTexCoordLoc = 1;
+static const GLuint kInstanceLoc = 1;
+static const GLuint kGradientLoc = 1;
+
+// initial size of streamed vertex buffer, it is enough for several frames
+// with the default mesh density
+static const GLsizeiptr kStreamBufferSize = 256 * 1024;
+
+static const auto g_page_vertex_shader =
+        "#version 300 es\n"
+        "layout(std140) uniform Frame {\n"
+        "    mat4 u_MVPMatrix;\n"
+        "};\n"
+        "layout(location = 0) in vec4 a_vexPosition;\n"
+        "layout(location = 1) in vec2 a_texCoord;\n"
+        "out vec2 v_texCoord;\n"
+        "\n"
+        "void main() {\n"
+        "    gl_Position = u_MVPMatrix * a_vexPosition;\n"
+        "    v_texCoord = a_texCoord;\n"
+        "}";
+
+static const auto g_page_fragment_shader =
+        "#version 300 es\n"
+        "precision mediump float;\n"
+        "uniform sampler2D u_texture;\n"
+        "in vec2 v_texCoord;\n"
+        "out vec4 fragColor;\n"
+        "\n"
+        "void main() {\n"
+        "    fragColor = texture(u_texture, v_texCoord);\n"
+        "}";
+
+static const auto g_shadow_vertex_shader =
+        "#version 300 es\n"
+        "layout(std140) uniform Frame {\n"
+        "    mat4 u_MVPMatrix;\n"
+        "};\n"
+        "uniform float u_vexZ;\n"
+        "uniform vec2 u_startColor;\n"
+        "uniform vec2 u_endColor;\n"
+        "uniform bool u_hasGradient;\n"
+        "layout(location = 0) in vec2 a_vexPosition;\n"
+        "layout(location = 1) in float a_gradient;\n"
+        "out vec4 v_texColor;\n"
+        "\n"
+        "void main() {\n"
+        "    // strip of shadow start and end pairs has no gradients\n"
+        "    float t = u_hasGradient ? a_gradient : float(gl_VertexID & 1);\n"
+        "    vec2 color = mix(u_startColor, u_endColor, t);\n"
+        "    v_texColor = vec4(color.xxx, color.y);\n"
+        "    gl_Position = u_MVPMatrix * vec4(a_vexPosition, u_vexZ, 1.0);\n"
+        "}";
+
+static const auto g_shadow_fragment_shader =
+        "#version 300 es\n"
+        "precision mediump float;\n"
+        "in vec4 v_texColor;\n"
+        "out vec4 fragColor;\n"
+        "\n"
+        "void main() {\n"
+        "    fragColor = v_texColor;\n"
+        "}";
+
+static const auto g_back_of_fold_vertex_shader =
+        "#version 300 es\n"
+        "layout(std140) uniform Frame {\n"
+        "    mat4 u_MVPMatrix;\n"
+        "};\n"
+        "uniform float u_texXOffset;\n"
+        "layout(location = 0) in vec4 a_vexPosition;\n"
+        "layout(location = 1) in vec2 a_texCoord;\n"
+        "out vec2 v_texCoord;\n"
+        "out float v_shadowX;\n"
+        "\n"
+        "void main() {\n"
+        "    v_texCoord = vec2(abs(a_texCoord.x - u_texXOffset), a_texCoord.y);\n"
+        "    v_shadowX = clamp(abs(a_vexPosition.w), 0.01, 1.0);\n"
+        "    gl_Position = u_MVPMatrix * vec4(a_vexPosition.xyz, 1.0);\n"
+        "}";
+
+static const auto g_back_of_fold_fragment_shader =
+        "#version 300 es\n"
+        "precision mediump float;\n"
+        "uniform sampler2D u_texture;\n"
+        "uniform sampler2D u_shadow;\n"
+        "uniform vec4 u_maskColor;\n"
+        "in vec2 v_texCoord;\n"
+        "in float v_shadowX;\n"
+        "out vec4 fragColor;\n"
+        "\n"
+        "void main() {\n"
+        "    vec4 color = texture(u_texture, v_texCoord);\n"
+        "    vec4 shadow = texture(u_shadow, vec2(v_shadowX, 0.0));\n"
+        "    vec3 masked = mix(color.rgb, u_maskColor.rgb, u_maskColor.a);\n"
+        "    fragColor = vec4(masked * (1.0 - shadow.a) + shadow.rgb, 1.0);\n"
+        "}";
+
+static const auto g_instanced_quad_vertex_shader =
+        "#version 300 es\n"
+        "layout(std140) uniform Frame {\n"
+        "    mat4 u_MVPMatrix;\n"
+        "};\n"
+        "uniform float u_vexZ;\n"
+        "layout(location = 0) in vec2 a_vexPosition;\n"
+        "layout(location = 1) in vec4 a_instance;\n"
+        "out vec4 v_texColor;\n"
+        "\n"
+        "void main() {\n"
+        "    v_texColor = vec4(a_instance.zzz, a_instance.w);\n"
+        "    vec2 xy = a_vexPosition + a_instance.xy;\n"
+        "    gl_Position = u_MVPMatrix * vec4(xy, u_vexZ, 1.0);\n"
+        "}";
+
+GLES3RenderBackend::GLES3RenderBackend()
+        : mIsLoaded(false),
+          mGenVertexArrays(NULL),
+          mBindVertexArray(NULL),
+          mDeleteVertexArrays(NULL),
+          mMapBufferRange(NULL),
+          mUnmapBuffer(NULL),
+          mGetUniformBlockIndex(NULL),
+          mUniformBlockBinding(NULL),
+          mBindBufferBase(NULL),
+          mTexStorage2D(NULL),
+          mVertexAttribDivisor(NULL),
+          mDrawArraysInstanced(NULL),
+          mCurrentProgram(PROGRAM_COUNT),
+          mShadowVertexZLoc(Constant::kGlInValidLocation),
+          mShadowStartColorLoc(Constant::kGlInValidLocation),
+          mShadowEndColorLoc(Constant::kGlInValidLocation),
+          mShadowHasGradientLoc(Constant::kGlInValidLocation),
+          mQuadVertexZLoc(Constant::kGlInValidLocation),
+          mMaskColorLoc(Constant::kGlInValidLocation),
+          mTexXOffsetLoc(Constant::kGlInValidLocation),
+          mFrameBuffer(Constant::kGlInvalidRef),
+          mStreamBuffer(Constant::kGlInvalidRef),
+          mStreamSize(0),
+          mStreamOffset(0),
+          mIsDepthTestOn(false) {
+    memset(mVertexArrays, 0, sizeof(mVertexArrays));
+}
+
+GLES3RenderBackend::~GLES3RenderBackend() {
+    clean();
+}
+
+/**
+ * Load GLES3 functions, it should be called in GL thread
+ */
+bool GLES3RenderBackend::loadFunctions() {
+    if (!mIsLoaded) {
+        mIsLoaded = true;
+        mGenVertexArrays = (GenVertexArraysFunc)
+                eglGetProcAddress("glGenVertexArrays");
+        mBindVertexArray = (BindVertexArrayFunc)
+                eglGetProcAddress("glBindVertexArray");
+        mDeleteVertexArrays = (DeleteVertexArraysFunc)
+                eglGetProcAddress("glDeleteVertexArrays");
+        mMapBufferRange = (MapBufferRangeFunc)
+                eglGetProcAddress("glMapBufferRange");
+        mUnmapBuffer = (UnmapBufferFunc)
+                eglGetProcAddress("glUnmapBuffer");
+        mGetUniformBlockIndex = (GetUniformBlockIndexFunc)
+                eglGetProcAddress("glGetUniformBlockIndex");
+        mUniformBlockBinding = (UniformBlockBindingFunc)
+                eglGetProcAddress("glUniformBlockBinding");
+        mBindBufferBase = (BindBufferBaseFunc)
+                eglGetProcAddress("glBindBufferBase");
+        mTexStorage2D = (TexStorage2DFunc)
+                eglGetProcAddress("glTexStorage2D");
+        mVertexAttribDivisor = (VertexAttribDivisorFunc)
+                eglGetProcAddress("glVertexAttribDivisor");
+        mDrawArraysInstanced = (DrawArraysInstancedFunc)
+                eglGetProcAddress("glDrawArraysInstanced");
+    }
+
+    return mGenVertexArrays && mBindVertexArray && mDeleteVertexArrays &&
+           mMapBufferRange && mUnmapBuffer && mGetUniformBlockIndex &&
+           mUniformBlockBinding && mBindBufferBase && mTexStorage2D &&
+           mVertexAttribDivisor && mDrawArraysInstanced;
+}
+
+/**
+ * Release GL objects
+ */
+void GLES3RenderBackend::clean() {
+    for (int i = 0; i < PROGRAM_COUNT; ++i) {
+        mPrograms[i].clean();
+    }
+
+    if (mIsLoaded && mDeleteVertexArrays && mVertexArrays[0]) {
+        mDeleteVertexArrays(PROGRAM_COUNT, mVertexArrays);
+    }
+    memset(mVertexArrays, 0, sizeof(mVertexArrays));
+
+    if (mFrameBuffer != Constant::kGlInvalidRef) {
+        glDeleteBuffers(1, &mFrameBuffer);
+        mFrameBuffer = Constant::kGlInvalidRef;
+    }
+
+    if (mStreamBuffer != Constant::kGlInvalidRef) {
+        glDeleteBuffers(1, &mStreamBuffer);
+        mStreamBuffer = Constant::kGlInvalidRef;
+    }
+
+    mStreamSize = 0;
+    mStreamOffset = 0;
+    mCurrentProgram = PROGRAM_COUNT;
+    mShadowVertexZLoc = Constant::kGlInValidLocation;
+    mShadowStartColorLoc = Constant::kGlInValidLocation;
+    mShadowEndColorLoc = Constant::kGlInValidLocation;
+    mShadowHasGradientLoc = Constant::kGlInValidLocation;
+    mQuadVertexZLoc = Constant::kGlInValidLocation;
+    mMaskColorLoc = Constant::kGlInValidLocation;
+    mTexXOffsetLoc = Constant::kGlInValidLocation;
+    Error::cleanGlError();
+}
+
+int GLES3RenderBackend::init() {
+    clean();
+
+    const char *version = (const char *)glGetString(GL_VERSION);
+    if (version == NULL || strncmp(version, "OpenGL ES ", 10) != 0 ||
+        version[10] < '3' || !loadFunctions()) {
+        LOGE(TAG, "OpenGL ES 3.0 is not supported, version: %s",
+             version ? version : "unknown");
+        return gError.set(Error::ERR_UNSUPPORT_GLES3);
+    }
+
+    glClearColor(0, 0, 0, 1);
+    glClearDepthf(1.0f);
+    glDisable(GL_DEPTH_TEST);
+    mIsDepthTestOn = false;
+
+    if (initProgram(PAGE_PROGRAM, g_page_vertex_shader,
+                    g_page_fragment_shader) != Error::OK ||
+        initProgram(SHADOW_PROGRAM, g_shadow_vertex_shader,
+                    g_shadow_fragment_shader) != Error::OK ||
+        initProgram(BACK_OF_FOLD_PROGRAM, g_back_of_fold_vertex_shader,
+                    g_back_of_fold_fragment_shader) != Error::OK ||
+        initProgram(INSTANCED_QUAD_PROGRAM, g_instanced_quad_vertex_shader,
+                    g_shadow_fragment_shader) != Error::OK) {
+        const int error = gError.code();
+        clean();
+        return gError.set(error);
+    }
+
+    // samplers never change, bind them to texture units once
+    GLuint program = mPrograms[PAGE_PROGRAM].programRef();
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "u_texture"), 0);
+
+    program = mPrograms[SHADOW_PROGRAM].programRef();
+    mShadowVertexZLoc = glGetUniformLocation(program, "u_vexZ");
+    mShadowStartColorLoc = glGetUniformLocation(program, "u_startColor");
+    mShadowEndColorLoc = glGetUniformLocation(program, "u_endColor");
+    mShadowHasGradientLoc = glGetUniformLocation(program, "u_hasGradient");
+
+    program = mPrograms[BACK_OF_FOLD_PROGRAM].programRef();
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "u_texture"), 0);
+    glUniform1i(glGetUniformLocation(program, "u_shadow"), 1);
+    mMaskColorLoc = glGetUniformLocation(program, "u_maskColor");
+    mTexXOffsetLoc = glGetUniformLocation(program, "u_texXOffset");
+
+    program = mPrograms[INSTANCED_QUAD_PROGRAM].programRef();
+    mQuadVertexZLoc = glGetUniformLocation(program, "u_vexZ");
+    mCurrentProgram = PROGRAM_COUNT;
+
+    // uniform buffer of MVP matrix
+    glGenBuffers(1, &mFrameBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, mFrameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Mat4), Mat4::identity().data(),
+                 GL_DYNAMIC_DRAW);
+    mBindBufferBase(GL_UNIFORM_BUFFER, kFrameBlockBinding, mFrameBuffer);
+
+    // stream buffer stays bound to GL_ARRAY_BUFFER, attribute pointers of
+    // every vertex array refer to it
+    glGenBuffers(1, &mStreamBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mStreamBuffer);
+    mStreamSize = kStreamBufferSize;
+    glBufferData(GL_ARRAY_BUFFER, mStreamSize, NULL, GL_STREAM_DRAW);
+
+    mGenVertexArrays(PROGRAM_COUNT, mVertexArrays);
+    for (int i = 0; i < PROGRAM_COUNT; ++i) {
+        mBindVertexArray(mVertexArrays[i]);
+        glEnableVertexAttribArray(kVertexPosLoc);
+        if (i == INSTANCED_QUAD_PROGRAM) {
+            glEnableVertexAttribArray(kInstanceLoc);
+            mVertexAttribDivisor(kInstanceLoc, 1);
+        }
+        else if (i != SHADOW_PROGRAM) {
+            glEnableVertexAttribArray(kTexCoordLoc);
+        }
+    }
+    mBindVertexArray(0);
+
+    if (gError.checkGlError("When init GLES3 backend") != Error::OK) {
+        LOGE(TAG, "%s", gError.desc());
+        const int error = gError.code();
+        clean();
+        return gError.set(error);
+    }
+
+    return Error::OK;
+}
+
+int GLES3RenderBackend::initProgram(ProgramIndex index,
+                                    const char *vertexGLSL,
+                                    const char *fragmentGLSL) {
+    Program_ &program = mPrograms[index];
+    if (program.init(vertexGLSL, fragmentGLSL) != Error::OK) {
+        LOGE(TAG, "Can't create program %d: %s", index, gError.desc());
+        return gError.code();
+    }
+
+    const GLuint ref = program.programRef();
+    const GLuint blockIndex = mGetUniformBlockIndex(ref, VAR_FRAME_BLOCK);
+    if (blockIndex != GL_INVALID_INDEX) {
+        mUniformBlockBinding(ref, blockIndex, kFrameBlockBinding);
+    }
+
+    return Error::OK;
+}
+
+/**
+ * Set viewport and update MVP matrix in uniform buffer, all programs see the
+ * new matrix without uploading it one by one
+ */
+void GLES3RenderBackend::setViewport(int width, int height, const Mat4 &mvp) {
+    glViewport(0, 0, width, height);
+    if (mFrameBuffer != Constant::kGlInvalidRef) {
+        glBindBuffer(GL_UNIFORM_BUFFER, mFrameBuffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Mat4), mvp.data());
+    }
+}
+
+void GLES3RenderBackend::beginFrame(bool hasDepthTest) {
+    if (hasDepthTest != mIsDepthTestOn) {
+        hasDepthTest ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+        mIsDepthTestOn = hasDepthTest;
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT | (hasDepthTest ? GL_DEPTH_BUFFER_BIT : 0));
+}
+
+/**
+ * Create immutable texture, bitmap stride is given by unpack row length so
+ * padded rows are uploaded correctly
+ */
+GLuint GLES3RenderBackend::createTexture(AndroidBitmapInfo &info,
+                                         const void *data) {
+    GLenum internalFormat;
+    GLenum format;
+    GLenum type;
+    uint32_t bytesPerPixel;
+    if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
+        internalFormat = GL_RGB565;
+        format = GL_RGB;
+        type = GL_UNSIGNED_SHORT_5_6_5;
+        bytesPerPixel = 2;
+    }
+    else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        internalFormat = GL_RGBA8;
+        format = GL_RGBA;
+        type = GL_UNSIGNED_BYTE;
+        bytesPerPixel = 4;
+    }
+    else {
+        return 0;
+    }
+
+    GLuint id;
+    glGenTextures(1, &id);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    mTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, info.width, info.height);
+
+    const bool isPadded = info.stride != info.width * bytesPerPixel;
+    if (isPadded) {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, info.stride / bytesPerPixel);
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, info.width, info.height, format,
+                    type, data);
+    if (isPadded) {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    return id;
+}
+
+void GLES3RenderBackend::deleteTextures(int count, const GLuint *ids) {
+    glDeleteTextures(count, ids);
+}
+
+/**
+ * Copy vertex data into stream buffer and return its offset
+ * <p>Every draw writes a new range which is never used by GPU since buffer
+ * is orphaned, so it can be mapped without synchronization. The buffer is
+ * grown if one draw doesn't fit in it</p>
+ */
+GLintptr GLES3RenderBackend::stream(const void *data, GLsizeiptr size) {
+    // keep every range aligned with 16 bytes
+    const GLsizeiptr alignedSize = (size + 15) & ~15;
+    if (alignedSize > mStreamSize) {
+        while (mStreamSize < alignedSize) {
+            mStreamSize <<= 1;
+        }
+        glBufferData(GL_ARRAY_BUFFER, mStreamSize, NULL, GL_STREAM_DRAW);
+        mStreamOffset = 0;
+    }
+    else if (mStreamOffset + alignedSize > mStreamSize) {
+        glBufferData(GL_ARRAY_BUFFER, mStreamSize, NULL, GL_STREAM_DRAW);
+        mStreamOffset = 0;
+    }
+
+    const GLintptr offset = mStreamOffset;
+    void *dst = mMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                                GL_MAP_WRITE_BIT |
+                                GL_MAP_INVALIDATE_RANGE_BIT |
+                                GL_MAP_UNSYNCHRONIZED_BIT);
+    if (dst) {
+        memcpy(dst, data, size);
+        mUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    else {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+
+    mStreamOffset += alignedSize;
+    return offset;
+}
+
+void GLES3RenderBackend::drawPage(PrimitiveType type,
+                                  const float *vertexes,
+                                  int sizeOfPerVex,
+                                  const float *texCoords,
+                                  int offset,
+                                  int count,
+                                  GLuint textureId) {
+    if (count <= 0) {
+        return;
+    }
+
+    useProgram(PAGE_PROGRAM);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+
+    // only stream the drawn range
+    const GLintptr posOffset = stream(vertexes + offset * sizeOfPerVex,
+                                      count * sizeOfPerVex * sizeof(float));
+    const GLintptr texOffset = stream(texCoords + offset * 2,
+                                      count * 2 * sizeof(float));
+    glVertexAttribPointer(kVertexPosLoc, sizeOfPerVex, GL_FLOAT, GL_FALSE, 0,
+                          (const void *)posOffset);
+    glVertexAttribPointer(kTexCoordLoc, 2, GL_FLOAT, GL_FALSE, 0,
+                          (const void *)texOffset);
+
+    glDrawArrays(type == TRIANGLE_FAN ? GL_TRIANGLE_FAN : GL_TRIANGLE_STRIP,
+                 0, count);
+}
+
+void GLES3RenderBackend::drawShadow(const float *vertexes,
+                                    const float *gradients,
+                                    int count,
+                                    const ShadowColor &color,
+                                    float vertexZ) {
+    if (count <= 0) {
+        return;
+    }
+
+    useProgram(SHADOW_PROGRAM);
+    glUniform1f(mShadowVertexZLoc, vertexZ);
+    glUniform2f(mShadowStartColorLoc, color.startColor, color.startAlpha);
+    glUniform2f(mShadowEndColorLoc, color.endColor, color.endAlpha);
+    glUniform1i(mShadowHasGradientLoc, gradients ? 1 : 0);
+
+    const GLintptr posOffset = stream(vertexes, count * 2 * sizeof(float));
+    glVertexAttribPointer(kVertexPosLoc, 2, GL_FLOAT, GL_FALSE, 0,
+                          (const void *)posOffset);
+
+    // gradient array is only enabled when it is given
+    if (gradients) {
+        const GLintptr gradientOffset = stream(gradients,
+                                               count * sizeof(float));
+        glVertexAttribPointer(kGradientLoc, 1, GL_FLOAT, GL_FALSE, 0,
+                              (const void *)gradientOffset);
+        glEnableVertexAttribArray(kGradientLoc);
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (mBlendScissor) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(mBlendScissor[0], mBlendScissor[1], mBlendScissor[2],
+                  mBlendScissor[3]);
+    }
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, count);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+
+    if (gradients) {
+        glDisableVertexAttribArray(kGradientLoc);
+    }
+}
+
+void GLES3RenderBackend::drawBackOfFold(const float *vertexes,
+                                        const float *texCoords,
+                                        int count,
+                                        GLuint textureId,
+                                        GLuint gradientLightId,
+                                        const float *maskColor,
+                                        float maskAlpha,
+                                        float texXOffset) {
+    if (count <= 0) {
+        return;
+    }
+
+    useProgram(BACK_OF_FOLD_PROGRAM);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, gradientLightId);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+
+    glUniform1f(mTexXOffsetLoc, texXOffset);
+    glUniform4f(mMaskColorLoc,
+                maskColor[0], maskColor[1], maskColor[2], maskAlpha);
+
+    const GLintptr posOffset = stream(vertexes, count * 4 * sizeof(float));
+    const GLintptr texOffset = stream(texCoords, count * 2 * sizeof(float));
+    glVertexAttribPointer(kVertexPosLoc, 4, GL_FLOAT, GL_FALSE, 0,
+                          (const void *)posOffset);
+    glVertexAttribPointer(kTexCoordLoc, 2, GL_FLOAT, GL_FALSE, 0,
+                          (const void *)texOffset);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, count);
+}
+
+/**
+ * Draw all quads with one instanced draw call, quad and instances are
+ * streamed together
+ */
+void GLES3RenderBackend::drawInstancedQuads(const float *quad,
+                                            const float *instances,
+                                            int count,
+                                            float vertexZ) {
+    if (count <= 0) {
+        return;
+    }
+
+    useProgram(INSTANCED_QUAD_PROGRAM);
+    glUniform1f(mQuadVertexZLoc, vertexZ);
+
+    const GLintptr quadOffset = stream(quad, 8 * sizeof(float));
+    const GLintptr instanceOffset = stream(instances,
+                                           count * 4 * sizeof(float));
+    glVertexAttribPointer(kVertexPosLoc, 2, GL_FLOAT, GL_FALSE, 0,
+                          (const void *)quadOffset);
+    glVertexAttribPointer(kInstanceLoc, 4, GL_FLOAT, GL_FALSE, 0,
+                          (const void *)instanceOffset);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    mDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+    glDisable(GL_BLEND);
+}
+
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_GLES3RENDERBACKEND_H
+#define ANDROID_PAGEFLIP_GLES3RENDERBACKEND_H
+
+#include <GLES2/gl2.h>
+#include "RenderBackend.h"
+#include "GLProgram.h"
+
+namespace eschao {
+
+/**
+ * Render backend with OpenGL ES 3.0
+ * <p>Compared with {@link GLRenderBackend}, it reduces driver work per draw
+ * call:</p>
+ * <ul>
+ *     <li>MVP matrix is stored in one uniform buffer shared by all programs
+ *     and only uploaded when viewport is changed</li>
+ *     <li>every program has its own vertex array object, attribute arrays
+ *     are enabled once and vertex data are streamed into one ring buffer
+ *     instead of client side arrays which are copied at every draw</li>
+ *     <li>sampler units are bound once when programs are created</li>
+ *     <li>textures are immutable and bitmap stride is honored by unpack
+ *     row length</li>
+ *     <li>instanced quads, e.g. page stack, are drawn by hardware
+ *     instancing</li>
+ * </ul>
+ * <p>GLES3 entry points are loaded at runtime, so library is still linked
+ * with GLESv2 only and works on old devices. {@link #init()} returns
+ * {@link Error#ERR_UNSUPPORT_GLES3} if current context is not 3.0+</p>
+ */
+class GLES3RenderBackend : public RenderBackend {
+
+public:
+    GLES3RenderBackend();
+    virtual ~GLES3RenderBackend();
+
+    virtual int init();
+    virtual void setViewport(int width, int height, const Mat4 &mvp);
+    virtual void beginFrame(bool hasDepthTest);
+    virtual GLuint createTexture(AndroidBitmapInfo &info, const void *data);
+    virtual void deleteTextures(int count, const GLuint *ids);
+    virtual void drawPage(PrimitiveType type,
+                          const float *vertexes,
+                          int sizeOfPerVex,
+                          const float *texCoords,
+                          int offset,
+                          int count,
+                          GLuint textureId);
+    virtual void drawShadow(const float *vertexes,
+                            const float *gradients,
+                            int count,
+                            const ShadowColor &color,
+                            float vertexZ);
+    virtual void drawBackOfFold(const float *vertexes,
+                                const float *texCoords,
+                                int count,
+                                GLuint textureId,
+                                GLuint gradientLightId,
+                                const float *maskColor,
+                                float maskAlpha,
+                                float texXOffset);
+    virtual void drawInstancedQuads(const float *quad,
+                                    const float *instances,
+                                    int count,
+                                    float vertexZ);
+
+    void clean();
+
+private:
+    // program with fixed attribute locations, locations of uniforms are
+    // queried by backend
+    class Program_ : public GLProgram {
+    protected:
+        virtual void getVarsLocation() { }
+    };
+
+    enum ProgramIndex {
+        PAGE_PROGRAM = 0,
+        SHADOW_PROGRAM,
+        BACK_OF_FOLD_PROGRAM,
+        INSTANCED_QUAD_PROGRAM,
+        PROGRAM_COUNT,
+    };
+
+    bool loadFunctions();
+    int initProgram(ProgramIndex index, const char *vertexGLSL,
+                    const char *fragmentGLSL);
+    GLintptr stream(const void *data, GLsizeiptr size);
+
+    inline void useProgram(ProgramIndex index) {
+        if (mCurrentProgram != index) {
+            glUseProgram(mPrograms[index].programRef());
+            mBindVertexArray(mVertexArrays[index]);
+            mCurrentProgram = index;
+        }
+    }
+
+private:
+    typedef void (*GenVertexArraysFunc)(GLsizei n, GLuint *arrays);
+    typedef void (*BindVertexArrayFunc)(GLuint array);
+    typedef void (*DeleteVertexArraysFunc)(GLsizei n, const GLuint *arrays);
+    typedef void* (*MapBufferRangeFunc)(GLenum target, GLintptr offset,
+                                        GLsizeiptr length, GLbitfield access);
+    typedef GLboolean (*UnmapBufferFunc)(GLenum target);
+    typedef GLuint (*GetUniformBlockIndexFunc)(GLuint program,
+                                               const GLchar *name);
+    typedef void (*UniformBlockBindingFunc)(GLuint program, GLuint index,
+                                            GLuint binding);
+    typedef void (*BindBufferBaseFunc)(GLenum target, GLuint index,
+                                       GLuint buffer);
+    typedef void (*TexStorage2DFunc)(GLenum target, GLsizei levels,
+                                     GLenum internalFormat, GLsizei width,
+                                     GLsizei height);
+    typedef void (*VertexAttribDivisorFunc)(GLuint index, GLuint divisor);
+    typedef void (*DrawArraysInstancedFunc)(GLenum mode, GLint first,
+                                            GLsizei count,
+                                            GLsizei instanceCount);
+
+    bool mIsLoaded;
+    GenVertexArraysFunc mGenVertexArrays;
+    BindVertexArrayFunc mBindVertexArray;
+    DeleteVertexArraysFunc mDeleteVertexArrays;
+    MapBufferRangeFunc mMapBufferRange;
+    UnmapBufferFunc mUnmapBuffer;
+    GetUniformBlockIndexFunc mGetUniformBlockIndex;
+    UniformBlockBindingFunc mUniformBlockBinding;
+    BindBufferBaseFunc mBindBufferBase;
+    TexStorage2DFunc mTexStorage2D;
+    VertexAttribDivisorFunc mVertexAttribDivisor;
+    DrawArraysInstancedFunc mDrawArraysInstanced;
+
+    Program_ mPrograms[PROGRAM_COUNT];
+    GLuint mVertexArrays[PROGRAM_COUNT];
+    int mCurrentProgram;
+
+    // uniform locations
+    GLint mShadowVertexZLoc;
+    GLint mShadowStartColorLoc;
+    GLint mShadowEndColorLoc;
+    GLint mShadowHasGradientLoc;
+    GLint mQuadVertexZLoc;
+    GLint mMaskColorLoc;
+    GLint mTexXOffsetLoc;
+
+    // uniform buffer of MVP matrix
+    GLuint mFrameBuffer;
+
+    // ring buffer of streamed vertex data, it is orphaned when it wraps
+    GLuint mStreamBuffer;
+    GLsizeiptr mStreamSize;
+    GLintptr mStreamOffset;
+
+    bool mIsDepthTestOn;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_GLES3RENDERBACKEND_H
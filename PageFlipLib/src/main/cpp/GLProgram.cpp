@@ -17,14 +17,18 @@
 #include <iostream>
 #include "GLProgram.h"
 #include "Error.h"
-#include "constant.h"
+#include "Constant.h"
 #include "Utility.h"
 
 using namespace std;
 
 namespace eschao {
 
-GLProgram::GLProgram() {
+static const char* VAR_MVP_MATRIX = "u_MVPMatrix";
+
+GLProgram::GLProgram()
+        : mMVPMatrixLoc(Constant::kGlInValidLocation),
+          mIsMVPMatrixDirty(true) {
     mProgramRef = Constant::kGlInvalidRef;
 }
 
@@ -33,6 +37,8 @@ GLProgram::~GLProgram() {
 }
 
 void GLProgram::clean() {
+    mMVPMatrixLoc = Constant::kGlInValidLocation;
+    mIsMVPMatrixDirty = true;
     mShader.clean();
     mFragment.clean();
 
@@ -101,8 +107,22 @@ int GLProgram::init(const char* shaderGLSL, const char* fragmentGLSL) {
     }
 
     glUseProgram(mProgramRef);
+    mMVPMatrixLoc = glGetUniformLocation(mProgramRef, VAR_MVP_MATRIX);
+    mIsMVPMatrixDirty = true;
     getVarsLocation();
     return Error::OK;
 }
 
+/**
+ * Upload MVP matrix to GPU if it is changed
+ * <p>Uniform value is stored in program object, so the program must be the
+ * current one when calling this function</p>
+ */
+void GLProgram::uploadMVPMatrix() {
+    if (mIsMVPMatrixDirty && mMVPMatrixLoc != Constant::kGlInValidLocation) {
+        glUniformMatrix4fv(mMVPMatrixLoc, 1, GL_FALSE, mMVPMatrix.data());
+        mIsMVPMatrixDirty = false;
+    }
+}
+
 }
@@ -19,6 +19,7 @@
 
 #include <GLES2/gl2.h>
 #include "GLShader.h"
+#include "Matrix.h"
 
 namespace eschao {
 
@@ -33,10 +34,27 @@ public:
     int init(const char *shaderGLSL, const char *fragmentGLSL);
     virtual void clean();
 
+    void uploadMVPMatrix();
+
     inline int programRef() {
         return mProgramRef;
     }
 
+    inline GLint mvpMatrixLoc() {
+        return mMVPMatrixLoc;
+    }
+
+    inline const Mat4& mvpMatrix() {
+        return mMVPMatrix;
+    }
+
+    inline void setMVPMatrix(const Mat4 &matrix) {
+        if (mMVPMatrix != matrix) {
+            mMVPMatrix = matrix;
+            mIsMVPMatrixDirty = true;
+        }
+    }
+
 protected:
     virtual void getVarsLocation() = 0;
 
@@ -44,6 +62,12 @@ protected:
     GLuint mProgramRef;
     GLShader mShader;
     GLShader mFragment;
+
+    // every program has its own MVP matrix, it is only uploaded to GPU when
+    // it is changed or program is re-created
+    Mat4 mMVPMatrix;
+    GLint mMVPMatrixLoc;
+    bool mIsMVPMatrixDirty;
 };
 
 }
@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "GLRenderBackend.h"
+#include "Error.h"
+
+namespace eschao {
+
+GLRenderBackend::GLRenderBackend()
+        : mCurrentProgram(NULL),
+          mIsDepthTestOn(false) {
+}
+
+int GLRenderBackend::init() {
+    glClearColor(0, 0, 0, 1);
+    glClearDepthf(1.0f);
+    glDisable(GL_DEPTH_TEST);
+    mIsDepthTestOn = false;
+    mCurrentProgram = NULL;
+
+    if (mVertexProg.init() != Error::OK ||
+        mShadowVertexProg.init() != Error::OK ||
+        mBackOfFoldVertexProg.init() != Error::OK ||
+        mSinglePassVertexProg.init() != Error::OK ||
+        mTwoSidedFoldVertexProg.init() != Error::OK ||
+        mFoldDeformVertexProg.init() != Error::OK ||
+        mFoldClipVertexProg.init() != Error::OK) {
+        mVertexProg.clean();
+        mShadowVertexProg.clean();
+        mBackOfFoldVertexProg.clean();
+        mSinglePassVertexProg.clean();
+        mTwoSidedFoldVertexProg.clean();
+        mFoldDeformVertexProg.clean();
+        mFoldClipVertexProg.clean();
+        return gError.code();
+    }
+
+    return Error::OK;
+}
+
+/**
+ * Set viewport and MVP matrix of all programs, programs will upload it in
+ * the next drawing
+ */
+void GLRenderBackend::setViewport(int width, int height, const Mat4 &mvp) {
+    glViewport(0, 0, width, height);
+    mVertexProg.setMVPMatrix(mvp);
+    mShadowVertexProg.setMVPMatrix(mvp);
+    mBackOfFoldVertexProg.setMVPMatrix(mvp);
+    mSinglePassVertexProg.setMVPMatrix(mvp);
+    mTwoSidedFoldVertexProg.setMVPMatrix(mvp);
+    mFoldDeformVertexProg.setMVPMatrix(mvp);
+    mFoldClipVertexProg.setMVPMatrix(mvp);
+}
+
+/**
+ * Clear frame and enable or disable depth test
+ * <p>Depth free mode can be changed in any thread, the GL state is only
+ * changed here in GL thread</p>
+ */
+void GLRenderBackend::beginFrame(bool hasDepthTest) {
+    if (hasDepthTest != mIsDepthTestOn) {
+        hasDepthTest ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+        mIsDepthTestOn = hasDepthTest;
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT | (hasDepthTest ? GL_DEPTH_BUFFER_BIT : 0));
+}
+
+GLuint GLRenderBackend::createTexture(AndroidBitmapInfo &info,
+                                      const void *data) {
+    GLint format;
+    GLenum type;
+    if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
+        format = GL_RGB;
+        type = GL_UNSIGNED_SHORT_5_6_5;
+    }
+    else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        format = GL_RGBA;
+        type = GL_UNSIGNED_BYTE;
+    }
+    else {
+        return 0;
+    }
+
+    GLuint id;
+    glGenTextures(1, &id);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, info.width, info.height, 0, format,
+                 type, data);
+    return id;
+}
+
+void GLRenderBackend::deleteTextures(int count, const GLuint *ids) {
+    glDeleteTextures(count, ids);
+}
+
+void GLRenderBackend::drawPage(PrimitiveType type,
+                               const float *vertexes,
+                               int sizeOfPerVex,
+                               const float *texCoords,
+                               int offset,
+                               int count,
+                               GLuint textureId) {
+    useProgram(mVertexProg);
+    mVertexProg.uploadMVPMatrix();
+    mVertexProg.foldShadowUniforms().upload(mFoldShadow);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glUniform1i(mVertexProg.textureLoc(), 0);
+
+    glVertexAttribPointer(mVertexProg.vertexPosLoc(), sizeOfPerVex, GL_FLOAT,
+                          GL_FALSE, 0, vertexes);
+    glEnableVertexAttribArray(mVertexProg.vertexPosLoc());
+
+    glVertexAttribPointer(mVertexProg.texCoordLoc(), 2, GL_FLOAT, GL_FALSE,
+                          0, texCoords);
+    glEnableVertexAttribArray(mVertexProg.texCoordLoc());
+
+    glDrawArrays(type == TRIANGLE_FAN ? GL_TRIANGLE_FAN : GL_TRIANGLE_STRIP,
+                 offset, count);
+}
+
+/**
+ * Draw shadow strip, the pair gradients are shared by all strips without
+ * gradients and are only filled when strip is longer than before
+ */
+void GLRenderBackend::drawShadow(const float *vertexes,
+                                 const float *gradients,
+                                 int count,
+                                 const ShadowColor &color,
+                                 float vertexZ) {
+    useProgram(mShadowVertexProg);
+    mShadowVertexProg.uploadMVPMatrix();
+    glUniform1f(mShadowVertexProg.vertexZLoc(), vertexZ);
+    glUniform2f(mShadowVertexProg.startColorLoc(),
+                color.startColor, color.startAlpha);
+    glUniform2f(mShadowVertexProg.endColorLoc(),
+                color.endColor, color.endAlpha);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (mBlendScissor) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(mBlendScissor[0], mBlendScissor[1], mBlendScissor[2],
+                  mBlendScissor[3]);
+    }
+
+    glVertexAttribPointer(mShadowVertexProg.vertexPosLoc(), 2, GL_FLOAT,
+                          GL_FALSE, 0, vertexes);
+    glEnableVertexAttribArray(mShadowVertexProg.vertexPosLoc());
+
+    glVertexAttribPointer(mShadowVertexProg.gradientLoc(), 1, GL_FLOAT,
+                          GL_FALSE, 0,
+                          gradients ? gradients : pairGradients(count));
+    glEnableVertexAttribArray(mShadowVertexProg.gradientLoc());
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, count);
+
+    glDisableVertexAttribArray(mShadowVertexProg.gradientLoc());
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+}
+
+const float* GLRenderBackend::pairGradients(int count) {
+    const int size = (int)mPairGradients.size();
+    if (size < count) {
+        mPairGradients.resize(count);
+        for (int i = size; i < count; ++i) {
+            mPairGradients[i] = (float)(i & 1);
+        }
+    }
+
+    return &mPairGradients[0];
+}
+
+void GLRenderBackend::drawBackOfFold(const float *vertexes,
+                                     const float *texCoords,
+                                     int count,
+                                     GLuint textureId,
+                                     GLuint gradientLightId,
+                                     const float *maskColor,
+                                     float maskAlpha,
+                                     float texXOffset) {
+    BackOfFoldVertexProgram &program = mBackOfFoldVertexProg;
+    useProgram(program);
+    program.uploadMVPMatrix();
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glUniform1i(program.textureLoc(), 0);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, gradientLightId);
+    glUniform1i(program.shadowLoc(), 1);
+    glActiveTexture(GL_TEXTURE0);
+
+    glUniform1f(program.texXOffsetLoc(), texXOffset);
+    glUniform4f(program.maskColorLoc(),
+                maskColor[0], maskColor[1], maskColor[2], maskAlpha);
+
+    glVertexAttribPointer(program.vertexPosLoc(), 4, GL_FLOAT, GL_FALSE, 0,
+                          vertexes);
+    glEnableVertexAttribArray(program.vertexPosLoc());
+
+    glVertexAttribPointer(program.texCoordLoc(), 2, GL_FLOAT, GL_FALSE, 0,
+                          texCoords);
+    glEnableVertexAttribArray(program.texCoordLoc());
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, count);
+}
+
+/**
+ * Draw two-sided fold strip with one draw call, the front and back are
+ * told apart by gl_FrontFacing in fragment shader
+ */
+void GLRenderBackend::drawTwoSidedFold(const float *vertexes,
+                                       const float *texCoords,
+                                       int backCount,
+                                       int frontOffset,
+                                       int count,
+                                       GLuint frontTextureId,
+                                       GLuint backTextureId,
+                                       GLuint gradientLightId,
+                                       const float *maskColor,
+                                       float maskAlpha,
+                                       float texXOffset) {
+    TwoSidedFoldVertexProgram &program = mTwoSidedFoldVertexProg;
+    useProgram(program);
+    program.uploadMVPMatrix();
+    program.foldShadowUniforms().upload(mFoldShadow);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, backTextureId);
+    glUniform1i(program.textureLoc(), 0);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, gradientLightId);
+    glUniform1i(program.shadowLoc(), 1);
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, frontTextureId);
+    glUniform1i(program.frontTextureLoc(), 2);
+    glActiveTexture(GL_TEXTURE0);
+
+    glUniform1f(program.texXOffsetLoc(), texXOffset);
+    glUniform4f(program.maskColorLoc(),
+                maskColor[0], maskColor[1], maskColor[2], maskAlpha);
+
+    glVertexAttribPointer(program.vertexPosLoc(), 4, GL_FLOAT, GL_FALSE, 0,
+                          vertexes);
+    glEnableVertexAttribArray(program.vertexPosLoc());
+
+    glVertexAttribPointer(program.texCoordLoc(), 2, GL_FLOAT, GL_FALSE, 0,
+                          texCoords);
+    glEnableVertexAttribArray(program.texCoordLoc());
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, count);
+}
+
+/**
+ * Draw page quad whose fragments pick the first or second texture by side
+ * of fold line, it replaces two page polygons split by fold line
+ */
+void GLRenderBackend::drawFoldClippedPage(const float *vertexes,
+                                          const float *texCoords,
+                                          const float *foldLine,
+                                          float vertexZ,
+                                          GLuint firstTextureId,
+                                          GLuint secondTextureId) {
+    FoldClipVertexProgram &program = mFoldClipVertexProg;
+    useProgram(program);
+    program.uploadMVPMatrix();
+    program.foldShadowUniforms().upload(mFoldShadow);
+    glUniform3f(program.foldLineLoc(), foldLine[0], foldLine[1], foldLine[2]);
+    glUniform1f(program.vertexZLoc(), vertexZ);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, firstTextureId);
+    glUniform1i(program.textureLoc(), 0);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, secondTextureId);
+    glUniform1i(program.secondTextureLoc(), 1);
+    glActiveTexture(GL_TEXTURE0);
+
+    glVertexAttribPointer(program.vertexPosLoc(), 2, GL_FLOAT, GL_FALSE,
+                          3 * sizeof(float), vertexes);
+    glEnableVertexAttribArray(program.vertexPosLoc());
+
+    glVertexAttribPointer(program.texCoordLoc(), 2, GL_FLOAT, GL_FALSE, 0,
+                          texCoords);
+    glEnableVertexAttribArray(program.texCoordLoc());
+
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
+
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_GLRENDERBACKEND_H
+#define ANDROID_PAGEFLIP_GLRENDERBACKEND_H
+
+#include "RenderBackend.h"
+#include "VertexProgram.h"
+#include "ShadowVertexProgram.h"
+#include "BackOfFoldVertexProgram.h"
+#include "SinglePassVertexProgram.h"
+#include "TwoSidedFoldVertexProgram.h"
+#include "FoldDeformVertexProgram.h"
+#include "FoldClipVertexProgram.h"
+
+namespace eschao {
+
+/**
+ * Render backend with OpenGL ES 2.0
+ * <p>It owns all shader programs, the single pass and fold deformation
+ * programs are only used by PageFlip directly since they rely on their own
+ * shaders and vertex layouts</p>
+ */
+class GLRenderBackend : public RenderBackend {
+
+public:
+    GLRenderBackend();
+
+    virtual int init();
+    virtual void setViewport(int width, int height, const Mat4 &mvp);
+    virtual void beginFrame(bool hasDepthTest);
+    virtual GLuint createTexture(AndroidBitmapInfo &info, const void *data);
+    virtual void deleteTextures(int count, const GLuint *ids);
+    virtual void drawPage(PrimitiveType type,
+                          const float *vertexes,
+                          int sizeOfPerVex,
+                          const float *texCoords,
+                          int offset,
+                          int count,
+                          GLuint textureId);
+    virtual void drawShadow(const float *vertexes,
+                            const float *gradients,
+                            int count,
+                            const ShadowColor &color,
+                            float vertexZ);
+    virtual void drawBackOfFold(const float *vertexes,
+                                const float *texCoords,
+                                int count,
+                                GLuint textureId,
+                                GLuint gradientLightId,
+                                const float *maskColor,
+                                float maskAlpha,
+                                float texXOffset);
+    virtual void drawTwoSidedFold(const float *vertexes,
+                                  const float *texCoords,
+                                  int backCount,
+                                  int frontOffset,
+                                  int count,
+                                  GLuint frontTextureId,
+                                  GLuint backTextureId,
+                                  GLuint gradientLightId,
+                                  const float *maskColor,
+                                  float maskAlpha,
+                                  float texXOffset);
+    virtual void drawFoldClippedPage(const float *vertexes,
+                                     const float *texCoords,
+                                     const float *foldLine,
+                                     float vertexZ,
+                                     GLuint firstTextureId,
+                                     GLuint secondTextureId);
+
+    virtual bool isFoldShadowSupported() {
+        return true;
+    }
+
+    virtual bool isFoldClipSupported() {
+        return true;
+    }
+
+    inline SinglePassVertexProgram& singlePassProgram() {
+        useProgram(mSinglePassVertexProg);
+        return mSinglePassVertexProg;
+    }
+
+    inline FoldDeformVertexProgram& foldDeformProgram() {
+        useProgram(mFoldDeformVertexProg);
+        return mFoldDeformVertexProg;
+    }
+
+private:
+    const float* pairGradients(int count);
+
+    inline void useProgram(GLProgram &program) {
+        if (mCurrentProgram != &program) {
+            glUseProgram(program.programRef());
+            mCurrentProgram = &program;
+        }
+    }
+
+private:
+    VertexProgram mVertexProg;
+    ShadowVertexProgram mShadowVertexProg;
+    BackOfFoldVertexProgram mBackOfFoldVertexProg;
+    SinglePassVertexProgram mSinglePassVertexProg;
+    TwoSidedFoldVertexProgram mTwoSidedFoldVertexProg;
+    FoldDeformVertexProgram mFoldDeformVertexProg;
+    FoldClipVertexProgram mFoldClipVertexProg;
+
+    GLProgram *mCurrentProgram;
+    bool mIsDepthTestOn;
+
+    // gradients of shadow start and end pairs: 0, 1, 0, 1 ...
+    std::vector<float> mPairGradients;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_GLRENDERBACKEND_H
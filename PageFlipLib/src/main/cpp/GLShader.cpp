@@ -15,7 +15,7 @@
  */
 
 #include "GLShader.h"
-#include "constant.h"
+#include "Constant.h"
 #include "Error.h"
 
 namespace eschao {
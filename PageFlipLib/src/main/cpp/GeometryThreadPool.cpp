@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+#include "GeometryThreadPool.h"
+#include "Error.h"
+
+namespace eschao {
+
+GeometryThreadPool::GeometryThreadPool()
+        : mThreadCount(1),
+          mJob(NULL),
+          mArg(NULL) {
+    for (int i = 0; i < kMaxGeometryThreads - 1; ++i) {
+        mSlices[i].pool = this;
+        mSlices[i].begin = 0;
+        mSlices[i].end = 0;
+    }
+}
+
+GeometryThreadPool::~GeometryThreadPool() {
+    setThreads(1);
+}
+
+/**
+ * Set thread count, workers are started or stopped to match it
+ *
+ * @param count thread count including the calling thread,
+ *              [1 .. kMaxGeometryThreads], 1 means single thread
+ * @return Error::OK if successfully
+ */
+int GeometryThreadPool::setThreads(int count) {
+    if (count < 1 || count > kMaxGeometryThreads) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    // the calling thread is always counted, workers are [0 .. count - 1)
+    const int workers = std::max(mThreadCount - 1, 0);
+    for (int i = count - 1; i < workers; ++i) {
+        mWorkers[i].stop();
+    }
+
+    for (int i = workers; i < count - 1; ++i) {
+        const int ret = mWorkers[i].start(runSlice, &mSlices[i]);
+        if (ret != Error::OK) {
+            // keep workers which are already started
+            mThreadCount = i + 1;
+            return ret;
+        }
+    }
+
+    mThreadCount = count;
+    return Error::OK;
+}
+
+/**
+ * Run job over steps [0 .. count) and wait until all of them are done
+ *
+ * @param job job to compute steps [begin .. end)
+ * @param arg argument of job
+ * @param count step count
+ * @param minCountOfThread min steps of one thread, it is single threaded
+ *                         if steps are too few to be split
+ */
+void GeometryThreadPool::run(RangeJob job, void *arg, int count,
+                             int minCountOfThread) {
+    int threads = minCountOfThread > 0 ? count / minCountOfThread : count;
+    if (threads > mThreadCount) {
+        threads = mThreadCount;
+    }
+
+    if (threads <= 1) {
+        job(arg, 0, count);
+        return;
+    }
+
+    // the first slice is computed by calling thread, the remainder steps
+    // are given to the leading slices
+    mJob = job;
+    mArg = arg;
+    const int size = count / threads;
+    const int rest = count % threads;
+    const int first = size + (rest > 0 ? 1 : 0);
+    int begin = first;
+    for (int i = 1; i < threads; ++i) {
+        Slice_ &slice = mSlices[i - 1];
+        slice.begin = begin;
+        slice.end = begin + size + (i < rest ? 1 : 0);
+        begin = slice.end;
+        mWorkers[i - 1].post();
+    }
+
+    job(arg, 0, first);
+
+    for (int i = 1; i < threads; ++i) {
+        mWorkers[i - 1].wait();
+    }
+}
+
+void GeometryThreadPool::runSlice(void *slice) {
+    Slice_ *s = (Slice_ *)slice;
+    s->pool->mJob(s->pool->mArg, s->begin, s->end);
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_GEOMETRYTHREADPOOL_H
+#define ANDROID_PAGEFLIP_GEOMETRYTHREADPOOL_H
+
+#include "GeometryWorker.h"
+
+namespace eschao {
+
+// max threads of geometry pool, including the calling thread
+static const int kMaxGeometryThreads = 8;
+
+/**
+ * Small persistent thread pool which splits a range of independent steps
+ * <p>The calling thread computes the first slice and the other slices are
+ * posted to {@link GeometryWorker}s, it returns after all slices are done.
+ * Range smaller than the given threshold per thread is computed by calling
+ * thread alone and no worker is woken up</p>
+ */
+class GeometryThreadPool {
+
+public:
+    typedef void (*RangeJob)(void *arg, int begin, int end);
+
+    GeometryThreadPool();
+    ~GeometryThreadPool();
+
+    int setThreads(int count);
+    void run(RangeJob job, void *arg, int count, int minCountOfThread);
+
+    inline int threads() {
+        return mThreadCount;
+    }
+
+private:
+    static void runSlice(void *slice);
+
+private:
+    // range of one worker
+    struct Slice_ {
+        GeometryThreadPool *pool;
+        int begin;
+        int end;
+    };
+
+    int mThreadCount;
+    RangeJob mJob;
+    void *mArg;
+    Slice_ mSlices[kMaxGeometryThreads - 1];
+    GeometryWorker mWorkers[kMaxGeometryThreads - 1];
+};
+
+}
+#endif //ANDROID_PAGEFLIP_GEOMETRYTHREADPOOL_H
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <errno.h>
+#include <string.h>
+#include "GeometryWorker.h"
+#include "Error.h"
+#include "Utility.h"
+
+namespace eschao {
+
+static const auto TAG = "GeometryWorker";
+
+/**
+ * Block on semaphore until it is posted, waiting is restarted if it is
+ * interrupted by signal
+ *
+ * @return false if semaphore can't be waited
+ */
+static bool waitSem(sem_t *sem) {
+    while (sem_wait(sem) != 0) {
+        if (errno != EINTR) {
+            LOGE(TAG, "Can't wait semaphore: %s", strerror(errno));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+GeometryWorker::GeometryWorker()
+        : mJob(NULL),
+          mArg(NULL),
+          mIsRunning(false),
+          mIsBusy(false) {
+    sem_init(&mPostSem, 0, 0);
+    sem_init(&mDoneSem, 0, 0);
+}
+
+GeometryWorker::~GeometryWorker() {
+    stop();
+    sem_destroy(&mDoneSem);
+    sem_destroy(&mPostSem);
+}
+
+/**
+ * Start worker thread
+ *
+ * @param job job run in worker thread for every post
+ * @param arg argument of job
+ * @return Error::OK if successfully
+ */
+int GeometryWorker::start(Job job, void *arg) {
+    if (job == NULL) {
+        return gError.set(Error::ERR_NULL_PARAMETER);
+    }
+
+    stop();
+    mJob = job;
+    mArg = arg;
+    if (pthread_create(&mThread, NULL, run, this) != 0) {
+        LOGE(TAG, "Can't create geometry thread");
+        return gError.set(Error::ERROR);
+    }
+
+    mIsRunning = true;
+    return Error::OK;
+}
+
+/**
+ * Wait for the running job and stop worker thread
+ */
+void GeometryWorker::stop() {
+    if (!mIsRunning) {
+        return;
+    }
+
+    // a post without job makes worker exit
+    wait();
+    mJob = NULL;
+    sem_post(&mPostSem);
+    pthread_join(mThread, NULL);
+    mIsRunning = false;
+}
+
+/**
+ * Post job to worker thread, the previous job must be waited
+ */
+void GeometryWorker::post() {
+    if (mIsRunning && !mIsBusy) {
+        mIsBusy = true;
+        sem_post(&mPostSem);
+    }
+}
+
+/**
+ * Block caller until the posted job is done, data written by job is visible
+ * to caller after it returns
+ */
+void GeometryWorker::wait() {
+    if (mIsBusy) {
+        waitSem(&mDoneSem);
+        mIsBusy = false;
+    }
+}
+
+void* GeometryWorker::run(void *self) {
+    ((GeometryWorker *)self)->work();
+    return NULL;
+}
+
+void GeometryWorker::work() {
+    while (waitSem(&mPostSem)) {
+        // job is only changed while worker is idle
+        if (mJob == NULL) {
+            break;
+        }
+
+        mJob(mArg);
+        sem_post(&mDoneSem);
+    }
+}
+
+}
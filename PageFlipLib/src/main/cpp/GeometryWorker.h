@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_GEOMETRYWORKER_H
+#define ANDROID_PAGEFLIP_GEOMETRYWORKER_H
+
+#include <pthread.h>
+#include <semaphore.h>
+
+namespace eschao {
+
+/**
+ * Dedicated thread which runs one geometry job at a time
+ * <p>GL thread posts a job and waits for it before the next post, the job
+ * and its result are handed over by two semaphores. It isn't lock-free:
+ * worker blocks on semaphore while it is idle, and {@link #wait()} blocks
+ * GL thread until the job is done. Job must only touch data which isn't
+ * changed by GL thread until {@link #wait()} returns</p>
+ */
+class GeometryWorker {
+
+public:
+    typedef void (*Job)(void *arg);
+
+    GeometryWorker();
+    ~GeometryWorker();
+
+    int start(Job job, void *arg);
+    void stop();
+    void post();
+    void wait();
+
+    inline bool isRunning() {
+        return mIsRunning;
+    }
+
+    inline bool isBusy() {
+        return mIsBusy;
+    }
+
+private:
+    static void* run(void *self);
+    void work();
+
+private:
+    Job mJob;
+    void *mArg;
+
+    pthread_t mThread;
+    sem_t mPostSem;
+    sem_t mDoneSem;
+
+    // only accessed in GL thread
+    bool mIsRunning;
+    bool mIsBusy;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_GEOMETRYWORKER_H
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <dlfcn.h>
+#include <android/bitmap.h>
+#include "ImageDecoder.h"
+#include "Error.h"
+#include "Utility.h"
+
+namespace eschao {
+
+static const auto TAG = "ImageDecoder";
+
+// ANDROID_IMAGE_DECODER_SUCCESS of android/imagedecoder.h
+static const int kDecoderSuccess = 0;
+
+ImageDecoder::ImageDecoder()
+        : mIsLoaded(false),
+          mCreateFromBuffer(NULL),
+          mDelete(NULL),
+          mSetFormat(NULL),
+          mSetTargetSize(NULL),
+          mGetMinimumStride(NULL),
+          mDecodeImage(NULL) {
+}
+
+/**
+ * Is native image decoder supported on this device
+ * <p>It loads decoder functions at the first call, so it should be called
+ * before decoding in worker threads</p>
+ */
+bool ImageDecoder::isSupported() {
+    if (!mIsLoaded) {
+        mIsLoaded = true;
+        void *lib = dlopen("libjnigraphics.so", RTLD_NOW);
+        if (lib) {
+            mCreateFromBuffer = (CreateFromBufferFunc)
+                    dlsym(lib, "AImageDecoder_createFromBuffer");
+            mDelete = (DeleteFunc)dlsym(lib, "AImageDecoder_delete");
+            mSetFormat = (SetFormatFunc)
+                    dlsym(lib, "AImageDecoder_setAndroidBitmapFormat");
+            mSetTargetSize = (SetTargetSizeFunc)
+                    dlsym(lib, "AImageDecoder_setTargetSize");
+            mGetMinimumStride = (GetMinimumStrideFunc)
+                    dlsym(lib, "AImageDecoder_getMinimumStride");
+            mDecodeImage = (DecodeImageFunc)
+                    dlsym(lib, "AImageDecoder_decodeImage");
+        }
+    }
+
+    return mCreateFromBuffer && mDelete && mSetFormat && mSetTargetSize &&
+           mGetMinimumStride && mDecodeImage;
+}
+
+/**
+ * Decode image data and scale it to the given size
+ *
+ * @param data compressed image data
+ * @param size size of data
+ * @param width target width
+ * @param height target height
+ * @param pixels decoded RGBA_8888 pixels, caller should delete[] it
+ * @param stride bytes of a row of pixels
+ * @return Error::OK if successfully
+ */
+int ImageDecoder::decode(const void *data, size_t size, int width, int height,
+                         unsigned char *&pixels, size_t &stride) {
+    pixels = NULL;
+    if (!isSupported()) {
+        return Error::ERR_UNSUPPORT_IMAGE_DECODER;
+    }
+
+    AImageDecoder *decoder = NULL;
+    if (mCreateFromBuffer(data, size, &decoder) != kDecoderSuccess) {
+        LOGE(TAG, "Can't create decoder for image data of %zu bytes", size);
+        return Error::ERR_DECODE_IMAGE;
+    }
+
+    int ret = Error::ERR_DECODE_IMAGE;
+    if (mSetFormat(decoder, ANDROID_BITMAP_FORMAT_RGBA_8888) ==
+            kDecoderSuccess &&
+        mSetTargetSize(decoder, width, height) == kDecoderSuccess) {
+        stride = mGetMinimumStride(decoder);
+        const size_t bytes = stride * height;
+        pixels = new unsigned char[bytes];
+        if (mDecodeImage(decoder, pixels, stride, bytes) == kDecoderSuccess) {
+            ret = Error::OK;
+        }
+        else {
+            delete[] pixels;
+            pixels = NULL;
+        }
+    }
+
+    mDelete(decoder);
+    return ret;
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_IMAGEDECODER_H
+#define ANDROID_PAGEFLIP_IMAGEDECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace eschao {
+
+/**
+ * Decode compressed image(PNG, JPEG, WebP ...) to RGBA_8888 pixels in native
+ * <p>AImageDecoder of libjnigraphics is only available since Android 11, its
+ * functions are loaded at runtime, {@link #isSupported()} returns false on
+ * old devices and app should decode bitmaps in Java instead</p>
+ * <p>All functions are thread safe after {@link #isSupported()} is called</p>
+ */
+class ImageDecoder {
+
+public:
+    ImageDecoder();
+
+    bool isSupported();
+    int decode(const void *data, size_t size, int width, int height,
+               unsigned char *&pixels, size_t &stride);
+
+private:
+    struct AImageDecoder;
+    typedef int (*CreateFromBufferFunc)(const void *buffer, size_t length,
+                                        AImageDecoder **decoder);
+    typedef void (*DeleteFunc)(AImageDecoder *decoder);
+    typedef int (*SetFormatFunc)(AImageDecoder *decoder, int32_t format);
+    typedef int (*SetTargetSizeFunc)(AImageDecoder *decoder,
+                                     int32_t width, int32_t height);
+    typedef size_t (*GetMinimumStrideFunc)(AImageDecoder *decoder);
+    typedef int (*DecodeImageFunc)(AImageDecoder *decoder, void *pixels,
+                                   size_t stride, size_t size);
+
+    // is decoder functions loaded
+    bool mIsLoaded;
+    CreateFromBufferFunc mCreateFromBuffer;
+    DeleteFunc mDelete;
+    SetFormatFunc mSetFormat;
+    SetTargetSizeFunc mSetTargetSize;
+    GetMinimumStrideFunc mGetMinimumStride;
+    DecodeImageFunc mDecodeImage;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_IMAGEDECODER_H
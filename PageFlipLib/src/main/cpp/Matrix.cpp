@@ -14,10 +14,67 @@
  * limitations under the License.
  */
 
+#include <string.h>
 #include "Matrix.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PAGEFLIP_MATRIX_NEON
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define PAGEFLIP_MATRIX_SSE
+#endif
+
 namespace eschao {
 
+/**
+ * Multiply two matrices: result = this * rhs
+ * <p>Every column of result is the linear combination of columns of this
+ * matrix with the corresponding column of rhs as weights</p>
+ */
+Mat4 Mat4::operator*(const Mat4 &rhs) const {
+    Mat4 r;
+#if defined(PAGEFLIP_MATRIX_NEON)
+    const float32x4_t c0 = vld1q_f32(m);
+    const float32x4_t c1 = vld1q_f32(m + 4);
+    const float32x4_t c2 = vld1q_f32(m + 8);
+    const float32x4_t c3 = vld1q_f32(m + 12);
+    for (int i = 0; i < 16; i += 4) {
+        float32x4_t c = vmulq_n_f32(c0, rhs.m[i]);
+        c = vmlaq_n_f32(c, c1, rhs.m[i + 1]);
+        c = vmlaq_n_f32(c, c2, rhs.m[i + 2]);
+        c = vmlaq_n_f32(c, c3, rhs.m[i + 3]);
+        vst1q_f32(r.m + i, c);
+    }
+#elif defined(PAGEFLIP_MATRIX_SSE)
+    const __m128 c0 = _mm_load_ps(m);
+    const __m128 c1 = _mm_load_ps(m + 4);
+    const __m128 c2 = _mm_load_ps(m + 8);
+    const __m128 c3 = _mm_load_ps(m + 12);
+    for (int i = 0; i < 16; i += 4) {
+        __m128 c = _mm_mul_ps(c0, _mm_set1_ps(rhs.m[i]));
+        c = _mm_add_ps(c, _mm_mul_ps(c1, _mm_set1_ps(rhs.m[i + 1])));
+        c = _mm_add_ps(c, _mm_mul_ps(c2, _mm_set1_ps(rhs.m[i + 2])));
+        c = _mm_add_ps(c, _mm_mul_ps(c3, _mm_set1_ps(rhs.m[i + 3])));
+        _mm_store_ps(r.m + i, c);
+    }
+#else
+    for (int i = 0; i < 16; i += 4) {
+        for (int j = 0; j < 4; ++j) {
+            r.m[i + j] = m[j] * rhs.m[i] +
+                         m[j + 4] * rhs.m[i + 1] +
+                         m[j + 8] * rhs.m[i + 2] +
+                         m[j + 12] * rhs.m[i + 3];
+        }
+    }
+#endif
+    return r;
+}
+
+bool Mat4::operator==(const Mat4 &rhs) const {
+    return memcmp(m, rhs.m, sizeof(m)) == 0;
+}
+
 #define I(_i, _j) ((_j)+((_i)<<2))
 
 void Matrix::ortho(float *m,
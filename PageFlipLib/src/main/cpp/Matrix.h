@@ -27,6 +27,74 @@ namespace eschao {
     x *= norm; y *= norm; z *= norm; \
 }
 
+/**
+ * 4x4 matrix value type in column-major order, same layout as OpenGL
+ * <p>Constructions are constexpr, that means fixed matrices like the camera
+ * of page flip can be computed at compile time. Multiplication is done with
+ * NEON or SSE if available</p>
+ */
+struct alignas(16) Mat4 {
+    float m[16];
+
+    constexpr Mat4()
+            : m{1, 0, 0, 0,
+                0, 1, 0, 0,
+                0, 0, 1, 0,
+                0, 0, 0, 1} {
+    }
+
+    constexpr Mat4(float m0, float m1, float m2, float m3,
+                   float m4, float m5, float m6, float m7,
+                   float m8, float m9, float m10, float m11,
+                   float m12, float m13, float m14, float m15)
+            : m{m0, m1, m2, m3,
+                m4, m5, m6, m7,
+                m8, m9, m10, m11,
+                m12, m13, m14, m15} {
+    }
+
+    static constexpr Mat4 identity() {
+        return Mat4();
+    }
+
+    static constexpr Mat4 translation(float x, float y, float z) {
+        return Mat4(1, 0, 0, 0,
+                    0, 1, 0, 0,
+                    0, 0, 1, 0,
+                    x, y, z, 1);
+    }
+
+    static constexpr Mat4 scale(float x, float y, float z) {
+        return Mat4(x, 0, 0, 0,
+                    0, y, 0, 0,
+                    0, 0, z, 0,
+                    0, 0, 0, 1);
+    }
+
+    static constexpr Mat4 ortho(float left, float right,
+                                float bottom, float top,
+                                float near, float far) {
+        return Mat4(2.0f / (right - left), 0, 0, 0,
+                    0, 2.0f / (top - bottom), 0, 0,
+                    0, 0, -2.0f / (far - near), 0,
+                    -(right + left) / (right - left),
+                    -(top + bottom) / (top - bottom),
+                    -(far + near) / (far - near), 1);
+    }
+
+    Mat4 operator*(const Mat4 &rhs) const;
+
+    bool operator==(const Mat4 &rhs) const;
+
+    inline bool operator!=(const Mat4 &rhs) const {
+        return !(*this == rhs);
+    }
+
+    inline const float* data() const {
+        return m;
+    }
+};
+
 /**
  * Matrix APIs. Copied from Android Matrix.java
  */
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <time.h>
+#include "MeshDensity.h"
+
+namespace eschao {
+
+// weight of the newest frame interval in smoothed frame time
+static const float kFrameTimeWeight = 0.2f;
+// tolerance scale when frame is over or under budget
+static const float kRelaxToleranceRatio = 1.25f;
+static const float kRestoreToleranceRatio = 0.95f;
+// frame is slow if its time is over budget * kSlowFrameRatio, and it is
+// fast if under budget * kFastFrameRatio. The gap avoids oscillation caused by
+// vsync jitter when frame time is close to budget
+static const float kSlowFrameRatio = 1.25f;
+static const float kFastFrameRatio = 1.05f;
+
+MeshDensity::MeshDensity()
+        : mMode(FIXED_MESH_DENSITY),
+          mBaseTolerance(kDefaultMeshTolerance),
+          mTolerance(kDefaultMeshTolerance),
+          mFrameBudget(kDefaultFrameBudget),
+          mFrameTime(0),
+          mLastFrameTime(0) {
+}
+
+/**
+ * Compute mesh count of a quarter of cylinder with given radius
+ *
+ * @param radius cylinder radius
+ * @param maxCount max mesh count which buffers can hold
+ * @return mesh count
+ */
+int MeshDensity::meshCount(float radius, int maxCount) {
+    int count = maxCount;
+    if (radius > mTolerance) {
+        const double angle = 2 * acos(1 - mTolerance / radius);
+        count = (int)ceil(M_PI_2 / angle);
+    }
+
+    if (count > maxCount) {
+        count = maxCount;
+    }
+
+    return count < kMinAdaptiveMeshCount ? kMinAdaptiveMeshCount : count;
+}
+
+/**
+ * Called at the beginning of every flip frame to measure frame interval and
+ * adjust tolerance
+ */
+void MeshDensity::onFrame() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const double now = ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+    const double last = mLastFrameTime;
+    mLastFrameTime = now;
+
+    const float interval = (float)(now - last);
+    if (last <= 0 || interval > kMaxFrameInterval) {
+        return;
+    }
+
+    mFrameTime = mFrameTime <= 0 ? interval :
+                 mFrameTime + (interval - mFrameTime) * kFrameTimeWeight;
+
+    if (mMode != ADAPTIVE_MESH_DENSITY) {
+        return;
+    }
+
+    if (mFrameTime > mFrameBudget * kSlowFrameRatio) {
+        mTolerance *= kRelaxToleranceRatio;
+        if (mTolerance > kMaxMeshTolerance) {
+            mTolerance = kMaxMeshTolerance;
+        }
+    }
+    else if (mFrameTime < mFrameBudget * kFastFrameRatio &&
+             mTolerance > mBaseTolerance) {
+        mTolerance *= kRestoreToleranceRatio;
+        if (mTolerance < mBaseTolerance) {
+            mTolerance = mBaseTolerance;
+        }
+    }
+}
+
+}
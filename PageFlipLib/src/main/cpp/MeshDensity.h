@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_MESHDENSITY_H
+#define ANDROID_PAGEFLIP_MESHDENSITY_H
+
+#include "Error.h"
+
+namespace eschao {
+
+enum MeshDensityMode {
+    FIXED_MESH_DENSITY = 0,
+    ADAPTIVE_MESH_DENSITY,
+};
+
+// default max distance in pixels between the cylinder and its mesh
+static const float kDefaultMeshTolerance = 0.5f;
+// tolerance can't be relaxed beyond this value when device is slow
+static const float kMaxMeshTolerance = 4.0f;
+// default frame budget (60fps)
+static const float kDefaultFrameBudget = 16.7f;
+// frame interval longer than it is deemed as a pause, not a slow frame
+static const float kMaxFrameInterval = 250.0f;
+// mesh count range of a quarter of cylinder in adaptive mode
+static const int kMinAdaptiveMeshCount = 3;
+
+/**
+ * Mesh density policy of fold page
+ * <p>In fixed mode, mesh count is computed from pixels of mesh by PageFlip.
+ * In adaptive mode, mesh count of a quarter of cylinder is computed from its
+ * radius to make sure the max distance(sagitta) between the arc and the mesh
+ * chord is not larger than tolerance:</p>
+ * <pre>
+ *     angle of segment: A = 2 * acos(1 - tolerance / R)
+ *     mesh count: N = ceil((PI / 2) / A)
+ * </pre>
+ * <p>Vertex density on screen is about 1/sqrt(R), so a tight curl gets
+ * more vertices per pixel and flat part of page only uses its apexes.</p>
+ * <p>The interval between flip frames is also tracked, if it exceeds frame
+ * budget, tolerance is relaxed step by step to lower the density, and it is
+ * restored when device keeps up again.</p>
+ */
+class MeshDensity {
+
+public:
+    MeshDensity();
+
+    int meshCount(float radius, int maxCount);
+    void onFrame();
+
+    inline MeshDensityMode mode() {
+        return mMode;
+    }
+
+    inline bool isAdaptive() {
+        return mMode == ADAPTIVE_MESH_DENSITY;
+    }
+
+    inline int setMode(int mode) {
+        if (mode != FIXED_MESH_DENSITY && mode != ADAPTIVE_MESH_DENSITY) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
+
+        mMode = (MeshDensityMode)mode;
+        mTolerance = mBaseTolerance;
+        resetFrameClock();
+        return Error::OK;
+    }
+
+    inline int setTolerance(float tolerance) {
+        if (tolerance <= 0 || tolerance > kMaxMeshTolerance) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
+
+        mBaseTolerance = tolerance;
+        mTolerance = tolerance;
+        return Error::OK;
+    }
+
+    inline int setFrameBudget(float ms) {
+        if (ms <= 0 || ms >= kMaxFrameInterval) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
+
+        mFrameBudget = ms;
+        return Error::OK;
+    }
+
+    inline float tolerance() {
+        return mTolerance;
+    }
+
+    inline float frameBudget() {
+        return mFrameBudget;
+    }
+
+    inline float frameTime() {
+        return mFrameTime;
+    }
+
+    inline void resetFrameClock() {
+        mLastFrameTime = 0;
+    }
+
+private:
+    MeshDensityMode mMode;
+    // tolerance set by user
+    float mBaseTolerance;
+    // tolerance currently used, relaxed when frame is slow
+    float mTolerance;
+    float mFrameBudget;
+    // smoothed frame interval in milliseconds
+    float mFrameTime;
+    // timestamp of last frame in milliseconds, 0 means no last frame
+    double mLastFrameTime;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_MESHDENSITY_H
@@ -51,30 +51,44 @@ void Textures::swapTexturesWith(Textures &rhs) {
 int Textures::setTexture(int index, AndroidBitmapInfo &info, GLvoid *data) {
     mTextures[index].setMaskColor(computeAverageColor(info, data, 30));
 
-    GLint format;
-    GLenum type;
-    if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
-        format = GL_RGB;
-        type = GL_UNSIGNED_SHORT_5_6_5;
-    }
-    else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
-        format = GL_RGBA;
-        type = GL_UNSIGNED_BYTE;
-    }
-    else {
+    GLuint id = mBackend->createTexture(info, data);
+    if (id == 0) {
         return Error::ERR_UNSUPPORT_BITMAP_FORMAT;
     }
 
+    mTextures[index].texId = id;
+    mTextures[index].isSet = true;
+    mTextures[index].image = NULL;
+    mTextures[index].importer = NULL;
+    return Error::OK;
+}
+
+/**
+ * Set texture with native buffer, the buffer is imported by importer without
+ * copying pixels
+ * <p>Pixels of buffer can't be read by CPU, the mask color of back of fold is
+ * given by caller instead of computing average color</p>
+ *
+ * @param index texture slot
+ * @param importer importer for native buffer
+ * @param buffer native buffer, e.g. AHardwareBuffer
+ * @param maskColor mask color of texture
+ * @return Error::OK if successfully
+ */
+int Textures::setTexture(int index, TextureImporter &importer, void *buffer,
+                         int maskColor) {
     GLuint id;
-    glGenTextures(1, &id);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, id);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, info.width, info.height, 0, format,
-                 type, data);
+    void *image = NULL;
+    int ret = importer.import(buffer, id, image);
+    if (ret != Error::OK) {
+        return ret;
+    }
+
+    mTextures[index].setMaskColor(maskColor);
     mTextures[index].texId = id;
     mTextures[index].isSet = true;
+    mTextures[index].image = image;
+    mTextures[index].importer = &importer;
     return Error::OK;
 }
 
@@ -167,40 +181,65 @@ void Page::invertYOfOriginP() {
     computeIndexOfApexOrder();
 }
 
-void Page::drawFrontPage(VertexProgram &program, Vertexes &vertexes) {
+void Page::drawFrontPage(RenderBackend &backend, Vertexes &vertexes) {
     // 1. draw unfold part and curled part with the first texture
-    glUniformMatrix4fv(program.mvpMatrixLoc(), 1, GL_FALSE,
-                       VertexProgram::MVPMatrix);
-    glBindTexture(GL_TEXTURE_2D, textures.mTextures[FIRST_TEXTURE_ID].texId);
-    glUniform1i(program.textureLoc(), 0);
-    vertexes.drawWith(GL_TRIANGLE_STRIP,
-                      program.vertexPosLoc(), program.texCoordLoc(),
-                      0, mFrontVertexCount);
+    drawFrontPageOfFirstTexture(backend, vertexes);
 
     // 2. draw the second texture
-    glBindTexture(GL_TEXTURE_2D, textures.mTextures[SECOND_TEXTURE_ID].texId);
-    glUniform1i(program.textureLoc(), 0);
-    glDrawArrays(GL_TRIANGLE_STRIP, mFrontVertexCount,
-                 vertexes.count() - mFrontVertexCount);
+    drawFrontPageOfSecondTexture(backend, vertexes);
 }
 
-void Page::drawFullPage(VertexProgram &program, GLuint textureId) {
-    glBindTexture(GL_TEXTURE_2D, textureId);
-    glUniform1i(program.textureLoc(), 0);
+void Page::drawFrontPageOfFirstTexture(RenderBackend &backend,
+                                       Vertexes &vertexes) {
+    drawFrontPagePart(backend, vertexes, true,
+                      textures.mTextures[FIRST_TEXTURE_ID].texId);
+}
 
-    glVertexAttribPointer(program.vertexPosLoc(), 3, GL_FLOAT, GL_FALSE, 0,
-                          mApexes);
-    glEnableVertexAttribArray(program.vertexPosLoc());
+void Page::drawFrontPageOfSecondTexture(RenderBackend &backend,
+                                        Vertexes &vertexes) {
+    drawFrontPagePart(backend, vertexes, false,
+                      textures.mTextures[SECOND_TEXTURE_ID].texId);
+}
+
+/**
+ * Draw the first part (unfold part and front of fold) or the second part
+ * (the area revealed by fold) of front vertexes with given texture
+ */
+void Page::drawFrontPagePart(RenderBackend &backend, Vertexes &vertexes,
+                             bool isFirstPart, GLuint textureId) {
+    const int offset = isFirstPart ? 0 : mFrontVertexCount;
+    const int count = isFirstPart ? mFrontVertexCount
+                                  : vertexes.count() - mFrontVertexCount;
+    backend.drawPage(TRIANGLE_STRIP,
+                     vertexes.vertexes(), vertexes.sizeOfPerVex(),
+                     vertexes.texCoords(), offset, count, textureId);
+}
 
-    glVertexAttribPointer(program.texCoordLoc(), 2, GL_FLOAT, GL_FALSE, 0,
-                          mApexTexCoords);
-    glEnableVertexAttribArray(program.texCoordLoc());
+/**
+ * Draw flat part of page as a quad clipped by fold line, the first and
+ * second texture parts are picked in fragment shading instead of splitting
+ * page polygon. The quad is at the z of the second texture part, the base
+ * shadow is only cast on the side of second texture and still covers it
+ */
+void Page::drawFoldClippedPage(RenderBackend &backend,
+                               const float *foldLine) {
+    backend.drawFoldClippedPage(mApexes, mApexTexCoords, foldLine, -1,
+                                textures.mTextures[FIRST_TEXTURE_ID].texId,
+                                textures.mTextures[SECOND_TEXTURE_ID].texId);
+}
 
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+void Page::drawFullPage(RenderBackend &backend, GLuint textureId) {
+    backend.drawPage(TRIANGLE_FAN, mApexes, 3, mApexTexCoords, 0, 4,
+                     textureId);
 }
 
-void Page::buildVertexesOfPageWhenVertical(Vertexes &frontVertexes,
-                                           PointF &xFoldP1) {
+/**
+ * Build front vertexes of page when page flip is vertical
+ *
+ * @return vertex count of the first texture part
+ */
+int Page::buildVertexesOfPageWhenVertical(Vertexes &frontVertexes,
+                                          PointF &xFoldP1) {
     // if xFoldX and yFoldY are both outside the page, use the last vertex
     // order to draw page
     int index = 4;
@@ -236,7 +275,7 @@ void Page::buildVertexesOfPageWhenVertical(Vertexes &frontVertexes,
     }
 
     // the vertex size for drawing front of fold page and first texture
-    mFrontVertexCount = frontVertexes.count();
+    const int frontVertexCount = frontVertexes.count();
 
     // if xFoldX and yFoldY are in the page, need add them for drawing the
     // second texture
@@ -254,12 +293,19 @@ void Page::buildVertexesOfPageWhenVertical(Vertexes &frontVertexes,
                                  mApexTexCoords[n],
                                  mApexTexCoords[n + 1]);
     }
+
+    return frontVertexCount;
 }
 
-void Page::buildVertexesOfPageWhenSlope(Vertexes &frontVertexes,
-                                        PointF &xFoldP1,
-                                        PointF &yFoldP1,
-                                        float kValue) {
+/**
+ * Build front vertexes of page when page flip is slope
+ *
+ * @return vertex count of the first texture part
+ */
+int Page::buildVertexesOfPageWhenSlope(Vertexes &frontVertexes,
+                                       PointF &xFoldP1,
+                                       PointF &yFoldP1,
+                                       float kValue) {
     // compute xFoldX point
     float half_h = mHeight * 0.5f;
     int index = 0;
@@ -309,7 +355,7 @@ void Page::buildVertexesOfPageWhenSlope(Vertexes &frontVertexes,
     }
 
     // the vertex size for drawing front of fold page and first texture
-    mFrontVertexCount = frontVertexes.count();
+    const int frontVertexCount = frontVertexes.count();
 
     // if xFoldX and yFoldY are in the page, need add them for drawing the
     // second texture
@@ -327,6 +373,8 @@ void Page::buildVertexesOfPageWhenSlope(Vertexes &frontVertexes,
                                  mApexTexCoords[n],
                                  mApexTexCoords[n + 1]);
     }
+
+    return frontVertexCount;
 }
 
 void Page::buildVertexesOfFullPage() {
@@ -21,11 +21,13 @@
 #include <string.h>
 #include <android/bitmap.h>
 #include "GLPoint.h"
-#include "VertexProgram.h"
+#include "RenderBackend.h"
 #include "Vertexes.h"
+#include "Vec4.h"
 #include "PointF.h"
 #include "Error.h"
 #include "Utility.h"
+#include "TextureImporter.h"
 
 #define FIRST_TEXTURE_ID    0
 #define SECOND_TEXTURE_ID   1
@@ -40,13 +42,20 @@ struct Texture_ {
     GLuint texId;
     bool isSet;
     float maskColor[3];
+    // image bound to texture if it is imported from native buffer
+    void *image;
+    TextureImporter *importer;
 
-    Texture_() : texId(0), isSet(false), maskColor{0} { }
-    Texture_(GLuint tId, bool set) : texId(tId), isSet(set), maskColor{0} { }
+    Texture_() : texId(0), isSet(false), maskColor{0},
+                 image(NULL), importer(NULL) { }
+    Texture_(GLuint tId, bool set) : texId(tId), isSet(set), maskColor{0},
+                                     image(NULL), importer(NULL) { }
 
     Texture_& operator=(const Texture_& rhs) {
         texId = rhs.texId;
         isSet = rhs.isSet;
+        image = rhs.image;
+        importer = rhs.importer;
         maskColor[0] = rhs.maskColor[0];
         maskColor[1] = rhs.maskColor[1];
         maskColor[2] = rhs.maskColor[2];
@@ -58,17 +67,33 @@ struct Texture_ {
         maskColor[1] = GREEN(color) / 255.0f;
         maskColor[2] = BLUE(color) / 255.0f;
     }
+
+    inline void releaseImage() {
+        if (image && importer) {
+            importer->release(image);
+        }
+
+        image = NULL;
+        importer = NULL;
+    }
 };
 
 struct TexRecycler_ {
     GLuint texIds[TEXTURE_SIZE << 1];
+    Texture_ images[TEXTURE_SIZE << 1];
     int size;
+    int imageSize;
 
-    TexRecycler_() : size(0) { }
+    TexRecycler_() : size(0), imageSize(0) { }
+
+    inline void recycle(RenderBackend *backend) {
+        for (int i = 0; i < imageSize; ++i) {
+            images[i].releaseImage();
+        }
+        imageSize = 0;
 
-    inline void recycle() {
         if (size > 0) {
-            glDeleteTextures(size, texIds);
+            backend->deleteTextures(size, texIds);
             size = 0;
         }
     }
@@ -76,6 +101,9 @@ struct TexRecycler_ {
     inline void add(Texture_& tex) {
         if (tex.isSet) {
             texIds[size++] = tex.texId;
+            if (tex.image) {
+                images[imageSize++] = tex;
+            }
             tex.isSet = false;
         }
     }
@@ -86,11 +114,20 @@ struct TexRecycler_ {
  */
 class Textures {
 public:
+    Textures() : mBackend(NULL) { }
 
     void setFirstTextureWithSecond();
     void setSecondTextureWithFirst();
     void swapTexturesWith(Textures &rhs);
 
+    inline GLuint firstTextureId() {
+        return mTextures[FIRST_TEXTURE_ID].texId;
+    }
+
+    inline GLuint secondTextureId() {
+        return mTextures[SECOND_TEXTURE_ID].texId;
+    }
+
     inline GLuint backTextureId() {
         return mTextures[BACK_TEXTURE_ID].isSet ?
                mTextures[BACK_TEXTURE_ID].texId :
@@ -109,18 +146,27 @@ public:
         return mTextures[BACK_TEXTURE_ID].isSet;
     }
 
+    inline bool isSet(int index) {
+        return mTextures[index].isSet;
+    }
+
     inline float* getMaskColorOfFirstTexture() {
         return mTextures[FIRST_TEXTURE_ID].maskColor;
     }
 
+    inline void setBackend(RenderBackend *backend) {
+        mBackend = backend;
+    }
+
     inline void recycle() {
-        mRecycler.recycle();
+        mRecycler.recycle(mBackend);
     }
 
     inline void recycleAll() {
         for (int i = 0; i < TEXTURE_SIZE; ++i) {
             if (mTextures[i].isSet) {
-                glDeleteTextures(1, &mTextures[i].texId);
+                mTextures[i].releaseImage();
+                mBackend->deleteTextures(1, &mTextures[i].texId);
                 mTextures[i].isSet = false;
             }
         }
@@ -144,12 +190,37 @@ public:
         return setTexture(BACK_TEXTURE_ID, info, data);
     }
 
+    inline int setFirstTexture(TextureImporter &importer, void *buffer,
+                               int maskColor) {
+        return setTexture(FIRST_TEXTURE_ID, importer, buffer, maskColor);
+    }
+
+    inline int setSecondTexture(TextureImporter &importer, void *buffer,
+                                int maskColor) {
+        return setTexture(SECOND_TEXTURE_ID, importer, buffer, maskColor);
+    }
+
+    inline int setBackTexture(TextureImporter &importer, void *buffer,
+                              int maskColor) {
+        if (buffer == NULL) {
+            // recycle back texture
+            mRecycler.add(mTextures[BACK_TEXTURE_ID]);
+            return Error::OK;
+        }
+
+        return setTexture(BACK_TEXTURE_ID, importer, buffer, maskColor);
+    }
+
 private:
     int setTexture(int index, AndroidBitmapInfo &info, GLvoid *data);
+    int setTexture(int index, TextureImporter &importer, void *buffer,
+                   int maskColor);
 
 private:
     Texture_ mTextures[TEXTURE_SIZE];
     TexRecycler_ mRecycler;
+    // backend which creates and deletes textures
+    RenderBackend *mBackend;
 
     friend class Page;
 };
@@ -166,13 +237,20 @@ public:
     void init(float left, float right, float top, float bottom);
     void setOriginDiagonalPoints(bool hasSecondPage, bool isTopArea);
     void invertYOfOriginP();
-    void drawFrontPage(VertexProgram &program, Vertexes &vertexes);
-    void buildVertexesOfPageWhenVertical(Vertexes& frontVertexes,
-                                         PointF& xFoldP1);
-    void buildVertexesOfPageWhenSlope(Vertexes& frontVertexes,
-                                      PointF& xFoldP1,
-                                      PointF& yFoldP1,
-                                      float kValue);
+    void drawFrontPage(RenderBackend &backend, Vertexes &vertexes);
+    void drawFrontPageOfFirstTexture(RenderBackend &backend,
+                                     Vertexes &vertexes);
+    void drawFrontPageOfSecondTexture(RenderBackend &backend,
+                                      Vertexes &vertexes);
+    void drawFrontPagePart(RenderBackend &backend, Vertexes &vertexes,
+                           bool isFirstPart, GLuint textureId);
+    void drawFoldClippedPage(RenderBackend &backend, const float *foldLine);
+    int buildVertexesOfPageWhenVertical(Vertexes& frontVertexes,
+                                        PointF& xFoldP1);
+    int buildVertexesOfPageWhenSlope(Vertexes& frontVertexes,
+                                     PointF& xFoldP1,
+                                     PointF& yFoldP1,
+                                     float kValue);
     void buildVertexesOfFullPage();
 
     inline float width() {
@@ -183,6 +261,22 @@ public:
         return mHeight;
     }
 
+    inline float left() {
+        return mLeft;
+    }
+
+    inline float right() {
+        return mRight;
+    }
+
+    inline float top() {
+        return mTop;
+    }
+
+    inline float bottom() {
+        return mBottom;
+    }
+
     inline bool isLeftPage() {
         return mRight <= 0;
     }
@@ -215,15 +309,33 @@ public:
         return (mTop - y) / mTexHeight;
     }
 
-    inline void drawFullPage(VertexProgram &program, bool isFirst) {
+    /**
+     * Compute texture x of 4 points at a time
+     */
+    inline void textureX(const Vec4 &x, float *texX) {
+        ((x - Vec4(mLeft)) / Vec4(mTexWidth)).store(texX);
+    }
+
+    /**
+     * Compute texture x of 2 points and texture y of 2 points at a time
+     *
+     * @param tex texture x of x0, x1 and texture y of y0, y1
+     */
+    inline void textureXY(float x0, float x1, float y0, float y1,
+                          float *tex) {
+        ((Vec4(x0, x1, mTop, mTop) - Vec4(mLeft, mLeft, y0, y1)) /
+         Vec4(mTexWidth, mTexWidth, mTexHeight, mTexHeight)).store(tex);
+    }
+
+    inline void drawFullPage(RenderBackend &backend, bool isFirst) {
         isFirst ?
-        drawFullPage(program, textures.mTextures[FIRST_TEXTURE_ID].texId) :
-        drawFullPage(program, textures.mTextures[SECOND_TEXTURE_ID].texId);
+        drawFullPage(backend, textures.mTextures[FIRST_TEXTURE_ID].texId) :
+        drawFullPage(backend, textures.mTextures[SECOND_TEXTURE_ID].texId);
     }
 
 private:
     void computeIndexOfApexOrder();
-    void drawFullPage(VertexProgram &program, GLuint textureId);
+    void drawFullPage(RenderBackend &backend, GLuint textureId);
 
 public:
     Textures textures;
@@ -330,7 +442,8 @@ private:
     float mApexes[12];
     // texture coordinates for page apex
     float mApexTexCoords[8];
-    // vertex size of front of fold page and unfold page
+    // vertex size of front of fold page and unfold page, it is set by
+    // PageFlip with the meshes being drawn
     int mFrontVertexCount;
     // index of apex order array for current original point
     int mApexOrderIndex;
@@ -15,6 +15,8 @@
  */
 
 #include <math.h>
+#include <string.h>
+#include <float.h>
 #include <GLES2/gl2.h>
 #include <algorithm>
 #include "Page.h"
@@ -24,31 +26,150 @@ namespace eschao {
 
 static auto TAG = "PageFlip";
 
+// camera is fixed: eye is (0, 0, kCameraEyeZ) and looks at origin with
+// up vector (0, 1, 0), it is just a translation on Z axis
+static constexpr Mat4 kViewMatrix = Mat4::translation(0, 0, -kCameraEyeZ);
+
 PageFlip::PageFlip()
-        : mFlipState(END_FLIP),
-          mIsVertical(false),
-          mPixelsOfMesh(kMeshVertexPixels),
+        : mPixelsOfMesh(kMeshVertexPixels),
           mSemiPerimeterRatio(0.8f),
-          mIsClickToFlip(true),
-          mWidthRatioOfClickToFlip(kWidthRatioOfClickToFlip),
-          mPageMode(SINGLE_PAGE_MODE),
+          mMeshCount(0),
+          mMaxMeshCount(0),
           mFoldEdgeShadowWidth(5, 30, 0.25f),
           mFoldBaseShadowWidth(2, 40, 0.4f),
-          mFoldEdgeShadowVertexes(kFoldTopEdgeShadowVexCount,
-                                  kFoldEdgeShadowStartColor,
-                                  kFoldEdgeShadowStartAlpha,
-                                  kFoldEdgeShadowEndColor,
-                                  kFoldEdgeShadowEndAlpha),
-          mFoldBaseShadowVertexes(0,
-                                  kFoldBaseShadowStartColor,
-                                  kFoldBaseShadowStartAlpha,
-                                  kFoldBaseShadowEndColor,
-                                  kFoldBaseShadowEndAlpha) {
+          mComputing(&mMeshes[0]),
+          mDrawing(&mMeshes[0]),
+          mIsAnalyticShadow(false),
+          mIsFoldClip(false),
+          mBlendCoverage(0),
+          mHasPendingMeshes(false),
+          mSlopeKernels(kSlopeStepKernels[1]),
+          mAnimationKeyframes(0),
+          mKeyframeTick(0),
+          mTrack(-1),
+          mKeyframe(-1),
+          mBackend(&mGLBackend),
+          mBackendType(GLES2_RENDER_BACKEND),
+          mIsDepthFree(false),
+          mIsSinglePass(false),
+          mIsGPUDeform(false),
+          mBurstPages(1),
+          mBurstStagger(kBurstStagger),
+          mBurstingPages(1),
+          mBurstedPages(1),
+          mBurstMeshCount(0),
+          mHasBurstTop(false),
+          mIsVertical(false),
+          mFlipState(END_FLIP),
+          mPageMode(SINGLE_PAGE_MODE),
+          mIsClickToFlip(true),
+          mWidthRatioOfClickToFlip(kWidthRatioOfClickToFlip) {
     mPages[FIRST_PAGE] = NULL;
     mPages[SECOND_PAGE] = NULL;
 }
 
+PageFlip::FlipMeshes_::FlipMeshes_()
+        : edgeShadow(kFoldTopEdgeShadowVexCount,
+                     kFoldEdgeShadowStartColor,
+                     kFoldEdgeShadowStartAlpha,
+                     kFoldEdgeShadowEndColor,
+                     kFoldEdgeShadowEndAlpha),
+          baseShadow(0,
+                     kFoldBaseShadowStartColor,
+                     kFoldBaseShadowStartAlpha,
+                     kFoldBaseShadowEndColor,
+                     kFoldBaseShadowEndAlpha),
+          frontVertexCount(0),
+          hasShadowMesh(true),
+          hasFoldClip(false) {
+    foldLine[0] = foldLine[1] = foldLine[2] = 0;
+    foldBounds[0] = foldBounds[1] = 1;
+    foldBounds[2] = foldBounds[3] = 0;
+}
+
+/**
+ * Set buffers of meshes from arena
+ *
+ * @param meshCount mesh count of fold strips and shadows
+ * @param frontCapacity vertex capacity of fold front
+ * @return Error::OK if successfully
+ */
+int PageFlip::FlipMeshes_::set(VertexArena &arena, int meshCount,
+                               int frontCapacity) {
+    if (backOfFold.set(arena, meshCount) != Error::OK ||
+        foldFront.set(arena, frontCapacity, 3, true) != Error::OK ||
+        edgeShadow.set(arena, meshCount) != Error::OK ||
+        baseShadow.set(arena, meshCount) != Error::OK) {
+        return gError.code();
+    }
+
+    return Error::OK;
+}
+
+/**
+ * Copy meshes of src, shadow colors and mask alpha are settings and they
+ * aren't copied
+ *
+ * @return Error::OK if successfully
+ */
+int PageFlip::FlipMeshes_::copy(const FlipMeshes_ &src) {
+    if (foldFront.copy(src.foldFront) != Error::OK ||
+        backOfFold.copy(src.backOfFold) != Error::OK ||
+        edgeShadow.copy(src.edgeShadow) != Error::OK ||
+        baseShadow.copy(src.baseShadow) != Error::OK) {
+        return gError.code();
+    }
+
+    frontVertexCount = src.frontVertexCount;
+    hasShadowMesh = src.hasShadowMesh;
+    foldShadow = src.foldShadow;
+    hasFoldClip = src.hasFoldClip;
+    memcpy(foldLine, src.foldLine, sizeof(foldLine));
+    memcpy(foldBounds, src.foldBounds, sizeof(foldBounds));
+    return Error::OK;
+}
+
+PageFlip::KeyframeTrack_::KeyframeTrack_()
+        : flipState(END_FLIP),
+          hasSecondPage(false),
+          kValue(0),
+          lastTick(0),
+          frames(NULL),
+          frameCount(0) {
+}
+
+PageFlip::KeyframeTrack_::~KeyframeTrack_() {
+    delete[] frames;
+}
+
+/**
+ * Allocate meshes of keyframes, buffers of them are set by caller
+ *
+ * @param count keyframe count, 0 releases meshes
+ */
+void PageFlip::KeyframeTrack_::allocate(int count) {
+    if (count != frameCount) {
+        delete[] frames;
+        frames = count > 0 ? new FlipMeshes_[count] : NULL;
+        frameCount = count;
+    }
+
+    isRecorded.assign(count, false);
+    lastTick = 0;
+}
+
+/**
+ * Forget recorded keyframes, meshes are kept for the next animation
+ */
+void PageFlip::KeyframeTrack_::clear() {
+    isRecorded.assign(frameCount, false);
+    lastTick = 0;
+}
+
 PageFlip::~PageFlip() {
+    // worker must not touch meshes which are being destroyed
+    mGeometryWorker.stop();
+
     if (mPages[FIRST_PAGE]) {
         delete mPages[FIRST_PAGE];
     }
@@ -76,37 +197,52 @@ bool PageFlip::enableAutoPage(bool isAuto) {
 }
 
 int PageFlip::onSurfaceCreated() {
-    glClearColor(0, 0, 0, 1);
-    glClearDepthf(1.0f);
-    glEnable(GL_DEPTH_TEST);
-
     mFlipState = END_FLIP;
     mIsVertical = false;
+    mFoldDeformVertexes.invalidate();
 
-    if (mVertexProg.init() != Error::OK ||
-        mShadowVertexProg.init() != Error::OK ||
-        mBackOfFoldVertexProg.init() != Error::OK) {
-        mVertexProg.clean();
-        mShadowVertexProg.clean();
-        mBackOfFoldVertexProg.clean();
-        return gError.code();
+    // apply requested built-in backend, the one set by setRenderBackend()
+    // is kept
+    if (mBackend == &mGLBackend || mBackend == &mGLES3Backend) {
+        if (mBackendType == GLES3_RENDER_BACKEND) {
+            mBackend = &mGLES3Backend;
+        }
+        else {
+            mBackend = &mGLBackend;
+        }
     }
 
-    return Error::OK;
+    int ret = mBackend->init();
+    if (ret == Error::ERR_UNSUPPORT_GLES3 && mBackend == &mGLES3Backend) {
+        LOGE(TAG, "Fall back to GLES2 backend");
+        mBackend = &mGLBackend;
+        ret = mBackend->init();
+    }
+
+    return ret;
 }
 
 void PageFlip::onSurfaceChanged(int width, int height) {
     mViewRect.set(width, height);
-    glViewport(0, 0, width, height);
-    mVertexProg.initMatrix(-mViewRect.halfWidth,
-                           mViewRect.halfWidth,
-                           -mViewRect.halfHeight,
-                           mViewRect.halfHeight);
+    updateMVPMatrix();
     computeMaxMeshCount();
     createPages();
 }
 
+/**
+ * Compute MVP matrix with current view size and set it to backend together
+ * with viewport
+ */
+void PageFlip::updateMVPMatrix() {
+    const Mat4 mvp = Mat4::ortho(-mViewRect.halfWidth, mViewRect.halfWidth,
+                                 -mViewRect.halfHeight, mViewRect.halfHeight,
+                                 0, kCameraFarZ) * kViewMatrix;
+    mBackend->setViewport((int)mViewRect.surfaceWidth,
+                          (int)mViewRect.surfaceHeight, mvp);
+}
+
 void PageFlip::createPages() {
+    mGeometryWorker.wait();
     if (mPages[FIRST_PAGE]) {
         mPages[FIRST_PAGE]->textures.recycleAll();
         delete mPages[FIRST_PAGE];
@@ -119,20 +255,75 @@ void PageFlip::createPages() {
         mPages[SECOND_PAGE] = NULL;
     }
 
+    mPages[FIRST_PAGE] = new Page();
     if (mPageMode == AUTO_PAGE_MODE &&
         mViewRect.surfaceWidth > mViewRect.surfaceHeight) {
-        mPages[FIRST_PAGE] = new Page(mViewRect.left, 0, mViewRect.top,
-                                      mViewRect.bottom);
-        mPages[SECOND_PAGE] = new Page(0, mViewRect.right, mViewRect.top,
-                                       mViewRect.bottom);
+        mPages[SECOND_PAGE] = new Page();
+    }
+
+    layoutPages();
+    mPages[FIRST_PAGE]->textures.setBackend(mBackend);
+    if (mPages[SECOND_PAGE]) {
+        mPages[SECOND_PAGE]->textures.setBackend(mBackend);
+    }
+}
+
+/**
+ * Set bounds of pages, the outer edges are inset by the thickness of page
+ * stack, textures of pages are kept
+ */
+void PageFlip::layoutPages() {
+    clearKeyframes();
+
+    const float inset = mPageStack.thickness();
+    const float top = mViewRect.top;
+    const float bottom = mViewRect.bottom;
+    const float right = mViewRect.right - inset;
+    float left = mViewRect.left;
+
+    if (mPages[SECOND_PAGE]) {
+        left += inset;
+        mPages[FIRST_PAGE]->init(left, 0, top, bottom);
+        mPages[SECOND_PAGE]->init(0, right, top, bottom);
     }
     else {
-        mPages[FIRST_PAGE] = new Page(mViewRect.left, mViewRect.right,
-                                      mViewRect.top, mViewRect.bottom);
+        mPages[FIRST_PAGE]->init(left, right, top, bottom);
     }
+
+    mPageStack.setBounds(left, right, top, bottom,
+                         mPages[SECOND_PAGE] != NULL);
+}
+
+/**
+ * Set page stack, pages are resized immediately if surface is ready
+ *
+ * @param maxLayers max layers on one side, 0 means disabling page stack
+ * @param layerWidth width of one layer in pixels
+ * @return Error::OK if successfully
+ */
+int PageFlip::setPageStack(int maxLayers, float layerWidth) {
+    if (!isEndedFlip()) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    const int ret = mPageStack.set(maxLayers, layerWidth);
+    if (ret == Error::OK && mPages[FIRST_PAGE]) {
+        mGeometryWorker.wait();
+        layoutPages();
+    }
+
+    return ret;
 }
 
 bool PageFlip::onFingerDown(float x, float y) {
+    // a new flip starts a new pipeline
+    mGeometryWorker.wait();
+    mHasPendingMeshes = false;
+    mTrack = -1;
+    mKeyframe = -1;
+    // a burst is only for the gesture which starts it
+    mBurstingPages = 1;
+
     x = mViewRect.toOpenGLX(x);
     y = mViewRect.toOpenGLY(y);
 
@@ -157,6 +348,9 @@ bool PageFlip::onFingerDown(float x, float y) {
 
 bool PageFlip::onFingerMove(float x, float y, bool canForward, bool canBackward)
 {
+    // key vertexes are being changed
+    mGeometryWorker.wait();
+
     x = mViewRect.toOpenGLX(x);
     y = mViewRect.toOpenGLY(y);
 
@@ -275,6 +469,8 @@ bool PageFlip::onFingerMove(float x, float y, bool canForward, bool canBackward)
 
 bool PageFlip::onFingerUp(float x, float y, int duration,
                           bool canForward, bool canBackward) {
+    mGeometryWorker.wait();
+
     x = mViewRect.toOpenGLX(x);
     y = mViewRect.toOpenGLY(y);
 
@@ -328,8 +524,16 @@ bool PageFlip::onFingerUp(float x, float y, int duration,
     if (mFlipState == FORWARD_FLIP ||
         mFlipState == BACKWARD_FLIP ||
         mFlipState == RESTORE_FLIP) {
+        // burst flip is only for forward flipping in single page mode
+        mBurstingPages = (mFlipState == FORWARD_FLIP &&
+                          mPages[SECOND_PAGE] == NULL) ? mBurstPages : 1;
+        mBurstedPages = mBurstingPages;
         mScroller.startScroll(start.x, start.y, end.x - start.x,
                               end.y - start.y, duration);
+        selectKeyframeTrack(start, end);
+        if (mBurstingPages > 1) {
+            computeBurstPages();
+        }
         return true;
     }
 
@@ -406,6 +610,21 @@ void PageFlip::computeScrollPointsForClickingFlip(float x,
  * @return true animating is continue or it is stopped
  */
 bool PageFlip::animating() {
+    mGeometryWorker.wait();
+
+    // pages of burst flip follow scroller with their own phases
+    if (mBurstingPages > 1) {
+        const bool isAnimating = !mScroller.isFinished();
+        if (isAnimating) {
+            mScroller.computeScrollOffset();
+            computeBurstPages();
+        }
+        else {
+            abortAnimating();
+        }
+        return isAnimating;
+    }
+
     Page& page = *mPages[FIRST_PAGE];
     const GLPoint& originP = page.mOriginP;
     const GLPoint& diagonalP = page.mDiagonalP;
@@ -416,6 +635,9 @@ bool PageFlip::animating() {
         // get new (x, y)
         mScroller.computeScrollOffset();
         mTouchP.set(mScroller.currX(), mScroller.currY());
+        if (mTrack >= 0) {
+            snapToKeyframe();
+        }
 
         // for mBackward and restore flip, compute x to check if it can
         // continue to flip
@@ -485,11 +707,8 @@ bool PageFlip::animating() {
         abortAnimating();
     }
     // continue animation and compute mVertexes
-    else if (mIsVertical) {
-        computeVertexesWhenVertical();
-    }
     else {
-        computeVertexesWhenSlope();
+        computeVertexes();
     }
 
     return isAnimating;
@@ -499,6 +718,11 @@ bool PageFlip::animating() {
  * Abort animating
  */
 void PageFlip::abortAnimating() {
+    mGeometryWorker.wait();
+    mHasPendingMeshes = false;
+    mTrack = -1;
+    mKeyframe = -1;
+
     mScroller.abortAnimation();
     if (mFlipState == FORWARD_FLIP) {
         mFlipState = END_WITH_FORWARD;
@@ -515,53 +739,623 @@ void PageFlip::abortAnimating() {
  * Draw flipping frame
  */
 void PageFlip::drawFlipFrame() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    mMeshDensity.onFrame();
+    mBlendCoverage = 0;
+
+    if (mBurstingPages > 1) {
+        drawBurstFrame();
+        return;
+    }
+
+    if (isGPUDeforming()) {
+        drawFlipFrameWithGPUDeform();
+        return;
+    }
+
+    // single pass drawing needs shadow meshes and split page polygons
+    if (mIsSinglePass && mBackend == &mGLBackend && mDrawing->hasShadowMesh &&
+        !mDrawing->hasFoldClip) {
+        drawFlipFrameInSinglePass();
+        return;
+    }
+
+    if (mIsDepthFree) {
+        drawFlipFrameInPainterOrder();
+        return;
+    }
+
+    RenderBackend &backend = *mBackend;
+    backend.beginFrame(true);
+    backend.setFoldShadow(mDrawing->hasShadowMesh ? NULL
+                                                   : &mDrawing->foldShadow);
+
+    // 1. draw back of fold page, front of fold page and unfold page with
+    //    the first texture by one two-sided strip
+    Page &page = *mPages[FIRST_PAGE];
+    mTwoSidedFoldVertexes.build(mDrawing->backOfFold, mDrawing->foldFront,
+                                page.mFrontVertexCount);
+    mTwoSidedFoldVertexes.draw(backend, page,
+                               mPages[SECOND_PAGE] != NULL,
+                               mGradientLightTexId,
+                               mDrawing->backOfFold.maskAlpha());
+
+    // 2. draw the second texture part and the second page, the flat page
+    //    clipped by fold has both textures
+    if (mDrawing->hasFoldClip) {
+        page.drawFoldClippedPage(backend, mDrawing->foldLine);
+    }
+    else {
+        page.drawFrontPageOfSecondTexture(backend, mDrawing->foldFront);
+    }
+    if (mPages[SECOND_PAGE]) {
+        mPages[SECOND_PAGE]->drawFullPage(backend, true);
+    }
+
+    // 3. draw edge and base shadow of fold parts within bounds of fold
+    if (mDrawing->hasShadowMesh) {
+        backend.setBlendScissor(updateBlendScissor());
+        mDrawing->baseShadow.draw(backend);
+        mDrawing->edgeShadow.draw(backend);
+        backend.setBlendScissor(NULL);
+    }
+    backend.setFoldShadow(NULL);
+
+    // 4. draw page stack which is under fold page
+    mPageStack.draw(backend);
+}
+
+/**
+ * Draw flipping frame from back to front without depth test
+ * <p>The drawing order is:</p>
+ * <ol>
+ *     <li>page stack which is outside pages</li>
+ *     <li>page part with the second texture, it is under all others</li>
+ *     <li>base shadow which is cast on the second texture</li>
+ *     <li>the second page if there is</li>
+ *     <li>unfold page and front of fold page with the first texture</li>
+ *     <li>edge shadow which is cast on the front of page</li>
+ *     <li>back of fold page which is always on the top</li>
+ * </ol>
+ */
+void PageFlip::drawFlipFrameInPainterOrder() {
+    RenderBackend &backend = *mBackend;
+    backend.beginFrame(false);
+
+    Page &page = *mPages[FIRST_PAGE];
+
+    // 0. draw page stack
+    mPageStack.draw(backend);
+
+    // 1. draw the second texture part, or the whole flat page clipped by
+    //    fold which is only covered by its front of fold later. Shadows
+    //    are drawn within bounds of fold
+    backend.setFoldShadow(mDrawing->hasShadowMesh ? NULL
+                                                   : &mDrawing->foldShadow);
+    backend.setBlendScissor(mDrawing->hasShadowMesh ? updateBlendScissor()
+                                                     : NULL);
+    if (mDrawing->hasFoldClip) {
+        page.drawFoldClippedPage(backend, mDrawing->foldLine);
+    }
+    else {
+        page.drawFrontPageOfSecondTexture(backend, mDrawing->foldFront);
+    }
 
-    // 1. draw back of fold page
-    glUseProgram(mBackOfFoldVertexProg.programRef());
-    glActiveTexture(GL_TEXTURE0);
-    mBackOfFoldVertexes.draw(mBackOfFoldVertexProg,
-                             *mPages[FIRST_PAGE],
+    // 2. draw base shadow
+    if (mDrawing->hasShadowMesh) {
+        mDrawing->baseShadow.draw(backend);
+    }
+
+    // 3. draw the second page and the first texture part
+    if (mPages[SECOND_PAGE]) {
+        mPages[SECOND_PAGE]->drawFullPage(backend, true);
+    }
+    page.drawFrontPageOfFirstTexture(backend, mDrawing->foldFront);
+
+    // 4. draw edge shadow
+    if (mDrawing->hasShadowMesh) {
+        mDrawing->edgeShadow.draw(backend);
+    }
+    backend.setFoldShadow(NULL);
+    backend.setBlendScissor(NULL);
+
+    // 5. draw back of fold page
+    mDrawing->backOfFold.draw(backend, page,
+                              mPages[SECOND_PAGE] != NULL,
+                              mGradientLightTexId);
+}
+
+/**
+ * Draw flipping frame with one draw call
+ * <p>All parts of frame are gathered into one triangle strip, every vertex
+ * carries its material to select shading in uber shader</p>
+ */
+void PageFlip::drawFlipFrameInSinglePass() {
+    mGLBackend.beginFrame(!mIsDepthFree);
+    mPageStack.draw(mGLBackend);
+
+    Page &page = *mPages[FIRST_PAGE];
+    Page *secondPage = mPages[SECOND_PAGE];
+    buildSinglePassVertexes(page, secondPage);
+
+    mSinglePassVertexes.draw(mGLBackend.singlePassProgram(), page, secondPage,
+                             mDrawing->backOfFold.maskAlpha(),
+                             mGradientLightTexId);
+}
+
+/**
+ * Draw flipping frame with fold deformed in vertex shader
+ * <p>Only uniforms of fold are computed from key points, shadows are
+ * evaluated in fragment shader. Depth test is always needed since the page
+ * grid is drawn twice for the first and the second texture</p>
+ */
+void PageFlip::drawFlipFrameWithGPUDeform() {
+    mGLBackend.beginFrame(true);
+
+    Page &page = *mPages[FIRST_PAGE];
+    updateFoldShadow(mDrawing->foldShadow);
+    mFoldDeformVertexes.draw(mGLBackend.foldDeformProgram(), page,
+                             mPixelsOfMesh, mDrawing->foldShadow,
                              mPages[SECOND_PAGE] != NULL,
+                             mDrawing->backOfFold.maskAlpha(),
                              mGradientLightTexId);
 
-    // 2. draw unfold page and front of fold page
-    glUseProgram(mVertexProg.programRef());
-    glActiveTexture(GL_TEXTURE0);
-    mPages[FIRST_PAGE]->drawFrontPage(mVertexProg, mFoldFrontVertexes);
     if (mPages[SECOND_PAGE]) {
-        mPages[SECOND_PAGE]->drawFullPage(mVertexProg, true);
+        mPages[SECOND_PAGE]->drawFullPage(mGLBackend, true);
+    }
+
+    mPageStack.draw(mGLBackend);
+}
+
+/**
+ * Update analytic fold shadow with key points of current fold
+ *
+ * @param foldShadow fold shadow to be updated
+ */
+void PageFlip::updateFoldShadow(FoldShadow &foldShadow) {
+    Page &page = *mPages[FIRST_PAGE];
+    const GLPoint &originP = page.mOriginP;
+    const float sinA = (mTouchP.y - originP.y) / mLenOfT2O;
+    const float cosA = (originP.x - mTouchP.x) / mLenOfT2O;
+    foldShadow.setFold(originP, page.mDiagonalP, sinA, cosA,
+                       (mXFoldP1.x - originP.x) * cosA, mRadius,
+                       -mLenOfT2O);
+    foldShadow.setShadows(mComputing->edgeShadow.color,
+                          mFoldEdgeShadowWidth.width(mRadius),
+                          mComputing->baseShadow.color,
+                          mFoldBaseShadowWidth.width(mRadius));
+}
+
+/**
+ * Compute fold line which splits flat page into the first and second
+ * texture parts, same with polygons split by {@link Page}
+ * <p>The line passes xFoldP1 and yFoldP1, or is vertical when page flip is
+ * vertical. Its normal is towards originP, the positive side is revealed
+ * by fold</p>
+ *
+ * @param foldLine a, b, c of line a * x + b * y + c = 0, (a, b) is unit
+ */
+void PageFlip::computeFoldLine(float *foldLine) {
+    const GLPoint &originP = mPages[FIRST_PAGE]->mOriginP;
+    float a = originP.x - mXFoldP1.x;
+    float b = 0;
+    if (!mIsVertical) {
+        a = mYFoldP1.y - mXFoldP1.y;
+        b = mXFoldP1.x - mYFoldP1.x;
+        if (a * (originP.x - mXFoldP1.x) + b * (originP.y - mXFoldP1.y) < 0) {
+            a = -a;
+            b = -b;
+        }
+    }
+
+    const float len = sqrtf(a * a + b * b);
+    const float invLen = len > 0 ? 1.0f / len : 0;
+    foldLine[0] = a * invLen;
+    foldLine[1] = b * invLen;
+    foldLine[2] = -(foldLine[0] * mXFoldP1.x + foldLine[1] * mXFoldP1.y);
+}
+
+/**
+ * Compute bounding rect of back of fold and shadow meshes of mComputing,
+ * blended shadow passes don't touch pixels outside it
+ */
+void PageFlip::computeFoldBounds() {
+    FlipMeshes_ &meshes = *mComputing;
+    float *bounds = meshes.foldBounds;
+    bounds[0] = bounds[1] = FLT_MAX;
+    bounds[2] = bounds[3] = -FLT_MAX;
+
+    const float *vertexes = meshes.backOfFold.vertexes();
+    for (int i = meshes.backOfFold.count(); i > 0; --i, vertexes += 4) {
+        bounds[0] = std::min(bounds[0], vertexes[0]);
+        bounds[1] = std::min(bounds[1], vertexes[1]);
+        bounds[2] = std::max(bounds[2], vertexes[0]);
+        bounds[3] = std::max(bounds[3], vertexes[1]);
+    }
+
+    if (!meshes.hasShadowMesh) {
+        return;
+    }
+
+    ShadowVertexes *shadows[] = { &meshes.edgeShadow, &meshes.baseShadow };
+    for (int i = 0; i < 2; ++i) {
+        vertexes = shadows[i]->vertexes();
+        for (int j = shadows[i]->count(); j > 0; --j, vertexes += 2) {
+            bounds[0] = std::min(bounds[0], vertexes[0]);
+            bounds[1] = std::min(bounds[1], vertexes[1]);
+            bounds[2] = std::max(bounds[2], vertexes[0]);
+            bounds[3] = std::max(bounds[3], vertexes[1]);
+        }
+    }
+}
+
+/**
+ * Compute scissor of blended shadow passes from fold bounds of the drawn
+ * meshes, the view is orthographic so one pixel is one unit of page
+ * coordinate
+ *
+ * @return scissor in pixels for {@link RenderBackend#setBlendScissor}
+ */
+const int* PageFlip::updateBlendScissor() {
+    const float *bounds = mDrawing->foldBounds;
+    const int width = (int)mViewRect.surfaceWidth;
+    const int height = (int)mViewRect.surfaceHeight;
+    int left = 0, bottom = 0, right = 0, top = 0;
+    if (bounds[0] <= bounds[2] && bounds[1] <= bounds[3]) {
+        left = (int)floorf(std::max(bounds[0] + mViewRect.halfWidth, 0.0f));
+        bottom = (int)floorf(std::max(bounds[1] + mViewRect.halfHeight,
+                                      0.0f));
+        right = (int)ceilf(std::min(bounds[2] + mViewRect.halfWidth,
+                                    (float)width));
+        top = (int)ceilf(std::min(bounds[3] + mViewRect.halfHeight,
+                                  (float)height));
+        right = std::max(left, right);
+        top = std::max(bottom, top);
+    }
+
+    mBlendScissor[0] = left;
+    mBlendScissor[1] = bottom;
+    mBlendScissor[2] = right - left;
+    mBlendScissor[3] = top - bottom;
+
+    if (width > 0 && height > 0) {
+        const float coverage = (float)mBlendScissor[2] * mBlendScissor[3] /
+                               ((float)width * height);
+        mBlendCoverage = std::max(mBlendCoverage, coverage);
+    }
+
+    return mBlendScissor;
+}
+
+/**
+ * Gather all parts of flip frame into single pass buffer
+ * <p>With depth test, the order is same as multi-passes drawing, otherwise
+ * it is same as {@link #drawFlipFrameInPainterOrder()}</p>
+ */
+void PageFlip::buildSinglePassVertexes(Page &page, Page *secondPage) {
+    const float *frontVertexes = mDrawing->foldFront.vertexes();
+    const float *frontTexCoords = mDrawing->foldFront.texCoords();
+    const int sizeOfFrontVex = mDrawing->foldFront.sizeOfPerVex();
+    const int firstCount = page.mFrontVertexCount;
+    const int secondCount = mDrawing->foldFront.count() - firstCount;
+
+    mSinglePassVertexes.reset();
+    if (mIsDepthFree) {
+        mSinglePassVertexes
+                .addStrip(SECOND_TEXTURE_MATERIAL, frontVertexes,
+                          sizeOfFrontVex, frontTexCoords,
+                          firstCount, secondCount)
+                .addShadowStrip(mDrawing->baseShadow.vertexes(),
+                                mDrawing->baseShadow.count(),
+                                mDrawing->baseShadow.color,
+                                mDrawing->baseShadow.vertexZ());
+        if (secondPage) {
+            mSinglePassVertexes.addQuad(SECOND_PAGE_MATERIAL,
+                                        secondPage->mApexes,
+                                        secondPage->mApexTexCoords);
+        }
+
+        mSinglePassVertexes
+                .addStrip(FIRST_TEXTURE_MATERIAL, frontVertexes,
+                          sizeOfFrontVex, frontTexCoords, 0, firstCount)
+                .addShadowStrip(mDrawing->edgeShadow.vertexes(),
+                                mDrawing->edgeShadow.count(),
+                                mDrawing->edgeShadow.color,
+                                mDrawing->edgeShadow.vertexZ())
+                .addStrip(BACK_OF_FOLD_MATERIAL,
+                          mDrawing->backOfFold.vertexes(),
+                          mDrawing->backOfFold.sizeOfPerVex(),
+                          mDrawing->backOfFold.texCoords(),
+                          0, mDrawing->backOfFold.count());
+        return;
+    }
+
+    // 1. back of fold page
+    // 2. unfold page and front of fold page
+    mSinglePassVertexes
+            .addStrip(BACK_OF_FOLD_MATERIAL,
+                      mDrawing->backOfFold.vertexes(),
+                      mDrawing->backOfFold.sizeOfPerVex(),
+                      mDrawing->backOfFold.texCoords(),
+                      0, mDrawing->backOfFold.count())
+            .addStrip(FIRST_TEXTURE_MATERIAL, frontVertexes,
+                      sizeOfFrontVex, frontTexCoords, 0, firstCount)
+            .addStrip(SECOND_TEXTURE_MATERIAL, frontVertexes,
+                      sizeOfFrontVex, frontTexCoords,
+                      firstCount, secondCount);
+    if (secondPage) {
+        mSinglePassVertexes.addQuad(SECOND_PAGE_MATERIAL,
+                                    secondPage->mApexes,
+                                    secondPage->mApexTexCoords);
+    }
+
+    // 3. edge and base shadow of fold parts
+    mSinglePassVertexes
+            .addShadowStrip(mDrawing->baseShadow.vertexes(),
+                            mDrawing->baseShadow.count(),
+                            mDrawing->baseShadow.color,
+                            mDrawing->baseShadow.vertexZ())
+            .addShadowStrip(mDrawing->edgeShadow.vertexes(),
+                            mDrawing->edgeShadow.count(),
+                            mDrawing->edgeShadow.color,
+                            mDrawing->edgeShadow.vertexZ());
+}
+
+/**
+ * Get phase of a page in burst flip
+ * <p>All pages follow the path of scroller, the page with index i is delayed
+ * i * stagger, the top page reaches the end first and the bottom one
+ * reaches the end when scroller is finished</p>
+ *
+ * @param index page index from the top, 0 is the top page
+ * @return [0 .. 1], 1 means page is flipped out
+ */
+float PageFlip::burstProgressOf(int index) {
+    const float dx = mScroller.finalX() - mScroller.startX();
+    float progress = 1;
+    if (dx != 0) {
+        progress = (mScroller.currX() - mScroller.startX()) / dx;
+    }
+
+    const float span = 1 - (mBurstingPages - 1) * mBurstStagger;
+    progress = (progress - index * mBurstStagger) / span;
+    return progress < 0 ? 0 : (progress > 1 ? 1 : progress);
+}
+
+/**
+ * Compute meshes of burst pages which aren't flipped out
+ * <p>Pages share key vertexes, they are computed one by one from the bottom
+ * to the top into their own meshes in the calling thread, burst flip isn't
+ * pipelined. Drawing only submits them</p>
+ */
+void PageFlip::computeBurstPages() {
+    const GLPoint &originP = mPages[FIRST_PAGE]->mOriginP;
+    const float startX = mScroller.startX();
+    const float startY = mScroller.startY();
+    const float dx = mScroller.finalX() - startX;
+    const float dy = mScroller.finalY() - startY;
+    FlipMeshes_ *computing = mComputing;
+
+    mBurstMeshCount = 0;
+    mHasBurstTop = false;
+    for (int i = mBurstingPages - 1; i >= 0; --i) {
+        const float progress = burstProgressOf(i);
+        if (progress >= 1) {
+            continue;
+        }
+
+        mTouchP.set(startX + dx * progress, startY + dy * progress);
+        mMiddleP.set((mTouchP.x + originP.x) * 0.5f,
+                     (mTouchP.y + originP.y) * 0.5f);
+        mIsVertical = fabs(mTouchP.y - originP.y) < 1;
+        if (mIsVertical) {
+            computeKeyVertexesWhenVertical();
+        }
+        else {
+            computeKeyVertexesWhenSlope();
+        }
+
+        // colors of shadows and mask of fold are settings of the first set
+        FlipMeshes_ &meshes = mBurstMeshes[mBurstMeshCount++];
+        meshes.edgeShadow.color = mMeshes[0].edgeShadow.color;
+        meshes.baseShadow.color = mMeshes[0].baseShadow.color;
+        meshes.backOfFold.setMaskAlpha(mMeshes[0].backOfFold.maskAlpha());
+        mComputing = &meshes;
+        computeMeshes();
+        mHasBurstTop = i == 0;
+    }
+
+    mComputing = computing;
+}
+
+/**
+ * Draw frame of burst flip
+ * <p>Pages computed by {@link #computeBurstPages()} are drawn from the
+ * bottom to the top without depth test. With GLES2 backend, all pages are
+ * gathered into the single pass buffer and drawn by one draw call; other
+ * backends draw every page with several draw calls.</p>
+ * <p>Only the top page has its own textures, other pages show the second
+ * texture on front and the back texture on back, they are only visible
+ * as thin slices in a fast burst</p>
+ */
+void PageFlip::drawBurstFrame() {
+    Page &page = *mPages[FIRST_PAGE];
+    RenderBackend *backend = mBackend == &mGLBackend ? NULL : mBackend;
+
+    mBackend->beginFrame(false);
+    mPageStack.draw(*mBackend);
+
+    // all pages are flipped out, only the second texture is visible
+    if (mBurstMeshCount == 0) {
+        page.drawFullPage(*mBackend, false);
+        return;
+    }
+
+    FlipMeshes_ *drawing = mDrawing;
+    mSinglePassVertexes.reset();
+    for (int i = 0; i < mBurstMeshCount; ++i) {
+        mDrawing = &mBurstMeshes[i];
+        page.mFrontVertexCount = mDrawing->frontVertexCount;
+        addBurstPage(backend, page, i == 0,
+                     mHasBurstTop && i == mBurstMeshCount - 1);
+    }
+
+    if (backend == NULL) {
+        mSinglePassVertexes.draw(mGLBackend.singlePassProgram(), page, NULL,
+                                 mDrawing->backOfFold.maskAlpha(),
+                                 mGradientLightTexId);
+    }
+    mDrawing = drawing;
+}
+
+/**
+ * Add one page of burst flip in painter order
+ *
+ * @param backend backend to draw page, NULL means gathering page into
+ *                single pass buffer
+ * @param page page of computed vertexes
+ * @param isBottom is the bottom page which reveals the second texture
+ * @param isTop is the top page which shows the first texture
+ */
+void PageFlip::addBurstPage(RenderBackend *backend, Page &page,
+                            bool isBottom, bool isTop) {
+    const int firstCount = page.mFrontVertexCount;
+    const int secondCount = mDrawing->foldFront.count() - firstCount;
+
+    if (backend) {
+        if (isBottom) {
+            page.drawFrontPageOfSecondTexture(*backend, mDrawing->foldFront);
+        }
+        backend->setBlendScissor(updateBlendScissor());
+        mDrawing->baseShadow.draw(*backend);
+        page.drawFrontPagePart(*backend, mDrawing->foldFront, true,
+                               isTop ? page.textures.firstTextureId()
+                                     : page.textures.secondTextureId());
+        mDrawing->edgeShadow.draw(*backend);
+        backend->setBlendScissor(NULL);
+        mDrawing->backOfFold.draw(*backend, page, false, mGradientLightTexId);
+        return;
+    }
+
+    const float *frontVertexes = mDrawing->foldFront.vertexes();
+    const float *frontTexCoords = mDrawing->foldFront.texCoords();
+    const int sizeOfFrontVex = mDrawing->foldFront.sizeOfPerVex();
+    if (isBottom) {
+        mSinglePassVertexes.addStrip(SECOND_TEXTURE_MATERIAL, frontVertexes,
+                                     sizeOfFrontVex, frontTexCoords,
+                                     firstCount, secondCount);
+    }
+
+    mSinglePassVertexes
+            .addShadowStrip(mDrawing->baseShadow.vertexes(),
+                            mDrawing->baseShadow.count(),
+                            mDrawing->baseShadow.color,
+                            mDrawing->baseShadow.vertexZ())
+            .addStrip(isTop ? FIRST_TEXTURE_MATERIAL : SECOND_TEXTURE_MATERIAL,
+                      frontVertexes, sizeOfFrontVex, frontTexCoords,
+                      0, firstCount)
+            .addShadowStrip(mDrawing->edgeShadow.vertexes(),
+                            mDrawing->edgeShadow.count(),
+                            mDrawing->edgeShadow.color,
+                            mDrawing->edgeShadow.vertexZ())
+            .addStrip(BACK_OF_FOLD_MATERIAL,
+                      mDrawing->backOfFold.vertexes(),
+                      mDrawing->backOfFold.sizeOfPerVex(),
+                      mDrawing->backOfFold.texCoords(),
+                      0, mDrawing->backOfFold.count());
+}
+
+/**
+ * Set burst flip
+ * <p>The next forward flip in single page mode will flip the given pages
+ * with one gesture, the animation duration covers all pages</p>
+ *
+ * @param pages page count, [1 .. kMaxBurstPages], 1 means normal flip
+ * @param stagger phase delay between two pages, (pages - 1) * stagger must
+ *                be less than 1
+ * @return Error::OK if successfully
+ */
+int PageFlip::setBurstFlip(int pages, float stagger) {
+    if (pages < 1 || pages > kMaxBurstPages || stagger <= 0 ||
+        (pages - 1) * stagger >= 1 || !isEndedFlip()) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    const bool isResized = pages != mBurstPages;
+    mBurstPages = pages;
+    mBurstStagger = stagger;
+
+    // single pass buffer is enlarged to hold all pages
+    if (isResized && mMaxMeshCount > 0) {
+        computeMaxMeshCount();
     }
 
-    // 3. draw edge and base shadow of fold parts
-    glUseProgram(mShadowVertexProg.programRef());
-    mFoldBaseShadowVertexes.draw(mShadowVertexProg);
-    mFoldEdgeShadowVertexes.draw(mShadowVertexProg);
+    return Error::OK;
+}
+
+/**
+ * Enable pipelined geometry, it can't be changed in flipping
+ *
+ * @param isEnable true if meshes are computed in geometry thread
+ * @return Error::OK if successfully
+ */
+int PageFlip::enablePipelinedGeometry(bool isEnable) {
+    if (isEnable == mGeometryWorker.isRunning()) {
+        return Error::OK;
+    }
+
+    if (!isEndedFlip()) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    if (isEnable) {
+        const int ret = mGeometryWorker.start(computeMeshesInWorker, this);
+        if (ret != Error::OK) {
+            return ret;
+        }
+    }
+    else {
+        mGeometryWorker.stop();
+    }
+
+    // the second set of meshes is allocated or released
+    mComputing = mDrawing = &mMeshes[0];
+    mHasPendingMeshes = false;
+    if (mMaxMeshCount > 0) {
+        computeMaxMeshCount();
+    }
+
+    return Error::OK;
 }
 
 /**
  * Draw frame with full page
  */
 void PageFlip::drawPageFrame() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glUseProgram(mVertexProg.programRef());
-    glUniformMatrix4fv(mVertexProg.mvpMatrixLoc(), 1, GL_FALSE,
-                       mVertexProg.MVPMatrix);
-    glActiveTexture(GL_TEXTURE0);
+    RenderBackend &backend = *mBackend;
+    backend.beginFrame(!mIsDepthFree);
 
     // 1. draw first page
-    mPages[FIRST_PAGE]->drawFullPage(mVertexProg, true);
+    mPages[FIRST_PAGE]->drawFullPage(backend, true);
 
     // 2. draw second page if have
     if (mPages[SECOND_PAGE]) {
-        mPages[SECOND_PAGE]->drawFullPage(mVertexProg, true);
+        mPages[SECOND_PAGE]->drawFullPage(backend, true);
     }
+
+    // 3. draw page stack
+    mPageStack.draw(backend);
 }
 
 /**
  * Compute max mesh count and allocate mVertexes buffer
+ * <p>Meshes of the frame on screen are reset, so it is only called when
+ * surface is changed or from setters which refuse to run in flipping</p>
  */
 void PageFlip::computeMaxMeshCount() {
+    // meshes are being reallocated
+    mGeometryWorker.wait();
+    clearKeyframes();
+
     // compute max mesh count
     int maxMeshCnt = (int) mViewRect.minOfWidthHeight() / mPixelsOfMesh;
 
@@ -570,41 +1364,118 @@ void PageFlip::computeMaxMeshCount() {
         maxMeshCnt++;
     }
 
-    // init mVertexes buffers
-    mBackOfFoldVertexes.set(maxMeshCnt + 2);
-    mFoldFrontVertexes.set((maxMeshCnt << 1) + 8, 3, true);
-    mFoldEdgeShadowVertexes.set(maxMeshCnt + 2);
-    mFoldBaseShadowVertexes.set(maxMeshCnt + 2);
+    mMaxMeshCount = maxMeshCnt;
+
+    // compute buffer sizes
+    const int meshCnt = maxMeshCnt + 2;
+    const int frontCapacity = (maxMeshCnt << 1) + 8;
+    // single pass buffer: 5 strips at most, each with 3 stitching vertexes
+    // and burst flip needs the same space for every page
+    const int singlePassCapacity =
+            ((meshCnt << 1) + frontCapacity + 4 +
+             (mMeshes[0].edgeShadow.capacityOf(meshCnt) >> 1) +
+             (mMeshes[0].baseShadow.capacityOf(meshCnt) >> 1) +
+             5 * 3) * mBurstPages;
+
+    // the second set of fold meshes is only needed by pipelined geometry,
+    // every keyframe of all tracks has its own set too
+    const int setCount = mGeometryWorker.isRunning() ? 2 : 1;
+    const int keyframeCount = mAnimationKeyframes > 0
+                              ? mAnimationKeyframes + 1 : 0;
+    // burst pages are computed into their own sets
+    const int burstSetCount = mBurstPages > 1 ? mBurstPages : 0;
+    const size_t sizeOfMeshes =
+            BackOfFoldVertexes::sizeInArena(meshCnt) +
+            Vertexes::sizeInArena(frontCapacity, 3, true) +
+            mMeshes[0].edgeShadow.sizeInArena(meshCnt) +
+            mMeshes[0].baseShadow.sizeInArena(meshCnt);
+
+    // init mVertexes buffers, all of them are in one arena
+    mVertexArena.reserve(
+            sizeOfMeshes * (setCount + burstSetCount +
+                            keyframeCount * kMaxKeyframeTracks) +
+            SinglePassVertexes::sizeInArena(singlePassCapacity) +
+            TwoSidedFoldVertexes::sizeInArena((meshCnt << 1) +
+                                              frontCapacity));
+    for (int i = 0; i < setCount; ++i) {
+        mMeshes[i].set(mVertexArena, meshCnt, frontCapacity);
+    }
+
+    mBurstMeshCount = 0;
+    for (int i = 0; i < burstSetCount; ++i) {
+        mBurstMeshes[i].set(mVertexArena, meshCnt, frontCapacity);
+    }
+
+    // keyframes are disabled if their meshes can't be set, recording must
+    // not fall back to heap
+    int ret = Error::OK;
+    for (int i = 0; i < kMaxKeyframeTracks; ++i) {
+        KeyframeTrack_ &track = mKeyframeTracks[i];
+        track.allocate(keyframeCount);
+        for (int j = 0; j < keyframeCount && ret == Error::OK; ++j) {
+            ret = track.frames[j].set(mVertexArena, meshCnt, frontCapacity);
+        }
+    }
+
+    if (ret != Error::OK) {
+        LOGE(TAG, "Can't allocate meshes of %d keyframes", keyframeCount);
+        for (int i = 0; i < kMaxKeyframeTracks; ++i) {
+            mKeyframeTracks[i].allocate(0);
+        }
+    }
+
+    mComputing = mDrawing = &mMeshes[0];
+    mHasPendingMeshes = false;
+    mTwoSidedFoldVertexes.set(mVertexArena, (meshCnt << 1) + frontCapacity);
+    mSinglePassVertexes.set(mVertexArena, singlePassCapacity);
 }
 
 /**
  * Create gradient shadow texture for lighting effect
  */
 int PageFlip::setGradientLightTexture(AndroidBitmapInfo &info, GLvoid *data) {
-    GLint format;
-    GLenum type;
-    if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
-        format = GL_RGB;
-        type = GL_UNSIGNED_SHORT_5_6_5;
+    mGradientLightTexId = mBackend->createTexture(info, data);
+    if (mGradientLightTexId == 0) {
+        return Error::ERR_UNSUPPORT_BITMAP_FORMAT;
     }
-    else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
-        format = GL_RGBA;
-        type = GL_UNSIGNED_BYTE;
+
+    return Error::OK;
+}
+
+/**
+ * Set texture of page with pixels decoded by prefetcher
+ *
+ * @param index texture slot: FIRST_TEXTURE_ID, SECOND_TEXTURE_ID or
+ *              BACK_TEXTURE_ID
+ * @param isFirstPage is the first page
+ * @param pageIndex index of page source given to prefetcher
+ * @return Error::OK if successfully
+ */
+int PageFlip::setTextureOfPage(int index, bool isFirstPage, int pageIndex) {
+    Page* page = getPage(isFirstPage);
+    if (page == NULL) {
+        return gError.set(Error::ERR_NULL_PAGE);
     }
-    else {
-        return Error::ERR_UNSUPPORT_BITMAP_FORMAT;
+
+    AndroidBitmapInfo info;
+    void *data;
+    int ret = mPrefetcher.lock(pageIndex, info, data);
+    if (ret != Error::OK) {
+        return ret;
     }
 
-    glGenTextures(1, &mGradientLightTexId);
-    glActiveTexture(GL_TEXTURE0);
+    if (index == FIRST_TEXTURE_ID) {
+        ret = page->textures.setFirstTexture(info, data);
+    }
+    else if (index == SECOND_TEXTURE_ID) {
+        ret = page->textures.setSecondTexture(info, data);
+    }
+    else {
+        ret = page->textures.setBackTexture(info, data);
+    }
 
-    // gradient shadow texture
-    glBindTexture(GL_TEXTURE_2D, mGradientLightTexId);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, info.width, info.height, 0, format,
-                 type, data);
-    return Error::OK;
+    mPrefetcher.unlock(pageIndex);
+    return ret;
 }
 
 /**
@@ -613,12 +1484,235 @@ int PageFlip::setGradientLightTexture(AndroidBitmapInfo &info, GLvoid *data) {
 void PageFlip::computeVertexesBuildPage() {
     if (mIsVertical) {
         computeKeyVertexesWhenVertical();
-        computeVertexesWhenVertical();
     }
     else {
         computeKeyVertexesWhenSlope();
+    }
+
+    computeVertexes();
+}
+
+/**
+ * Compute all mVertexes from key vertexes, it is skipped when fold is
+ * deformed by GPU
+ * <p>When geometry is pipelined, meshes computed by worker for the previous
+ * key vertexes are handed over to drawing and worker starts computing the
+ * current ones. Caller must wait for worker before key vertexes are
+ * changed</p>
+ */
+void PageFlip::computeVertexes() {
+    if (isGPUDeforming()) {
+        return;
+    }
+
+    if (!isPipelining()) {
+        computeMeshes();
+        mDrawing = mComputing;
+    }
+    else {
+        // the first frame of pipeline has nothing pending to draw
+        if (!mHasPendingMeshes) {
+            computeMeshes();
+        }
+
+        // draw the computed set and compute into the other one
+        mDrawing = mComputing;
+        mComputing = mDrawing == &mMeshes[0] ? &mMeshes[1] : &mMeshes[0];
+        mGeometryWorker.post();
+        mHasPendingMeshes = true;
+    }
+
+    // only GL thread changes page state which is read by drawing
+    mPages[FIRST_PAGE]->mFrontVertexCount = mDrawing->frontVertexCount;
+}
+
+/**
+ * Compute fold page and shadow meshes of the current key vertexes into
+ * mComputing, it may run in geometry worker
+ */
+void PageFlip::computeMeshes() {
+    // meshes of recorded keyframe are copied instead of being computed
+    if (replayKeyframe()) {
+        return;
+    }
+
+    mComputing->hasShadowMesh = !isAnalyticShadowing();
+    mComputing->hasFoldClip = isFoldClipping();
+
+    if (mIsVertical) {
+        computeVertexesWhenVertical();
+    }
+    else {
         computeVertexesWhenSlope();
     }
+
+    if (!mComputing->hasShadowMesh) {
+        updateFoldShadow(mComputing->foldShadow);
+    }
+
+    if (mComputing->hasFoldClip) {
+        computeFoldLine(mComputing->foldLine);
+    }
+
+    computeFoldBounds();
+
+    recordKeyframe();
+}
+
+void PageFlip::computeMeshesInWorker(void *self) {
+    ((PageFlip*)self)->computeMeshes();
+}
+
+/**
+ * Set keyframe count of animations, see {@link #setAnimationKeyframes} in
+ * header
+ *
+ * @param count keyframes of an animation, 0 disables keyframe cache
+ * @return Error::OK if successfully
+ */
+int PageFlip::setAnimationKeyframes(int count) {
+    if (count < 0 || count > kMaxAnimationKeyframes || !isEndedFlip()) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    clearKeyframes();
+    mAnimationKeyframes = count;
+
+    // meshes of keyframes are in vertex arena
+    if (mMaxMeshCount > 0) {
+        computeMaxMeshCount();
+    }
+
+    return Error::OK;
+}
+
+/**
+ * Clear all recorded keyframes, the current animation isn't snapped any
+ * more
+ */
+void PageFlip::clearKeyframes() {
+    mGeometryWorker.wait();
+    for (int i = 0; i < kMaxKeyframeTracks; ++i) {
+        mKeyframeTracks[i].clear();
+    }
+
+    mTrack = -1;
+    mKeyframe = -1;
+}
+
+/**
+ * Select keyframe track of animation which is just started, a new track
+ * replaces the least recently played one if there is no same animation
+ *
+ * @param start start point of animation
+ * @param end end point of animation
+ */
+void PageFlip::selectKeyframeTrack(const PointF &start, const PointF &end) {
+    mTrack = -1;
+    mKeyframe = -1;
+    // burst flip and GPU deformation don't compute meshes of one flip
+    // meshes of keyframes aren't allocated if it is disabled
+    if (mKeyframeTracks[0].frameCount == 0 || mBurstingPages > 1 ||
+        isGPUDeforming()) {
+        return;
+    }
+
+    const GLPoint &originP = mPages[FIRST_PAGE]->mOriginP;
+    const bool hasSecondPage = mPages[SECOND_PAGE] != NULL;
+    int oldest = 0;
+    for (int i = 0; i < kMaxKeyframeTracks; ++i) {
+        const KeyframeTrack_ &track = mKeyframeTracks[i];
+        if (track.lastTick > 0 &&
+            track.flipState == mFlipState &&
+            track.hasSecondPage == hasSecondPage &&
+            track.kValue == mKValue &&
+            track.origin.x == originP.x && track.origin.y == originP.y &&
+            track.start.x == start.x && track.start.y == start.y &&
+            track.end.x == end.x && track.end.y == end.y) {
+            mTrack = i;
+            break;
+        }
+
+        if (track.lastTick < mKeyframeTracks[oldest].lastTick) {
+            oldest = i;
+        }
+    }
+
+    if (mTrack < 0) {
+        KeyframeTrack_ &track = mKeyframeTracks[oldest];
+        track.clear();
+        track.flipState = mFlipState;
+        track.hasSecondPage = hasSecondPage;
+        track.kValue = mKValue;
+        track.origin.set(originP.x, originP.y);
+        track.start.set(start.x, start.y);
+        track.end.set(end.x, end.y);
+        mTrack = oldest;
+    }
+
+    mKeyframeTracks[mTrack].lastTick = ++mKeyframeTick;
+}
+
+/**
+ * Snap touch point of animating to the nearest keyframe
+ * <p>Scroller moves point on the line from start to end point, the
+ * progress is measured on the longer axis of line</p>
+ */
+void PageFlip::snapToKeyframe() {
+    const int count = mKeyframeTracks[mTrack].frameCount - 1;
+    const float startX = mScroller.startX();
+    const float startY = mScroller.startY();
+    const float dx = mScroller.finalX() - startX;
+    const float dy = mScroller.finalY() - startY;
+
+    float progress = 1;
+    if (fabs(dx) >= fabs(dy) && dx != 0) {
+        progress = (mTouchP.x - startX) / dx;
+    }
+    else if (dy != 0) {
+        progress = (mTouchP.y - startY) / dy;
+    }
+
+    mKeyframe = (int)roundf(progress * count);
+    mKeyframe = std::max(0, std::min(count, mKeyframe));
+
+    const float t = (float)mKeyframe / count;
+    mTouchP.set(startX + dx * t, startY + dy * t);
+}
+
+/**
+ * Copy meshes of the current keyframe to mComputing
+ * <p>Keyframe recorded with or without shadow meshes or fold clipping
+ * can't be used if they are changed by backend or single pass drawing</p>
+ *
+ * @return true if keyframe is recorded and copied
+ */
+bool PageFlip::replayKeyframe() {
+    if (mKeyframe < 0) {
+        return false;
+    }
+
+    const KeyframeTrack_ &track = mKeyframeTracks[mTrack];
+    const FlipMeshes_ &frame = track.frames[mKeyframe];
+    return track.isRecorded[mKeyframe] &&
+           frame.hasShadowMesh == !isAnalyticShadowing() &&
+           frame.hasFoldClip == isFoldClipping() &&
+           mComputing->copy(frame) == Error::OK;
+}
+
+/**
+ * Record meshes of mComputing as the current keyframe
+ * <p>Buffers of keyframe have the same capacities as mComputing, so it
+ * only copies vertexes</p>
+ */
+void PageFlip::recordKeyframe() {
+    if (mKeyframe < 0) {
+        return;
+    }
+
+    KeyframeTrack_ &track = mKeyframeTracks[mTrack];
+    track.isRecorded[mKeyframe] =
+            track.frames[mKeyframe].copy(*mComputing) == Error::OK;
 }
 
 /**
@@ -666,49 +1760,57 @@ void PageFlip::computeVertexesWhenVertical() {
     const float oTexY = page.mOriginP.texY;
     const float oTexX = page.mOriginP.texX;
 
-    // compute the point on back page half cylinder
-    mBackOfFoldVertexes.reset();
+    // compute the point on back page half cylinder, no rotation is needed
+    mComputing->backOfFold.reset();
+    mFoldCylinder.set(mRadius, mXFoldP1.x, 0, 1, 0, 0);
 
     for (int i = 0; i <= mMeshCount; ++i, x -= stepX) {
-        // compute rad of x point
-        float x2t = x - mXFoldP1.x;
-        float rad = x2t / mRadius;
-        float sinR = sin(rad);
+        float fx, fy, fz;
+        float sinR = mFoldCylinder.map(x, 0, fx, fy, fz);
         float texX = page.textureX(x);
-        float fx = mXFoldP1.x + mRadius * sinR;
-        float fz = mRadius * (1 - cos(rad));
 
         // compute vertex when it is curled
-        mBackOfFoldVertexes.addVertex(fx, dY, fz, sinR, texX, dTexY)
-                           .addVertex(fx, oY, fz, sinR, texX, oTexY);
+        mComputing->backOfFold.addVertex(fx, dY, fz, sinR, texX, dTexY)
+                              .addVertex(fx, oY, fz, sinR, texX, oTexY);
     }
 
     float tpX = mTouchP.x;
-    mBackOfFoldVertexes.addVertex(tpX, dY, 1, 0, oTexX, dTexY)
-                       .addVertex(tpX, oY, 1, 0, oTexX, oTexY);
+    mComputing->backOfFold.addVertex(tpX, dY, 1, 0, oTexX, dTexY)
+                          .addVertex(tpX, oY, 1, 0, oTexX, oTexY);
+
+    // shadows are cast in page shading if there is no shadow mesh
+    if (mComputing->hasShadowMesh) {
+        // compute shadow width
+        float sw = -mFoldEdgeShadowWidth.width(mRadius);
+        float bw = mFoldBaseShadowWidth.width(mRadius);
+        if (page.mOriginP.x < 0) {
+            sw = -sw;
+            bw = -bw;
+        }
 
-    // compute shadow width
-    float sw = -mFoldEdgeShadowWidth.width(mRadius);
-    float bw = mFoldBaseShadowWidth.width(mRadius);
-    if (page.mOriginP.x < 0) {
-        sw = -sw;
-        bw = -bw;
+        // fold base shadow
+        float bx0 = mComputing->backOfFold.floatAt(0);
+        mComputing->baseShadow.setVertexes(0, bx0, oY, bx0 + bw, oY)
+                              .setVertexes(4, bx0, dY, bx0 + bw, dY)
+                              .setRange(0, 8);
+
+        // fold edge shadow
+        mComputing->edgeShadow.setVertexes(0, tpX, oY, tpX + sw, oY)
+                              .setVertexes(4, tpX, dY, tpX + sw, dY)
+                              .setRange(0, 8);
+
+        // set uniform Z value for shadow vertexes, edge shadow is level with
+        // the fold edge, otherwise it is hidden by flat page in depth test
+        mComputing->edgeShadow.setVertexZ(1);
+        mComputing->baseShadow.setVertexZ(-0.5f);
     }
 
-    // fold base shadow
-    float bx0 = mBackOfFoldVertexes.floatAt(0);
-    mFoldBaseShadowVertexes.setVertexes(0, bx0, oY, bx0 + bw, oY)
-                           .setVertexes(8, bx0, dY, bx0 + bw, dY)
-                           .setRange(0, 16);
-
-    // fold edge shadow
-    mFoldEdgeShadowVertexes.setVertexes(0, tpX, oY, tpX + sw, oY)
-                           .setVertexes(8, tpX, dY, tpX + sw, dY)
-                           .setRange(0, 16);
-
-    // fold front
-    mFoldFrontVertexes.reset();
-    page.buildVertexesOfPageWhenVertical(mFoldFrontVertexes, mXFoldP1);
+    // fold front, there is no front of fold when page flip is vertical,
+    // only polygons of flat page are built if they aren't clipped
+    mComputing->foldFront.reset();
+    mComputing->frontVertexCount = mComputing->hasFoldClip ? 0 :
+            page.buildVertexesOfPageWhenVertical(mComputing->foldFront,
+                                                 mXFoldP1);
 }
 
 /**
@@ -734,7 +1836,8 @@ void PageFlip::computeKeyVertexesWhenSlope() {
     mYFoldP1.set(mYFoldP.x, oY + r1 * (mYFoldP.y - oY));
 
     // line length from TouchXY to OriginalXY
-    mLenOfT2O = hypot(mTouchP.x - oX, mTouchP.y - oY);
+    mLenOfT2O = toFloat(hypot(GeometryReal(mTouchP.x - oX),
+                              GeometryReal(mTouchP.y - oY)));
 
     // cylinder radius
     mRadius = (float)(mLenOfT2O * mSemiPerimeterRatio / M_PI);
@@ -747,7 +1850,7 @@ void PageFlip::computeKeyVertexesWhenSlope() {
 }
 
 /**
- * Compute back vertex and edge shadow vertex of fold page
+ * Set back vertex and edge shadow vertex of fold page
  * <p>
  * In 2D coordinate system, for every vertex on fold page, we will follow
  * the below steps to compute its 3D point (x,y,z) on curled page(cylinder):
@@ -763,6 +1866,8 @@ void PageFlip::computeKeyVertexesWhenSlope() {
  *     <li>rotate 3d point (x, y, z) with -A to restore</li>
  *     <li>translate 3d point (x, y, z) to original coordinate system</li>
  * </ul>
+ * <p>The mapping is done by {@link FoldCylinder} which is set before
+ * computing vertexes</p>
  *
  * <p>For point of edge shadow, the most computing steps are same but:</p>
  * <ul>
@@ -770,163 +1875,126 @@ void PageFlip::computeKeyVertexesWhenSlope() {
  *     coordinate</li>
  *     <li>shadow point has same z coordinate with the page point</li>
  * </ul>
+ * <p>Vertexes are set at the given index and offset which are expanded
+ * before. It is only used for the mapping point of diagonal, which is
+ * computed serially and always sets its edge shadow vertex. Steps of slope
+ * strips are mapped by the kernels of {@link #kSlopeStepKernels} instead,
+ * they are specialized on HasShadow and the ones without shadow mesh don't
+ * touch shadow vertexes at all</p>
  *
- * @param isX is vertex for x point on x axis or y point on y axis?
+ * @param index index of back vertex
+ * @param shadowOffset offset of edge shadow vertexes
  * @param x0 x of point on axis
  * @param y0 y of point on axis
  * @param sx0 x of edge shadow point
  * @param sy0 y of edge shadow point
- * @param tX x of xFoldP1 point in rotated coordinate system
- * @param sinA sin value of page curling angle
- * @param cosA cos value of page curling angel
  * @param texX x of texture coordinate
  * @param coordY y of texture coordinate
- * @param oX x of originate point
- * @param oY y of originate point
  */
-void PageFlip::computeBackVertex(bool isX, float x0, float y0, float sx0,
-                                 float sy0, float xfx, float sinA,
-                                 float cosA, float texX, float texY,
-                                 float oX, float oY) {
-    // rotate degree A
-    float x = x0 * cosA - y0 * sinA;
-    float y = x0 * sinA + y0 * cosA;
-
-    // rotate degree A for mVertexes of fold edge shadow
-    float sx = sx0 * cosA - sy0 * sinA;
-    float sy = sx0 * sinA + sy0 * cosA;
+void PageFlip::setBackVertex(int index, int shadowOffset,
+                             float x0, float y0, float sx0, float sy0,
+                             float texX, float texY) {
+    float v[4];
+    v[3] = mFoldCylinder.map(x0, y0, v[0], v[1], v[2]);
+    mComputing->backOfFold.setVertex(index, v[0], v[1], v[2], v[3],
+                                     texX, texY);
+    setEdgeShadowVertex(shadowOffset, v, sx0, sy0);
+}
 
-    // compute mapping point on cylinder
-    float rad = (x - xfx) / mRadius;
-    double sinR = sin(rad);
-    x = (float) (xfx + mRadius * sinR);
-    float cz = mRadius * (1 - cos(rad));
+/**
+ * Set edge shadow vertex of mapped back vertex
+ *
+ * @param offset offset of edge shadow vertexes
+ * @param v mapped back vertex
+ * @param sx0 x of edge shadow point
+ * @param sy0 y of edge shadow point
+ */
+void PageFlip::setEdgeShadowVertex(int offset, const float *v,
+                                   float sx0, float sy0) {
+    const SlopeSteps_ &s = mSlopeSteps;
 
-    // rotate degree -A, sin(-A) = -sin(A), cos(-A) = cos(A)
-    float cx = x * cosA + y * sinA + oX;
-    float cy = y * cosA - x * sinA + oY;
-    mBackOfFoldVertexes.addVertex(cx, cy, cz, (float)sinR, texX, texY);
+    // rotate degree A for mVertexes of fold edge shadow
+    float sx = sx0 * s.cosA - sy0 * s.sinA;
+    float sy = sx0 * s.sinA + sy0 * s.cosA;
 
     // compute coordinates of fold shadow edge
-    float sRad = (sx - xfx) / mRadius;
-    sx = xfx + mRadius * sin(sRad);
-    mFoldEdgeShadowVertexes.addVertexes(isX, cx, cy,
-                                        sx * cosA + sy * sinA + oX,
-                                        sy * cosA - sx * sinA + oY);
+    sx = mFoldCylinder.mapX(sx);
+    mComputing->edgeShadow.setVertexes(offset, v[0], v[1],
+                                       sx * s.cosA + sy * s.sinA + s.oX,
+                                       sy * s.cosA - sx * s.sinA + s.oY);
 }
 
 /**
- * Compute back vertex of fold page
+ * Set back vertex of fold page
  * <p>
- * Almost same with another computeBackVertex function except expunging the
+ * Almost same with another setBackVertex function except expunging the
  * shadow point part
  * </p>
  *
+ * @param index index of back vertex
  * @param x0 x of point on axis
  * @param y0 y of point on axis
- * @param tX x of xFoldP1 point in rotated coordinate system
- * @param sinA sin value of page curling angle
- * @param cosA cos value of page curling angel
  * @param texX x of texture coordinate
  * @param coordY y of texture coordinate
- * @param oX x of originate point
- * @param oY y of originate point
  */
-void PageFlip::computeBackVertex(float x0, float y0, float xfx,
-                                 float sinA, float cosA, float texX,
-                                 float texY, float oX, float oY) {
-    // rotate degree A
-    float x = x0 * cosA - y0 * sinA;
-    float y = x0 * sinA + y0 * cosA;
-
-    // compute mapping point on cylinder
-    float rad = (x - xfx) / mRadius;
-    double sinR = sin(rad);
-    x = (float) (xfx + mRadius * sinR);
-    float cz = mRadius * (1 - cos(rad));
-
-    // rotate degree -A, sin(-A) = -sin(A), cos(-A) = cos(A)
-    float cx = x * cosA + y * sinA + oX;
-    float cy = y * cosA - x * sinA + oY;
-    mBackOfFoldVertexes.addVertex(cx, cy, cz, (float)sinR, texX, texY);
+void PageFlip::setBackVertex(int index, float x0, float y0,
+                             float texX, float texY) {
+    float cx, cy, cz;
+    const float sinR = mFoldCylinder.map(x0, y0, cx, cy, cz);
+    mComputing->backOfFold.setVertex(index, cx, cy, cz, sinR, texX, texY);
 }
 
 /**
- * Compute front vertex and base shadow vertex of fold page
+ * Set front vertex and base shadow vertex of fold page
  * <p>The computing principle is almost same with
- * {@link #computeBackVertex(boolean, float, float, float, float, float,
- * float, float, float, float, float, float)}</p>
+ * {@link #setBackVertex(int, int, float, float, float, float, float,
+ * float)}</p>
  *
- * @param isX is vertex for x point on x axis or y point on y axis?
+ * @param index index of front vertex
+ * @param shadowOffset offset of base shadow vertexes
  * @param x0 x of point on axis
  * @param y0 y of point on axis
- * @param tX x of xFoldP1 point in rotated coordinate system
- * @param sinA sin value of page curling angle
- * @param cosA cos value of page curling angel
- * @param baseWcosA base shadow width * cosA
- * @param baseWsinA base shadow width * sinA
  * @param texX x of texture coordinate
  * @param coordY y of texture coordinate
- * @param oX x of originate point
- * @param oY y of originate point
  */
-void PageFlip::computeFrontVertex(bool isX, float x0, float y0, float xfx,
-                                  float sinA, float cosA,
-                                  float baseWCosA, float baseWSinA,
-                                  float texX, float texY,
-                                  float oX, float oY) {
-    // rotate degree A
-    float x = x0 * cosA - y0 * sinA;
-    float y = x0 * sinA + y0 * cosA;
-
-    // compute mapping point on cylinder
-    float rad = (x - xfx)/ mRadius;
-    x = xfx + mRadius * sin(rad);
-    float cz = mRadius * (1 - cos(rad));
-
-    // rotate degree -A, sin(-A) = -sin(A), cos(-A) = cos(A)
-    float cx = x * cosA + y * sinA + oX;
-    float cy = y * cosA - x * sinA + oY;
-    mFoldFrontVertexes.addVertex(cx, cy, cz, texX, texY);
-    mFoldBaseShadowVertexes.addVertexes(isX, cx, cy,
-                                        cx + baseWCosA,
-                                        cy - baseWSinA);
+void PageFlip::setFrontVertex(int index, int shadowOffset,
+                              float x0, float y0,
+                              float texX, float texY) {
+    float v[3];
+    mFoldCylinder.map(x0, y0, v[0], v[1], v[2]);
+    mComputing->foldFront.setVertex(index, v[0], v[1], v[2], texX, texY);
+    setBaseShadowVertex(shadowOffset, v);
+}
+
+/**
+ * Set base shadow vertex of mapped front vertex
+ *
+ * @param offset offset of base shadow vertexes
+ * @param v mapped front vertex
+ */
+void PageFlip::setBaseShadowVertex(int offset, const float *v) {
+    mComputing->baseShadow.setVertexes(offset, v[0], v[1],
+                                       v[0] + mSlopeSteps.baseWCosA,
+                                       v[1] - mSlopeSteps.baseWSinA);
 }
 
 /**
- * Compute front vertex
+ * Set front vertex
  * <p>The difference with another
- * {@link #computeFrontVertex(boolean, float, float, float, float, float,
- * float, float, float, float, float, float, float)} is that it won't
- * compute base shadow vertex</p>
+ * {@link #setFrontVertex(int, int, float, float, float, float)} is that it
+ * won't compute base shadow vertex</p>
  *
+ * @param index index of front vertex
  * @param x0 x of point on axis
  * @param y0 y of point on axis
- * @param tX x of xFoldP1 point in rotated coordinate system
- * @param sinA sin value of page curling angle
- * @param cosA cos value of page curling angel
  * @param texX x of texture coordinate
  * @param coordY y of texture coordinate
- * @param oX x of originate point
- * @param oY y of originate point
  */
-void PageFlip::computeFrontVertex(float x0, float y0, float xfx,
-                                  float sinA, float cosA,
-                                  float texX, float texY,
-                                  float oX, float oY) {
-    // rotate degree A
-    float x = x0 * cosA - y0 * sinA;
-    float y = x0 * sinA + y0 * cosA;
-
-    // compute mapping point on cylinder
-    float rad = (x - xfx)/ mRadius;
-    x = xfx + mRadius * sin(rad);
-    float cz = mRadius * (1 - cos(rad));
-
-    // rotate degree -A, sin(-A) = -sin(A), cos(-A) = cos(A)
-    float cx = x * cosA + y * sinA + oX;
-    float cy = y * cosA - x * sinA + oY;
-    mFoldFrontVertexes.addVertex(cx, cy, cz, texX, texY);
+void PageFlip::setFrontVertex(int index, float x0, float y0,
+                              float texX, float texY) {
+    float cx, cy, cz;
+    mFoldCylinder.map(x0, y0, cx, cy, cz);
+    mComputing->foldFront.setVertex(index, cx, cy, cz, texX, texY);
 }
 
 /**
@@ -955,32 +2023,23 @@ void PageFlip::computeFrontVertex(float x0, float y0, float xfx,
  *
  * @param x0 x of point on axis
  * @param y0 y of point on axis
- * @param tX x of xFoldP1 point in rotated coordinate system
- * @param sinA sin value of page curling angle
- * @param cosA cos value of page curling angel
  * @param baseWcosA base shadow width * cosA
  * @param baseWsinA base shadow width * sinA
- * @param oX x of originate point
- * @param oY y of originate point
  * @param dY y of diagonal point
  */
-void PageFlip::computeBaseShadowLastVertex(float x0, float y0, float xfs,
-                                           float sinA, float cosA,
+void PageFlip::computeBaseShadowLastVertex(float x0, float y0,
                                            float baseWCosA,
                                            float baseWSinA,
-                                           float oX, float oY, float dY) {
+                                           float dY) {
+    if (!mComputing->hasShadowMesh) {
+        return;
+    }
+
     // like computing front vertex, we firstly compute the mapping vertex
     // on fold cylinder for point (x0, y0) which also is last vertex of
     // base shadow(mBackward direction)
-    float x = x0 * cosA - y0 * sinA;
-    float y = x0 * sinA + y0 * cosA;
-
-    // compute mapping point on cylinder
-    float rad = (x - xfs)/ mRadius;
-    x = xfs + mRadius * sin(rad);
-
-    float cx1 = x * cosA + y * sinA + oX;
-    float cy1 = y * cosA - x * sinA + oY;
+    float cx1, cy1, cz1;
+    mFoldCylinder.map(x0, y0, cx1, cy1, cz1);
 
     // now, we have start vertex(cx1, cy1), compute end vertex(cx2, cy2)
     // which is translated based on start vertex(cx1, cy1)
@@ -997,54 +2056,68 @@ void PageFlip::computeBaseShadowLastVertex(float x0, float y0, float xfs,
 
     // add start/end vertex into base shadow buffer, it will be linked with
     // mForward mVertexes to draw base shadow
-    mFoldBaseShadowVertexes.addVertexes(false, bx1, dY, bx2, dY);
+    mComputing->baseShadow.addVertexes(false, bx1, dY, bx2, dY);
 }
 
 /**
  * Compute mVertexes when page flip is slope
+ * <p>Every mesh step of the back and front strips only depends on its
+ * index, so buffers are expanded for all steps first and steps are computed
+ * by geometry pool. The few vertexes between the parts inside and outside
+ * page are computed here</p>
  */
 void PageFlip::computeVertexesWhenSlope() {
     Page& page = *mPages[FIRST_PAGE];
-    const float oX = page.mOriginP.x;
-    const float oY = page.mOriginP.y;
-    const float dY = page.mDiagonalP.y;
-    const float oTexX = page.mOriginP.texX;
-    const float oTexY = page.mOriginP.texY;
-    const float dTexY = page.mDiagonalP.texY;
+    SlopeSteps_ &s = mSlopeSteps;
+    s.oX = page.mOriginP.x;
+    s.oY = page.mOriginP.y;
+    s.dY = page.mDiagonalP.y;
+    s.oTexX = page.mOriginP.texX;
+    s.oTexY = page.mOriginP.texY;
+    s.dTexY = page.mDiagonalP.texY;
+    s.d2oY = s.dY - s.oY;
+    const float oX = s.oX;
+    const float oY = s.oY;
+    const float dY = s.dY;
     const float height = page.mHeight;
-    const float d2oY = dY - oY;
 
     // compute radius and sin/cos of angle
-    const float sinA = (mTouchP.y - oY) / mLenOfT2O;
-    const float cosA = (oX - mTouchP.x) / mLenOfT2O;
+    s.sinA = (mTouchP.y - oY) / mLenOfT2O;
+    s.cosA = (oX - mTouchP.x) / mLenOfT2O;
 
     // need to translate before rotate, and then translate back
-    float xFP1 = (mXFoldP1.x - oX) * cosA;
+    float xFP1 = (mXFoldP1.x - oX) * s.cosA;
     float edgeW = mFoldEdgeShadowWidth.width(mRadius);
     float baseW = mFoldBaseShadowWidth.width(mRadius);
-    float baseWCosA = baseW * cosA;
-    float baseWSinA = baseW * sinA;
+    s.baseWCosA = baseW * s.cosA;
+    s.baseWSinA = baseW * s.sinA;
     float edgeY = oY > 0 ? edgeW : -edgeW;
     float edgeX = oX > 0 ? edgeW : -edgeW;
-    float stepSY = edgeY / mMeshCount;
-    float stepSX = edgeX / mMeshCount;
+
+    mFoldCylinder.set(mRadius, xFP1, s.sinA, s.cosA, oX, oY);
 
     // reset mVertexes buffer counter
-    mFoldEdgeShadowVertexes.reset();
-    mFoldBaseShadowVertexes.reset();
-    mFoldFrontVertexes.reset();
-    mBackOfFoldVertexes.reset();
+    Vertexes &front = mComputing->foldFront;
+    BackOfFoldVertexes &back = mComputing->backOfFold;
+    ShadowVertexes &edgeShadow = mComputing->edgeShadow;
+    ShadowVertexes &baseShadow = mComputing->baseShadow;
+    edgeShadow.reset();
+    baseShadow.reset();
+    front.reset();
+    back.reset();
 
     // add the first 3 float numbers is fold triangle
-    mBackOfFoldVertexes.addVertex(mTouchP.x, mTouchP.y, 1, 0, oTexX, oTexY);
+    back.addVertex(mTouchP.x, mTouchP.y, 1, 0, s.oTexX, s.oTexY);
 
     // compute mVertexes for fold back part
-    float stepX = (mXFoldP0.x - mXFoldP.x) / mMeshCount;
-    float stepY = (mYFoldP0.y - mYFoldP.y) / mMeshCount;
-    float x = mXFoldP0.x - oX;
-    float y = mYFoldP0.y - oY;
-    float sx = edgeX;
-    float sy = edgeY;
+    s.backX = mXFoldP0.x - oX;
+    s.backY = mYFoldP0.y - oY;
+    s.backStepX = (mXFoldP0.x - mXFoldP.x) / mMeshCount;
+    s.backStepY = (mYFoldP0.y - mYFoldP.y) / mMeshCount;
+    s.edgeX = edgeX;
+    s.edgeY = edgeY;
+    s.edgeStepX = edgeX / mMeshCount;
+    s.edgeStepY = edgeY / mMeshCount;
 
     // compute point of back of fold page
     // Case 1: y coordinate of point YFP0 -> YFP is < diagonalP.y
@@ -1067,16 +2140,18 @@ void PageFlip::computeVertexesWhenSlope() {
     //    curled
     // 3. P point will be computed
     //
-    // compute points within the page
+    // expand buffers for points within the page
     int i = 0;
-    for (; i <= mMeshCount && fabs(y) < height;
-          ++i, x -= stepX, y -= stepY, sy -= stepSY, sx -= stepSX) {
-        computeBackVertex(true, x, 0, x, sy, xFP1, sinA, cosA,
-                          page.textureX(x + oX), oTexY, oX, oY);
-        computeBackVertex(false, 0, y, sx, y, xFP1, sinA, cosA, oTexX,
-                          page.textureY(y + oY), oX, oY);
+    while (i <= mMeshCount && fabs(s.backY - i * s.backStepY) < height) {
+        ++i;
     }
 
+    s.backCount = mMeshCount + 1;
+    s.backInPage = i;
+    s.backInIndex = back.expand(i << 1);
+    s.edgeForward = edgeShadow.expandForward(i);
+    s.edgeBackward = edgeShadow.expandBackward(i);
+
     // If y coordinate of point on YFP0 -> YFP is > diagonalP
     // There are two cases:
     //                      <---- Flip
@@ -1094,40 +2169,37 @@ void PageFlip::computeVertexesWhenSlope() {
     //
     // compute points outside the page
     if (i <= mMeshCount) {
+        const float y = s.backY - i * s.backStepY;
+        const float sx = s.edgeX - i * s.edgeStepX;
+        const float sy = s.edgeY - i * s.edgeStepY;
         if (fabs(y) != height) {
             // case 3: compute mapping point of diagonalP
             if (fabs(mYFoldP0.y - oY) > height) {
                 float tx = oX + 2 * mKValue * (mYFoldP.y - dY);
                 float ty = dY + mKValue * (tx - oX);
-                mBackOfFoldVertexes.addVertex(tx, ty, 1, 0, oTexX, dTexY);
+                back.addVertex(tx, ty, 1, 0, s.oTexX, s.dTexY);
 
-                float tsx = tx - sx;
-                float tsy = dY + mKValue * (tsx - oX);
-                mFoldEdgeShadowVertexes.addVertexes(false, tx, ty, tsx, tsy);
+                if (mComputing->hasShadowMesh) {
+                    float tsx = tx - sx;
+                    float tsy = dY + mKValue * (tsx - oX);
+                    edgeShadow.addVertexes(false, tx, ty, tsx, tsy);
+                }
             }
             // case 2: compute mapping point of diagonalP
             else {
-                float x1 = mKValue* d2oY;
-                computeBackVertex(true, x1, 0, x1, sy, xFP1, sinA, cosA,
-                                  page.textureX(x1 + oX), oTexY, oX, oY);
-                computeBackVertex(false, 0, d2oY, sx, d2oY, xFP1, sinA,
-                                  cosA, oTexX, dTexY, oX, oY);
+                float x1 = mKValue * s.d2oY;
+                const int index = back.expand(2);
+                setBackVertex(index, edgeShadow.expandForward(1),
+                              x1, 0, x1, sy,
+                              page.textureX(x1 + oX), s.oTexY);
+                setBackVertex(index + 1, edgeShadow.expandBackward(1),
+                              0, s.d2oY, sx, s.d2oY, s.oTexX, s.dTexY);
             }
         }
 
-        // compute the remaining points
-        for (; i <= mMeshCount;
-               ++i, x -= stepX, y -= stepY, sy -= stepSY, sx -= stepSX) {
-            computeBackVertex(true, x, 0, x, sy, xFP1, sinA, cosA,
-                              page.textureX(x + oX), oTexY, oX, oY);
-
-            // since the origin Y is beyond page, we need to compute its
-            // projection point on page border and then compute mapping
-            // point on curled cylinder
-            float x1 = mKValue * (y + oY - dY);
-            computeBackVertex(x1, d2oY, xFP1, sinA, cosA,
-                              page.textureX(x1 + oX), dTexY, oX, oY);
-        }
+        // expand buffers for the remaining points
+        s.backOutIndex = back.expand((s.backCount - i) << 1);
+        s.edgeOutForward = edgeShadow.expandForward(s.backCount - i);
     }
 
     // Like above computation, the below steps are computing mVertexes of
@@ -1156,61 +2228,297 @@ void PageFlip::computeVertexesWhenSlope() {
     // 2. YFP->XFP is joint line of front and back of fold page
     // 3. P point will be computed
     //
-    // compute points within the page
-    stepX = (mXFoldP.x - mXFoldP1.x) / mMeshCount;
-    stepY = (mYFoldP.y - mYFoldP1.y) / mMeshCount;
-    x = mXFoldP.x - oX - stepX;
-    y = mYFoldP.y - oY - stepY;
+    // expand buffers for points within the page
+    s.frontStepX = (mXFoldP.x - mXFoldP1.x) / mMeshCount;
+    s.frontStepY = (mYFoldP.y - mYFoldP1.y) / mMeshCount;
+    s.frontX = mXFoldP.x - oX - s.frontStepX;
+    s.frontY = mYFoldP.y - oY - s.frontStepY;
     int j = 0;
-    for (; j < mMeshCount && fabs(y) < height; ++j, x -= stepX, y -= stepY) {
-        computeFrontVertex(true, x, 0, xFP1, sinA, cosA, baseWCosA, baseWSinA,
-                           page.textureX(x + oX), oTexY, oX, oY);
-        computeFrontVertex(false, 0, y, xFP1, sinA, cosA, baseWCosA, baseWSinA,
-                           oTexX, page.textureY(y + oY), oX, oY);
+    while (j < mMeshCount && fabs(s.frontY - j * s.frontStepY) < height) {
+        ++j;
     }
 
+    s.frontCount = mMeshCount;
+    s.frontInPage = j;
+    s.frontInIndex = front.expand(j << 1);
+    s.baseForward = baseShadow.expandForward(j);
+    s.baseBackward = baseShadow.expandBackward(j);
+
     // compute points outside the page
     if (j < mMeshCount) {
+        const float y = s.frontY - j * s.frontStepY;
+
         // compute mapping point of diagonalP
         if (fabs(y) != height && j > 0) {
             float y1 = (dY - oY);
             float x1 = mKValue * y1;
-            computeFrontVertex(true, x1, 0, xFP1, sinA, cosA,
-                               baseWCosA, baseWSinA,
-                               page.textureX(x1 + oX), oTexY, oX, oY);
-
-            computeFrontVertex(0, y1, xFP1, sinA, cosA, oTexX,
-                               page.textureY(y1 + oY), oX, oY);
+            const int index = front.expand(2);
+            setFrontVertex(index, baseShadow.expandForward(1), x1, 0,
+                           page.textureX(x1 + oX), s.oTexY);
+            setFrontVertex(index + 1, 0, y1,
+                           s.oTexX, page.textureY(y1 + oY));
         }
 
         // compute last pair of mVertexes of base shadow
-        computeBaseShadowLastVertex(0, y, xFP1, sinA, cosA,
-                                    baseWCosA, baseWSinA, oX, oY, dY);
-
-        // compute the remaining points
-        for (; j < mMeshCount; ++j, x -= stepX, y -= stepY) {
-            computeFrontVertex(true, x, 0, xFP1, sinA, cosA,
-                               baseWCosA, baseWSinA,
-                               page.textureX(x + oX), oTexY, oX, oY);
-
-            float x1 = mKValue * (y + oY - dY);
-            computeFrontVertex(x1, d2oY, xFP1, sinA, cosA,
-                               page.textureX(x1 + oX), dTexY, oX, oY);
-        }
+        computeBaseShadowLastVertex(0, y, s.baseWCosA, s.baseWSinA, dY);
 
+        // expand buffers for the remaining points
+        s.frontOutIndex = front.expand((s.frontCount - j) << 1);
+        s.baseOutForward = baseShadow.expandForward(s.frontCount - j);
     }
 
+    // compute all steps of back and front strips, kernels are chosen once
+    // per frame so no step checks shadow mesh
+    mSlopeKernels = kSlopeStepKernels[mComputing->hasShadowMesh ? 1 : 0];
+    mGeometryPool.run(computeSlopeStepsInPool, this,
+                      s.backCount + s.frontCount, kMinStepsOfGeometryThread);
+
     // set uniform Z value for shadow mVertexes
-    mFoldEdgeShadowVertexes.setVertexZ(mFoldFrontVertexes.floatAt(2));
-    mFoldBaseShadowVertexes.setVertexZ(-0.5f);
+    edgeShadow.setVertexZ(front.floatAt(2));
+    baseShadow.setVertexZ(-0.5f);
 
-    // add two mVertexes to connect with the unfold front page
-    page.buildVertexesOfPageWhenSlope(mFoldFrontVertexes, mXFoldP1,
-                                      mYFoldP1, mKValue);
+    // add two mVertexes to connect with the unfold front page, the flat
+    // page clipped by fold needs only front of fold
+    mComputing->frontVertexCount = mComputing->hasFoldClip ? front.count() :
+            page.buildVertexesOfPageWhenSlope(front, mXFoldP1,
+                                              mYFoldP1, mKValue);
 
     // compute mVertexes of fold edge shadow
-    computeVertexesOfFoldTopEdgeShadow(mTouchP.x, mTouchP.y,
-                                       sinA, cosA, -edgeX, edgeY);
+    if (mComputing->hasShadowMesh) {
+        computeVertexesOfFoldTopEdgeShadow(mTouchP.x, mTouchP.y,
+                                           s.sinA, s.cosA, -edgeX, edgeY);
+    }
+}
+
+/**
+ * Kernels of slope strips: back within page, back outside page, front
+ * within page and front outside page, without or with shadow meshes
+ */
+const PageFlip::StepKernel
+PageFlip::kSlopeStepKernels[2][SLOPE_STRIP_COUNT] = {
+    { &PageFlip::computeBackStepsInPage<false>,
+      &PageFlip::computeBackStepsOutPage<false>,
+      &PageFlip::computeFrontStepsInPage<false>,
+      &PageFlip::computeFrontStepsOutPage<false> },
+    { &PageFlip::computeBackStepsInPage<true>,
+      &PageFlip::computeBackStepsOutPage<true>,
+      &PageFlip::computeFrontStepsInPage<true>,
+      &PageFlip::computeFrontStepsOutPage<true> },
+};
+
+/**
+ * Compute steps [begin .. end) of back and front strips, the back steps
+ * come first and then the front steps. Range is cut by strips and every
+ * piece is given to the kernel of its strip
+ */
+void PageFlip::computeSlopeSteps(int begin, int end) {
+    const SlopeSteps_ &s = mSlopeSteps;
+    const int bounds[SLOPE_STRIP_COUNT + 1] = {
+        0,
+        s.backInPage,
+        s.backCount,
+        s.backCount + s.frontInPage,
+        s.backCount + s.frontCount
+    };
+
+    for (int i = 0; i < SLOPE_STRIP_COUNT; ++i) {
+        const int first = std::max(begin, bounds[i]);
+        const int last = std::min(end, bounds[i + 1]);
+        if (first < last) {
+            (this->*mSlopeKernels[i])(first - bounds[i], last - bounds[i]);
+        }
+    }
+}
+
+/**
+ * Compute steps of back of fold page within page
+ * <p>Every step has a point on x axis and a point on y axis, 2 steps are
+ * mapped at a time as 4 consecutive vertexes</p>
+ */
+template <bool HasShadow>
+void PageFlip::computeBackStepsInPage(int begin, int end) {
+    const SlopeSteps_ &s = mSlopeSteps;
+    Page &page = *mPages[FIRST_PAGE];
+    Vertexes &back = mComputing->backOfFold;
+
+    for (int i = begin; i < end; i += 2) {
+        const int count = std::min(end - i, 2) << 1;
+        const int index = s.backInIndex + (i << 1);
+        const float xa = s.backX - i * s.backStepX;
+        const float ya = s.backY - i * s.backStepY;
+        const float xb = s.backX - (i + 1) * s.backStepX;
+        const float yb = s.backY - (i + 1) * s.backStepY;
+
+        float v[16];
+        mFoldCylinder.map4(Vec4(xa, 0, xb, 0), Vec4(0, ya, 0, yb), v);
+        back.setVertexes(index, count, v);
+
+        float tex[4];
+        page.textureXY(xa + s.oX, xb + s.oX, ya + s.oY, yb + s.oY, tex);
+        back.setTexCoord(index, tex[0], s.oTexY);
+        back.setTexCoord(index + 1, s.oTexX, tex[2]);
+        if (count > 2) {
+            back.setTexCoord(index + 2, tex[1], s.oTexY);
+            back.setTexCoord(index + 3, s.oTexX, tex[3]);
+        }
+
+        if (HasShadow) {
+            for (int k = 0; k < count; k += 2) {
+                const int j = i + (k >> 1);
+                const float sx = s.edgeX - j * s.edgeStepX;
+                const float sy = s.edgeY - j * s.edgeStepY;
+                setEdgeShadowVertex(s.edgeForward + (j << 2), v + (k << 2),
+                                    k ? xb : xa, sy);
+                setEdgeShadowVertex(
+                        s.edgeBackward + ((s.backInPage - 1 - j) << 2),
+                        v + ((k + 1) << 2), sx, k ? yb : ya);
+            }
+        }
+    }
+}
+
+/**
+ * Compute steps of back of fold page outside page
+ * <p>Every step has a point on x axis and a projection point on page
+ * border, 2 steps are mapped at a time as 4 consecutive vertexes</p>
+ */
+template <bool HasShadow>
+void PageFlip::computeBackStepsOutPage(int begin, int end) {
+    const SlopeSteps_ &s = mSlopeSteps;
+    Page &page = *mPages[FIRST_PAGE];
+    Vertexes &back = mComputing->backOfFold;
+
+    for (int n = begin; n < end; n += 2) {
+        const int count = std::min(end - n, 2) << 1;
+        const int index = s.backOutIndex + (n << 1);
+        const int i = s.backInPage + n;
+        const float xa = s.backX - i * s.backStepX;
+        const float ya = s.backY - i * s.backStepY;
+        const float xb = s.backX - (i + 1) * s.backStepX;
+        const float yb = s.backY - (i + 1) * s.backStepY;
+
+        // since the origin Y is beyond page, we need to compute its
+        // projection point on page border and then compute mapping
+        // point on curled cylinder
+        const float x1a = mKValue * (ya + s.oY - s.dY);
+        const float x1b = mKValue * (yb + s.oY - s.dY);
+
+        float v[16];
+        mFoldCylinder.map4(Vec4(xa, x1a, xb, x1b),
+                           Vec4(0, s.d2oY, 0, s.d2oY), v);
+        back.setVertexes(index, count, v);
+
+        float tex[4];
+        page.textureX(Vec4(xa, x1a, xb, x1b) + Vec4(s.oX), tex);
+        back.setTexCoord(index, tex[0], s.oTexY);
+        back.setTexCoord(index + 1, tex[1], s.dTexY);
+        if (count > 2) {
+            back.setTexCoord(index + 2, tex[2], s.oTexY);
+            back.setTexCoord(index + 3, tex[3], s.dTexY);
+        }
+
+        if (HasShadow) {
+            for (int k = 0; k < count; k += 2) {
+                const int j = n + (k >> 1);
+                const float sy = s.edgeY - (s.backInPage + j) * s.edgeStepY;
+                setEdgeShadowVertex(s.edgeOutForward + (j << 2),
+                                    v + (k << 2), k ? xb : xa, sy);
+            }
+        }
+    }
+}
+
+/**
+ * Compute steps of front of fold page within page
+ * <p>The steps are mapped in the same way as
+ * {@link #computeBackStepsInPage(int, int)}</p>
+ */
+template <bool HasShadow>
+void PageFlip::computeFrontStepsInPage(int begin, int end) {
+    const SlopeSteps_ &s = mSlopeSteps;
+    Page &page = *mPages[FIRST_PAGE];
+    Vertexes &front = mComputing->foldFront;
+
+    for (int j = begin; j < end; j += 2) {
+        const int count = std::min(end - j, 2) << 1;
+        const int index = s.frontInIndex + (j << 1);
+        const float xa = s.frontX - j * s.frontStepX;
+        const float ya = s.frontY - j * s.frontStepY;
+        const float xb = s.frontX - (j + 1) * s.frontStepX;
+        const float yb = s.frontY - (j + 1) * s.frontStepY;
+
+        float v[16];
+        mFoldCylinder.map4(Vec4(xa, 0, xb, 0), Vec4(0, ya, 0, yb), v);
+        front.setVertexes(index, count, v);
+
+        float tex[4];
+        page.textureXY(xa + s.oX, xb + s.oX, ya + s.oY, yb + s.oY, tex);
+        front.setTexCoord(index, tex[0], s.oTexY);
+        front.setTexCoord(index + 1, s.oTexX, tex[2]);
+        if (count > 2) {
+            front.setTexCoord(index + 2, tex[1], s.oTexY);
+            front.setTexCoord(index + 3, s.oTexX, tex[3]);
+        }
+
+        if (HasShadow) {
+            for (int k = 0; k < count; k += 2) {
+                const int m = j + (k >> 1);
+                setBaseShadowVertex(s.baseForward + (m << 2), v + (k << 2));
+                setBaseShadowVertex(
+                        s.baseBackward + ((s.frontInPage - 1 - m) << 2),
+                        v + ((k + 1) << 2));
+            }
+        }
+    }
+}
+
+/**
+ * Compute steps of front of fold page outside page
+ * <p>The steps are mapped in the same way as
+ * {@link #computeBackStepsOutPage(int, int)}</p>
+ */
+template <bool HasShadow>
+void PageFlip::computeFrontStepsOutPage(int begin, int end) {
+    const SlopeSteps_ &s = mSlopeSteps;
+    Page &page = *mPages[FIRST_PAGE];
+    Vertexes &front = mComputing->foldFront;
+
+    for (int n = begin; n < end; n += 2) {
+        const int count = std::min(end - n, 2) << 1;
+        const int index = s.frontOutIndex + (n << 1);
+        const int j = s.frontInPage + n;
+        const float xa = s.frontX - j * s.frontStepX;
+        const float ya = s.frontY - j * s.frontStepY;
+        const float xb = s.frontX - (j + 1) * s.frontStepX;
+        const float yb = s.frontY - (j + 1) * s.frontStepY;
+        const float x1a = mKValue * (ya + s.oY - s.dY);
+        const float x1b = mKValue * (yb + s.oY - s.dY);
+
+        float v[16];
+        mFoldCylinder.map4(Vec4(xa, x1a, xb, x1b),
+                           Vec4(0, s.d2oY, 0, s.d2oY), v);
+        front.setVertexes(index, count, v);
+
+        float tex[4];
+        page.textureX(Vec4(xa, x1a, xb, x1b) + Vec4(s.oX), tex);
+        front.setTexCoord(index, tex[0], s.oTexY);
+        front.setTexCoord(index + 1, tex[1], s.dTexY);
+        if (count > 2) {
+            front.setTexCoord(index + 2, tex[2], s.oTexY);
+            front.setTexCoord(index + 3, tex[3], s.dTexY);
+        }
+
+        if (HasShadow) {
+            for (int k = 0; k < count; k += 2) {
+                setBaseShadowVertex(s.baseOutForward + ((n + (k >> 1)) << 2),
+                                    v + (k << 2));
+            }
+        }
+    }
+}
+
+void PageFlip::computeSlopeStepsInPool(void *self, int begin, int end) {
+    ((PageFlip*)self)->computeSlopeSteps(begin, end);
 }
 
 /**
@@ -1232,7 +2540,7 @@ void PageFlip::computeVertexesOfFoldTopEdgeShadow(float x0, float y0,
     float r = 0;
     float dr = (float)(M_PI / (kFoldTopEdgeShadowVexCount - 2));
     int size = kFoldTopEdgeShadowVexCount / 2;
-    int j = mFoldEdgeShadowVertexes.maxBackward();
+    int j = mComputing->edgeShadow.maxBackward();
 
     //                 ^ Y                             __ |
     //      TouchP+    |                             /    |
@@ -1248,21 +2556,28 @@ void PageFlip::computeVertexesOfFoldTopEdgeShadow(float x0, float y0,
     // 1. compute quarter circle at origin point
     // 2. rotate quarter circle to touch point direction
     // 3. move quarter circle to touch point as top edge shadow
-    for (int i = 0; i < size; ++i, r += dr, j += 8) {
+    for (int i = 0; i < size; ++i, r += dr, j += 4) {
         float x = sx * cos(r);
         float y = sy * sin(r);
 
         // rotate -2A and then translate to touchP
-        mFoldEdgeShadowVertexes.setVertexes(j, x0, y0,
-                                            x * cos2A + y * sin2A + x0,
-                                            y * cos2A - x * sin2A + y0);
+        mComputing->edgeShadow.setVertexes(j, x0, y0,
+                                           x * cos2A + y * sin2A + x0,
+                                           y * cos2A - x * sin2A + y0);
     }
 }
 
 /**
  * Compute mesh count for page flip
+ * <p>In adaptive mode, mesh count is decided by cylinder radius, see
+ * {@link MeshDensity}, otherwise it is decided by pixels of mesh</p>
  */
 void PageFlip::computeMeshCount() {
+    if (mMeshDensity.isAdaptive()) {
+        mMeshCount = mMeshDensity.meshCount(mRadius, mMaxMeshCount >> 1);
+        return;
+    }
+
     float dx = fabs(mXFoldP0.x - mXFoldP1.x);
     float dy = fabs(mYFoldP0.y - mYFoldP1.y);
     int len = mIsVertical ? (int)dx : (int)std::min(dx, dy);
@@ -18,18 +18,30 @@
 #define ANDROID_PAGEFLIP_PAGE_FLIP_H
 
 #include <math.h>
+#include <vector>
 #include "Page.h"
-#include "pointf.h"
+#include "PointF.h"
 #include "GLPoint.h"
 #include "GLViewRect.h"
 #include "Scroller.h"
 #include "ShadowWidth.h"
+#include "MeshDensity.h"
+#include "VertexArena.h"
 #include "Vertexes.h"
 #include "ShadowVertexes.h"
 #include "BackOfFoldVertexes.h"
-#include "VertexProgram.h"
-#include "ShadowVertexProgram.h"
-#include "BackOfFoldVertexProgram.h"
+#include "TwoSidedFoldVertexes.h"
+#include "FoldCylinder.h"
+#include "SinglePassVertexes.h"
+#include "FoldDeformVertexes.h"
+#include "FoldShadow.h"
+#include "GeometryWorker.h"
+#include "GeometryThreadPool.h"
+#include "GLRenderBackend.h"
+#include "GLES3RenderBackend.h"
+#include "EGLImageImporter.h"
+#include "PagePrefetcher.h"
+#include "PageStack.h"
 
 namespace eschao {
 
@@ -37,6 +49,10 @@ namespace eschao {
 static const int kMeshVertexPixels = 10;
 static const int kMeshCountThreshold = 20;
 
+// camera position on Z axis and far plane of projection
+static constexpr float kCameraEyeZ = 3000;
+static constexpr float kCameraFarZ = 6000;
+
 // The min page curl angle (5 degree)
 static const int kMinPageCurlAngle = 5;
 // The max page curl angle (5 degree)
@@ -58,6 +74,23 @@ static const float kWidthRatioOfClickToFlip = 0.5f;
 // width m_ratio of triggering restore flip
 static const float kWidthOfRatioOfRestoreFlip = 0.4f;
 
+// max pages of burst flip and default phase delay between two pages
+static const int kMaxBurstPages = 8;
+static const float kBurstStagger = 0.1f;
+
+// min mesh steps of one geometry thread, fewer steps are not worth waking
+// up a thread. Release build of pageflip_geometry_bench measures one slope
+// step at 0.058us and a dispatch to a worker on the same core at 1.8us, that
+// is 31 steps. Waking a worker on another core costs more than a context
+// switch, so the limit keeps a margin of 2x: 64 steps are 3.7us of work
+static const int kMinStepsOfGeometryThread = 64;
+
+// max animations whose keyframes are cached, the least recently played one
+// is dropped if cache is full
+static const int kMaxKeyframeTracks = 4;
+// max keyframes of one animation
+static const int kMaxAnimationKeyframes = 240;
+
 // folder page shadow color buffer size
 static const int kFoldTopEdgeShadowVexCount = 22;
 
@@ -114,6 +147,7 @@ public:
     void drawFlipFrame();
     void drawPageFrame();
     int setGradientLightTexture(AndroidBitmapInfo& info, GLvoid* data);
+    int setTextureOfPage(int index, bool isFirstPage, int pageIndex);
 
     inline Page* getPage(bool isFirst) {
         return mPages[isFirst ? FIRST_PAGE : SECOND_PAGE];
@@ -136,8 +170,194 @@ public:
         return Error::OK;
     }
 
-    inline void setPixelsOfMesh(int pixels) {
-        mPixelsOfMesh = pixels > 0 ? mPixelsOfMesh : kMeshVertexPixels;
+    inline void enableSinglePass(bool isEnable) {
+        mIsSinglePass = isEnable;
+    }
+
+    inline bool isSinglePassEnabled() {
+        return mIsSinglePass;
+    }
+
+    /**
+     * Enable fold deformation in vertex shader
+     * <p>Only key points of fold are computed in CPU, the static page grid
+     * is mapped onto fold cylinder by GPU. It needs the default OpenGL ES
+     * backend, otherwise the vertexes are still computed in CPU. It takes
+     * effect from the next finger moving or animating step</p>
+     */
+    inline void enableGPUDeform(bool isEnable) {
+        mIsGPUDeform = isEnable;
+    }
+
+    inline bool isGPUDeformEnabled() {
+        return mIsGPUDeform;
+    }
+
+    /**
+     * Enable analytic fold shadows
+     * <p>Edge and base shadows are evaluated in page shading instead of
+     * being built as meshes, see {@link FoldShadow}. It needs backend
+     * support and isn't used by single pass drawing. It takes effect from
+     * the next finger moving or animating step</p>
+     */
+    inline void enableAnalyticShadow(bool isEnable) {
+        clearKeyframes();
+        mIsAnalyticShadow = isEnable;
+    }
+
+    inline bool isAnalyticShadowEnabled() {
+        return mIsAnalyticShadow;
+    }
+
+    /**
+     * Enable fold clipping of flat page
+     * <p>The flat page is drawn as one quad, its fragments pick the first
+     * or second texture by side of fold line, so the page polygon isn't
+     * split in every frame. Splitting polygon is still used if backend
+     * doesn't support it, in single pass drawing and burst flip. It should
+     * be disabled on GPUs where branching in fragment shader is expensive.
+     * It takes effect from the next finger moving or animating step</p>
+     */
+    inline void enableFoldClip(bool isEnable) {
+        clearKeyframes();
+        mIsFoldClip = isEnable;
+    }
+
+    inline bool isFoldClipEnabled() {
+        return mIsFoldClip;
+    }
+
+    /**
+     * Enable pipelined geometry
+     * <p>Meshes of the next frame are computed in a geometry thread while
+     * the current frame is drawn in GL thread, the drawn frame is one step
+     * behind finger moving and animating. Burst flip and GPU deformation
+     * are still computed in GL thread</p>
+     */
+    int enablePipelinedGeometry(bool isEnable);
+
+    inline bool isPipelinedGeometryEnabled() {
+        return mGeometryWorker.isRunning();
+    }
+
+    /**
+     * Set thread count of computing mesh steps
+     * <p>Steps of back and front strips are split across threads when page
+     * flip is slope, it is single threaded if mesh count is small</p>
+     *
+     * @param count thread count, [1 .. kMaxGeometryThreads], 1 means all
+     *              steps are computed in one thread
+     * @return Error::OK if successfully
+     */
+    inline int setGeometryThreads(int count) {
+        mGeometryWorker.wait();
+        return mGeometryPool.setThreads(count);
+    }
+
+    inline int geometryThreads() {
+        return mGeometryPool.threads();
+    }
+
+    /**
+     * Set keyframe count of animations, 0 disables keyframe cache
+     * <p>Touch point of animation is snapped to keyframes which are even
+     * steps from start to end point. Meshes of keyframes are recorded when
+     * animation is played for the first time and copied back when the
+     * animation with the same start and end point is played again, like
+     * click to flip. Cache is cleared if surface, pages or mesh settings
+     * are changed. Burst flip and GPU deformation aren't cached</p>
+     * <p>Meshes of all keyframes of {@link #kMaxKeyframeTracks} tracks are
+     * allocated in vertex arena with mesh buffers, so recording doesn't
+     * allocate memory in animating. It can't be changed in flipping</p>
+     *
+     * @param count keyframes of an animation, [0 .. kMaxAnimationKeyframes]
+     * @return Error::OK if successfully
+     */
+    int setAnimationKeyframes(int count);
+
+    inline int animationKeyframes() {
+        return mAnimationKeyframes;
+    }
+
+    /**
+     * Set render backend, NULL means the default OpenGL ES backend
+     * <p>It should be set before surface is created since textures and
+     * programs belong to backend. Single pass drawing needs uber shader, it
+     * is ignored by non-GL backends</p>
+     */
+    inline void setRenderBackend(RenderBackend *backend) {
+        mBackend = backend ? backend : &mGLBackend;
+    }
+
+    /**
+     * Select built-in GL backend, it takes effect when surface is created
+     * <p>Textures and programs of current surface belong to the backend in
+     * use, so the request is only stored here and it can't be changed while
+     * page is flipping. GLES3 backend falls back to GLES2 one if context
+     * doesn't support OpenGL ES 3.0</p>
+     */
+    inline int setRenderBackendType(int type) {
+        if (type != GLES2_RENDER_BACKEND && type != GLES3_RENDER_BACKEND) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
+
+        if (!isEndedFlip()) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
+
+        mBackendType = (RenderBackendType)type;
+        return Error::OK;
+    }
+
+    /**
+     * Get built-in GL backend in use, it differs from the requested one
+     * before surface is created or when GLES3 backend falls back
+     */
+    inline RenderBackendType renderBackendType() {
+        return mBackend == &mGLES3Backend ? GLES3_RENDER_BACKEND
+                                          : GLES2_RENDER_BACKEND;
+    }
+
+    inline RenderBackend& renderBackend() {
+        return *mBackend;
+    }
+
+    inline void enableDepthFree(bool isEnable) {
+        mIsDepthFree = isEnable;
+    }
+
+    inline bool isDepthFreeEnabled() {
+        return mIsDepthFree;
+    }
+
+    int setBurstFlip(int pages, float stagger);
+
+    inline int burstPages() {
+        return mBurstPages;
+    }
+
+    // pages flipped by the current or the last forward flip
+    inline int burstingPages() {
+        return mBurstedPages;
+    }
+
+    /**
+     * Set pixels of one mesh, it can't be changed in flipping since buffers
+     * are sized by it and the meshes on screen would be lost
+     */
+    inline int setPixelsOfMesh(int pixels) {
+        if (!isEndedFlip()) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
+
+        mPixelsOfMesh = pixels > 0 ? pixels : kMeshVertexPixels;
+
+        // buffers are sized by pixels of mesh
+        if (mMaxMeshCount > 0) {
+            computeMaxMeshCount();
+        }
+
+        return Error::OK;
     }
 
     inline int setSemiPerimeterRatio(float ratio) {
@@ -145,42 +365,86 @@ public:
             return gError.set(Error::ERR_INVALID_PARAMETER);
         }
 
+        clearKeyframes();
         mSemiPerimeterRatio = ratio;
         return Error::OK;
     }
 
     inline int setMaskAlphaOfFold(int alpha) {
-        return mBackOfFoldVertexes.setMaskAlpha(alpha);
+        mMeshes[1].backOfFold.setMaskAlpha(alpha);
+        return mMeshes[0].backOfFold.setMaskAlpha(alpha);
     }
 
     inline int setShadowColorOfFoldEdges(float startColor,
                                          float startAlpha,
                                          float endColor,
                                          float endAlpha) {
-        return mFoldEdgeShadowVertexes.color.set(startColor, startAlpha,
-                                                     endColor, endAlpha);
+        clearKeyframes();
+        mMeshes[1].edgeShadow.color.set(startColor, startAlpha,
+                                        endColor, endAlpha);
+        return mMeshes[0].edgeShadow.color.set(startColor, startAlpha,
+                                               endColor, endAlpha);
     }
 
     inline int setShadowColorOfFoldBase(float startColor,
                                         float startAlpha,
                                         float endColor,
                                         float endAlpha) {
-        return mFoldBaseShadowVertexes.color.set(startColor, startAlpha,
-                                                     endColor, endAlpha);
+        clearKeyframes();
+        mMeshes[1].baseShadow.color.set(startColor, startAlpha,
+                                        endColor, endAlpha);
+        return mMeshes[0].baseShadow.color.set(startColor, startAlpha,
+                                               endColor, endAlpha);
     }
 
     inline int setShadowWidthOfFoldEdges(float min,
                                          float max,
                                          float ratio) {
+        clearKeyframes();
         return mFoldEdgeShadowWidth.set(min, max, ratio);
     }
 
     inline int setShadowWidthOfFoldBase(float min,
                                         float max,
                                         float ratio) {
+        clearKeyframes();
         return mFoldBaseShadowWidth.set(min, max, ratio);
     }
 
+    inline int setMeshDensityMode(int mode) {
+        clearKeyframes();
+        return mMeshDensity.setMode(mode);
+    }
+
+    inline int setMeshTolerance(float tolerance) {
+        clearKeyframes();
+        return mMeshDensity.setTolerance(tolerance);
+    }
+
+    inline int setFrameBudget(float ms) {
+        clearKeyframes();
+        return mMeshDensity.setFrameBudget(ms);
+    }
+
+    inline MeshDensity& meshDensity() {
+        return mMeshDensity;
+    }
+
+    inline int meshCount() {
+        return mMeshCount;
+    }
+
+    /**
+     * Get fraction of surface touched by blended shadow passes of the last
+     * flip frame
+     * <p>Blended passes are scissored by bounds of fold, it is the area of
+     * scissor divided by surface area, the largest one if there are more
+     * fold pages. It is 0 if there is no blended pass</p>
+     */
+    inline float blendCoverage() {
+        return mBlendCoverage;
+    }
+
     inline int surfaceWidth() {
         return (int) mViewRect.surfaceWidth;
     }
@@ -197,6 +461,24 @@ public:
         return mPixelsOfMesh;
     }
 
+    inline TextureImporter& textureImporter() {
+        return mTextureImporter;
+    }
+
+    inline PagePrefetcher& prefetcher() {
+        return mPrefetcher;
+    }
+
+    int setPageStack(int maxLayers, float layerWidth);
+
+    inline int setBookProgress(float progress) {
+        return mPageStack.setProgress(progress);
+    }
+
+    inline PageStack& pageStack() {
+        return mPageStack;
+    }
+
     inline bool hasSecondPage() {
         return mPages[SECOND_PAGE] != NULL;
     }
@@ -240,34 +522,64 @@ public:
 
 private:
     void createPages();
+    void layoutPages();
+    void updateMVPMatrix();
     void computeScrollPointsForClickingFlip(float x,
                                             bool canForward,
                                             bool canBackward,
                                             PointF &start,
                                             PointF &end);
     void computeMaxMeshCount();
+    void drawFlipFrameInSinglePass();
+    void drawFlipFrameWithGPUDeform();
+    void updateFoldShadow(FoldShadow &foldShadow);
+    void computeFoldLine(float *foldLine);
+    void computeFoldBounds();
+    const int* updateBlendScissor();
+    void drawFlipFrameInPainterOrder();
+    void computeBurstPages();
+    void drawBurstFrame();
+    void addBurstPage(RenderBackend *backend, Page &page,
+                      bool isBottom, bool isTop);
+    float burstProgressOf(int index);
+    void buildSinglePassVertexes(Page &page, Page *secondPage);
     void computeVertexesBuildPage();
+    void computeVertexes();
+    void computeMeshes();
+    void clearKeyframes();
+    void selectKeyframeTrack(const PointF &start, const PointF &end);
+    void snapToKeyframe();
+    bool replayKeyframe();
+    void recordKeyframe();
+    static void computeMeshesInWorker(void *self);
     void computeKeyVertexesWhenVertical();
     void computeVertexesWhenVertical();
     void computeKeyVertexesWhenSlope();
     void computeVertexesWhenSlope();
-    void computeBackVertex(bool isX, float x0, float y0, float sx0,
-                           float sy0, float xfx, float sinA, float cosA,
-                           float texX, float texY, float oX, float oY);
-    void computeBackVertex(float x0, float y0, float xfx,
-                           float sinA, float cosA, float texX, float texY,
-                           float oX, float oY);
-    void computeFrontVertex(bool isX, float x0, float y0, float xfx,
-                            float sinA, float cosA, float baseWCosA,
-                            float baseWSinA, float texX, float texY,
-                            float oX, float oY);
-    void computeFrontVertex(float x0, float y0, float xfx,
-                            float sinA, float cosA, float texX, float texY,
-                            float oX, float oY);
-    void computeBaseShadowLastVertex(float x0, float y0, float xfs,
-                                     float sinA, float cosA,
+    void computeSlopeSteps(int begin, int end);
+    static void computeSlopeStepsInPool(void *self, int begin, int end);
+    template <bool HasShadow>
+    void computeBackStepsInPage(int begin, int end);
+    template <bool HasShadow>
+    void computeBackStepsOutPage(int begin, int end);
+    template <bool HasShadow>
+    void computeFrontStepsInPage(int begin, int end);
+    template <bool HasShadow>
+    void computeFrontStepsOutPage(int begin, int end);
+    void setBackVertex(int index, int shadowOffset,
+                       float x0, float y0, float sx0, float sy0,
+                       float texX, float texY);
+    void setBackVertex(int index, float x0, float y0, float texX, float texY);
+    void setFrontVertex(int index, int shadowOffset, float x0, float y0,
+                        float texX, float texY);
+    void setFrontVertex(int index, float x0, float y0,
+                        float texX, float texY);
+    void setEdgeShadowVertex(int offset, const float *v,
+                             float sx0, float sy0);
+    void setBaseShadowVertex(int offset, const float *v);
+    void computeBaseShadowLastVertex(float x0, float y0,
                                      float baseWCosA, float baseWSinA,
-                                     float oX, float oY, float dY);
+                                     float dY);
     void computeVertexesOfFoldTopEdgeShadow(float x0, float y0,
                                             float sinA, float cosA,
                                             float sx, float sy);
@@ -275,6 +587,117 @@ private:
     float computeTanOfCurlAngle(float dy);
     void printInfo();
 
+    inline bool isGPUDeforming() {
+        return mIsGPUDeform && mBackend == &mGLBackend && mBurstingPages <= 1;
+    }
+
+    inline bool isAnalyticShadowing() {
+        return mIsAnalyticShadow && mBackend->isFoldShadowSupported() &&
+               mBurstingPages <= 1 &&
+               !(mIsSinglePass && mBackend == &mGLBackend);
+    }
+
+    inline bool isFoldClipping() {
+        return mIsFoldClip && mBackend->isFoldClipSupported() &&
+               mBurstingPages <= 1 &&
+               !(mIsSinglePass && mBackend == &mGLBackend);
+    }
+
+    inline bool isPipelining() {
+        return mGeometryWorker.isRunning() && mBurstingPages <= 1 &&
+               !isGPUDeforming();
+    }
+
+    // kernel computing mesh steps [begin .. end) of one slope strip, every
+    // combination of strip and shadow mesh is a branch free kernel
+    typedef void (PageFlip::*StepKernel)(int begin, int end);
+    static const int SLOPE_STRIP_COUNT = 4;
+    static const StepKernel kSlopeStepKernels[2][SLOPE_STRIP_COUNT];
+
+    // parameters of mesh steps when page flip is slope, a step only depends
+    // on its index and writes to the expanded index of buffers
+    struct SlopeSteps_ {
+        float oX, oY, dY, d2oY;
+        float oTexX, oTexY, dTexY;
+        float sinA, cosA;
+        float baseWCosA, baseWSinA;
+
+        // back of fold: the first point and steps of it and edge shadow
+        float backX, backY, backStepX, backStepY;
+        float edgeX, edgeY, edgeStepX, edgeStepY;
+        // front of fold: the first point and steps of it
+        float frontX, frontY, frontStepX, frontStepY;
+
+        // step count of strip and steps within page, vertex index and
+        // shadow offsets of the first steps within and outside page
+        int backCount;
+        int backInPage;
+        int backInIndex;
+        int backOutIndex;
+        int edgeForward;
+        int edgeBackward;
+        int edgeOutForward;
+
+        int frontCount;
+        int frontInPage;
+        int frontInIndex;
+        int frontOutIndex;
+        int baseForward;
+        int baseBackward;
+        int baseOutForward;
+    };
+
+    // meshes of one flip frame
+    struct FlipMeshes_ {
+        FlipMeshes_();
+
+        Vertexes foldFront;
+        BackOfFoldVertexes backOfFold;
+        ShadowVertexes edgeShadow;
+        ShadowVertexes baseShadow;
+        // vertex count of the first texture part of fold front
+        int frontVertexCount;
+        // shadows are meshes or evaluated by fold shadow in page shading
+        bool hasShadowMesh;
+        FoldShadow foldShadow;
+        // flat page is a quad clipped by fold line instead of polygons,
+        // fold front has only front of fold then
+        bool hasFoldClip;
+        float foldLine[3];
+        // bounding rect of back of fold and shadow meshes: left, bottom,
+        // right and top, left > right if it is empty
+        float foldBounds[4];
+
+        int set(VertexArena &arena, int meshCount, int frontCapacity);
+        int copy(const FlipMeshes_ &src);
+    };
+
+    // recorded meshes of one animation, animations with the same flip
+    // state, page corner, curling slope, start and end point share them
+    struct KeyframeTrack_ {
+        KeyframeTrack_();
+        ~KeyframeTrack_();
+
+        void allocate(int count);
+        void clear();
+
+        int flipState;
+        bool hasSecondPage;
+        float kValue;
+        PointF origin;
+        PointF start;
+        PointF end;
+        // tick of the last playing, the least recently played is replaced
+        unsigned int lastTick;
+        // meshes of keyframes, they are allocated and their buffers are set
+        // from vertex arena when mesh buffers are laid out, recording only
+        // copies into them
+        FlipMeshes_ *frames;
+        int frameCount;
+        // is keyframe recorded, cleared tracks keep their frames
+        std::vector<bool> isRecorded;
+    };
+
 private:
     // view size
     GLViewRect mViewRect;
@@ -351,26 +774,96 @@ private:
     float mLenOfT2O;
     // the cylinder radius
     float mRadius;
+    // cylinder kernel of current fold, float or fixed point at compile time
+    FoldCylinder<GeometryReal> mFoldCylinder;
     // the perimeter m_ratio of semi-cylinder based on mLenOfTouchOrigin;
     float mSemiPerimeterRatio;
     // Mesh count
     int mMeshCount;
+    // max mesh count which vertex buffers can hold
+    int mMaxMeshCount;
+    // fixed or adaptive mesh density
+    MeshDensity mMeshDensity;
 
     // edges shadow width of back of fold page
     ShadowWidth mFoldEdgeShadowWidth;
     // base shadow width of front of fold page
     ShadowWidth mFoldBaseShadowWidth;
 
-    // fold page and shadow mVertexes
-    Vertexes mFoldFrontVertexes;
-    BackOfFoldVertexes mBackOfFoldVertexes;
-    ShadowVertexes mFoldEdgeShadowVertexes;
-    ShadowVertexes mFoldBaseShadowVertexes;
-
-    // Shader program for openGL drawing
-    VertexProgram mVertexProg;
-    BackOfFoldVertexProgram mBackOfFoldVertexProg;
-    ShadowVertexProgram mShadowVertexProg;
+    // memory of all vertex buffers below
+    VertexArena mVertexArena;
+
+    // fold page and shadow meshes, geometry is computed into mComputing
+    // and drawn from mDrawing. They are the same one unless geometry is
+    // pipelined, then the second set is allocated too
+    FlipMeshes_ mMeshes[2];
+    FlipMeshes_ *mComputing;
+    FlipMeshes_ *mDrawing;
+    // back of fold and front page linked for two-sided drawing
+    TwoSidedFoldVertexes mTwoSidedFoldVertexes;
+
+    // evaluate fold shadows in page shading instead of shadow meshes
+    bool mIsAnalyticShadow;
+
+    // clip flat page by fold line in fragment shading
+    bool mIsFoldClip;
+
+    // scissor of blended shadow passes in pixels: x, y, width and height,
+    // and its fraction of surface
+    int mBlendScissor[4];
+    float mBlendCoverage;
+
+    // compute meshes of the next frame while the current one is drawn,
+    // pending meshes are computed but not handed over to drawing yet
+    GeometryWorker mGeometryWorker;
+    bool mHasPendingMeshes;
+
+    // steps of slope strips are split across geometry pool
+    SlopeSteps_ mSlopeSteps;
+    const StepKernel *mSlopeKernels;
+    GeometryThreadPool mGeometryPool;
+
+    // meshes of animation keyframes, mTrack is the track of current
+    // animation and mKeyframe is the keyframe of current key vertexes,
+    // they are -1 if animation isn't cached
+    int mAnimationKeyframes;
+    KeyframeTrack_ mKeyframeTracks[kMaxKeyframeTracks];
+    unsigned int mKeyframeTick;
+    int mTrack;
+    int mKeyframe;
+
+    // all drawing goes through backend, it is OpenGL ES backend by default
+    GLRenderBackend mGLBackend;
+    GLES3RenderBackend mGLES3Backend;
+    RenderBackend *mBackend;
+    // built-in backend requested, it is applied when surface is created
+    RenderBackendType mBackendType;
+
+    // draw without depth buffer, meshes are drawn from back to front
+    bool mIsDepthFree;
+
+    // draw the whole flip frame with one draw call
+    bool mIsSinglePass;
+    SinglePassVertexes mSinglePassVertexes;
+
+    // deform static page grid in vertex shader, burst flip is still
+    // computed in CPU since its pages share single pass buffer
+    bool mIsGPUDeform;
+    FoldDeformVertexes mFoldDeformVertexes;
+
+    // burst flip: several pages are flipped forward by one gesture, they
+    // follow the same path with staggered phases. mBurstingPages is reset
+    // by finger down, mBurstedPages is kept for querying after animation
+    int mBurstPages;
+    float mBurstStagger;
+    int mBurstingPages;
+    int mBurstedPages;
+    // meshes of burst pages which aren't flipped out, from the bottom to
+    // the top. They are computed in animating and only drawn by drawing,
+    // the top page is the last one if it isn't flipped out
+    FlipMeshes_ mBurstMeshes[kMaxBurstPages];
+    int mBurstMeshCount;
+    bool mHasBurstTop;
 
     // is vertical page flip
     bool mIsVertical;
@@ -379,6 +872,15 @@ private:
     // use for flip animation
     Scroller mScroller;
 
+    // import hardware buffer as page texture without copying
+    EGLImageImporter mTextureImporter;
+
+    // decode pages in worker threads before they are shown
+    PagePrefetcher mPrefetcher;
+
+    // thickness of remaining pages on the outer edges of book
+    PageStack mPageStack;
+
     // pages and page mode
     // in single page mode, there is only one page in the index 0
     // in double pages mode, there are two pages, the first one is always active
@@ -14,10 +14,14 @@
  * limitations under the License.
  */
 
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <sys/system_properties.h>
 #include <android/log.h>
 #include <android/bitmap.h>
 #include "PageFlip.h"
 #include "PageFlipJNI.h"
+#include "CommandBuffer.h"
 
 using namespace eschao;
 
@@ -86,8 +90,144 @@ static JNINativeMethod gMethodsTable[] = {
         { "getPageHeight", "(Z)I", (void *)JNI_GetPageHeight },
         { "isLeftPage", "(Z)Z", (void *)JNI_IsLeftPage },
         { "isRightPage", "(Z)Z", (void *)JNI_IsRightPage },
+        { "enableSinglePass", "(Z)I", (void *)JNI_EnableSinglePass },
+        { "isSinglePassEnabled", "()Z", (void *)JNI_IsSinglePassEnabled },
+        { "enableGPUDeform", "(Z)I", (void *)JNI_EnableGPUDeform },
+        { "isGPUDeformEnabled", "()Z", (void *)JNI_IsGPUDeformEnabled },
+        { "enableAnalyticShadow", "(Z)I", (void *)JNI_EnableAnalyticShadow },
+        { "isAnalyticShadowEnabled", "()Z",
+          (void *)JNI_IsAnalyticShadowEnabled },
+        { "enableFoldClip", "(Z)I", (void *)JNI_EnableFoldClip },
+        { "isFoldClipEnabled", "()Z", (void *)JNI_IsFoldClipEnabled },
+        { "enablePipelinedGeometry", "(Z)I",
+          (void *)JNI_EnablePipelinedGeometry },
+        { "isPipelinedGeometryEnabled", "()Z",
+          (void *)JNI_IsPipelinedGeometryEnabled },
+        { "setGeometryThreads", "(I)I", (void *)JNI_SetGeometryThreads },
+        { "getGeometryThreads", "()I", (void *)JNI_GetGeometryThreads },
+        { "setAnimationKeyframes", "(I)I",
+          (void *)JNI_SetAnimationKeyframes },
+        { "getAnimationKeyframes", "()I",
+          (void *)JNI_GetAnimationKeyframes },
+        { "enableDepthFree", "(Z)I", (void *)JNI_EnableDepthFree },
+        { "isDepthFreeEnabled", "()Z", (void *)JNI_IsDepthFreeEnabled },
+        { "setMeshDensityMode", "(I)I", (void *)JNI_SetMeshDensityMode },
+        { "getMeshDensityMode", "()I", (void *)JNI_GetMeshDensityMode },
+        { "setMeshTolerance", "(F)I", (void *)JNI_SetMeshTolerance },
+        { "getMeshTolerance", "()F", (void *)JNI_GetMeshTolerance },
+        { "setFrameBudget", "(F)I", (void *)JNI_SetFrameBudget },
+        { "getFrameTime", "()F", (void *)JNI_GetFrameTime },
+        { "getMeshCount", "()I", (void *)JNI_GetMeshCount },
+        { "getBlendCoverage", "()F", (void *)JNI_GetBlendCoverage },
+        { "isHardwareTextureSupported", "()Z",
+          (void *)JNI_IsHardwareTextureSupported },
+        { "setFirstTexture", "(ZLjava/lang/Object;I)I",
+          (void *)JNI_SetFirstHardwareTexture },
+        { "setSecondTexture", "(ZLjava/lang/Object;I)I",
+          (void *)JNI_SetSecondHardwareTexture },
+        { "setBackTexture", "(ZLjava/lang/Object;I)I",
+          (void *)JNI_SetBackHardwareTexture },
+        { "isPrefetchSupported", "()Z",
+          (void *)JNI_IsPrefetchSupported },
+        { "startPrefetcher", "(IIJ)I", (void *)JNI_StartPrefetcher },
+        { "stopPrefetcher", "()I", (void *)JNI_StopPrefetcher },
+        { "setPrefetchPageSize", "(II)I", (void *)JNI_SetPrefetchPageSize },
+        { "setPageSource", "(I[B)I", (void *)JNI_SetPageSource },
+        { "removePageSource", "(I)I", (void *)JNI_RemovePageSource },
+        { "clearPageSources", "()I", (void *)JNI_ClearPageSources },
+        { "prefetchPages", "(IZ)I", (void *)JNI_PrefetchPages },
+        { "setFirstTextureOfPage", "(ZI)I",
+          (void *)JNI_SetFirstTextureOfPage },
+        { "setSecondTextureOfPage", "(ZI)I",
+          (void *)JNI_SetSecondTextureOfPage },
+        { "setBackTextureOfPage", "(ZI)I", (void *)JNI_SetBackTextureOfPage },
+        { "getPrefetchHitRate", "()F", (void *)JNI_GetPrefetchHitRate },
+        { "getPrefetchDecodeTime", "()F",
+          (void *)JNI_GetPrefetchDecodeTime },
+        { "getPrefetchMemory", "()J", (void *)JNI_GetPrefetchMemory },
+        { "executeCommands", "(Ljava/nio/ByteBuffer;)I",
+          (void *)JNI_ExecuteCommands },
+        { "setRenderBackend", "(I)I", (void *)JNI_SetRenderBackend },
+        { "getRenderBackend", "()I", (void *)JNI_GetRenderBackend },
+        { "setPageStack", "(IF)I", (void *)JNI_SetPageStack },
+        { "setBookProgress", "(F)I", (void *)JNI_SetBookProgress },
+        { "setBurstFlip", "(IF)I", (void *)JNI_SetBurstFlip },
+        { "getBurstingPages", "()I", (void *)JNI_GetBurstingPages },
+
+        // regular twins of critical getters for JNICallBenchmark
+        { "getFlipStateRegular", "()I", (void *)JNI_GetFlipState },
+        { "isAnimatingRegular", "()Z", (void *)JNI_IsAnimating },
+        { "isFirstTextureSetRegular", "(Z)Z",
+          (void *)JNI_IsFirstTextureSet },
 };
 
+// @CriticalNative is supported since Android 8.0
+static const int kCriticalNativeApiLevel = 26;
+
+/**
+ * Critical natives of primitive-only methods annotated with @CriticalNative
+ * <p>ART calls them without JNIEnv and jclass, they are only registered on
+ * Android 8.0+, old devices ignore the annotation and keep calling the
+ * regular natives in gMethodsTable.</p>
+ * <p>They must not call back into Java, block or run for long, GC can't
+ * suspend the thread during a critical native call. So only trivial getters
+ * are critical, finger events and drawing may wait for geometry worker and
+ * stay regular natives.</p>
+ */
+static jint JNI_CriticalGetError() {
+    return JNI_GetError(NULL, NULL);
+}
+
+static jboolean JNI_CriticalIsAnimating() {
+    return JNI_IsAnimating(NULL, NULL);
+}
+
+static jint JNI_CriticalGetFlipState() {
+    return JNI_GetFlipState(NULL, NULL);
+}
+
+static jboolean JNI_CriticalHasFirstPage() {
+    return JNI_HasFirstPage(NULL, NULL);
+}
+
+static jboolean JNI_CriticalHasSecondPage() {
+    return JNI_HasSecondPage(NULL, NULL);
+}
+
+static jboolean JNI_CriticalIsFirstTextureSet(jboolean is_first_page) {
+    return JNI_IsFirstTextureSet(NULL, NULL, is_first_page);
+}
+
+static jboolean JNI_CriticalIsSecondTextureSet(jboolean is_first_page) {
+    return JNI_IsSecondTextureSet(NULL, NULL, is_first_page);
+}
+
+static jboolean JNI_CriticalIsBackTextureSet(jboolean is_first_page) {
+    return JNI_IsBackTextureSet(NULL, NULL, is_first_page);
+}
+
+static JNINativeMethod gCriticalMethodsTable[] = {
+        { "getError", "()I", (void *)JNI_CriticalGetError },
+        { "isAnimating", "()Z", (void *)JNI_CriticalIsAnimating },
+        { "getFlipState", "()I", (void *)JNI_CriticalGetFlipState },
+        { "hasFirstPage", "()Z", (void *)JNI_CriticalHasFirstPage },
+        { "hasSecondPage", "()Z", (void *)JNI_CriticalHasSecondPage },
+        { "isFirstTextureSet", "(Z)Z",
+          (void *)JNI_CriticalIsFirstTextureSet },
+        { "isSecondTextureSet", "(Z)Z",
+          (void *)JNI_CriticalIsSecondTextureSet },
+        { "isBackTextureSet", "(Z)Z", (void *)JNI_CriticalIsBackTextureSet },
+};
+
+static int getApiLevel() {
+    char value[PROP_VALUE_MAX] = { 0 };
+    if (__system_property_get("ro.build.version.sdk", value) < 1) {
+        return 0;
+    }
+
+    return atoi(value);
+}
+
 static bool registerNatives(JNIEnv* env) {
     jclass cls = env->FindClass(gClassName);
     if (cls == NULL) {
@@ -100,6 +240,16 @@ static bool registerNatives(JNIEnv* env) {
         return JNI_FALSE;
     }
 
+    // replace regular natives with critical ones if they are supported
+    if (getApiLevel() >= kCriticalNativeApiLevel) {
+        size = sizeof(gCriticalMethodsTable) / sizeof(JNINativeMethod);
+        ret = env->RegisterNatives(cls, gCriticalMethodsTable, size);
+        if (ret < 0) {
+            LOGE(TAG, "Failed to register critical natives!");
+            return JNI_FALSE;
+        }
+    }
+
     return JNI_TRUE;
 }
 
@@ -201,8 +351,7 @@ JNIEXPORT jint JNICALL JNI_SetPixelsOfMesh(JNIEnv* env,
                                            jint pixels) {
     gError.reset();
     if (gPageFlip) {
-        gPageFlip->setPixelsOfMesh(pixels);
-        return Error::OK;
+        return gPageFlip->setPixelsOfMesh(pixels);
     }
     else {
         LOGE("JNI_SetPixelsOfMesh",
@@ -933,3 +1082,818 @@ JNIEXPORT jint JNICALL JNI_RecycleTextures(JNIEnv* env, jobject obj) {
         return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
     }
 }
+
+JNIEXPORT jint JNICALL JNI_EnableSinglePass(JNIEnv* env,
+                                            jobject obj,
+                                            jboolean enable) {
+    gError.reset();
+    if (gPageFlip) {
+        gPageFlip->enableSinglePass(enable);
+        return Error::OK;
+    }
+    else {
+        LOGE("JNI_EnableSinglePass",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jboolean JNICALL JNI_IsSinglePassEnabled(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jboolean) gPageFlip->isSinglePassEnabled();
+    }
+    else {
+        LOGE("JNI_IsSinglePassEnabled",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL JNI_EnableGPUDeform(JNIEnv* env,
+                                           jobject obj,
+                                           jboolean enable) {
+    gError.reset();
+    if (gPageFlip) {
+        gPageFlip->enableGPUDeform(enable);
+        return Error::OK;
+    }
+    else {
+        LOGE("JNI_EnableGPUDeform",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jboolean JNICALL JNI_IsGPUDeformEnabled(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jboolean) gPageFlip->isGPUDeformEnabled();
+    }
+    else {
+        LOGE("JNI_IsGPUDeformEnabled",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL JNI_EnableAnalyticShadow(JNIEnv* env,
+                                                jobject obj,
+                                                jboolean enable) {
+    gError.reset();
+    if (gPageFlip) {
+        gPageFlip->enableAnalyticShadow(enable);
+        return Error::OK;
+    }
+    else {
+        LOGE("JNI_EnableAnalyticShadow",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jboolean JNICALL JNI_IsAnalyticShadowEnabled(JNIEnv* env,
+                                                       jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jboolean) gPageFlip->isAnalyticShadowEnabled();
+    }
+    else {
+        LOGE("JNI_IsAnalyticShadowEnabled",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL JNI_EnableFoldClip(JNIEnv* env,
+                                          jobject obj,
+                                          jboolean enable) {
+    gError.reset();
+    if (gPageFlip) {
+        gPageFlip->enableFoldClip(enable);
+        return Error::OK;
+    }
+    else {
+        LOGE("JNI_EnableFoldClip",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jboolean JNICALL JNI_IsFoldClipEnabled(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jboolean) gPageFlip->isFoldClipEnabled();
+    }
+    else {
+        LOGE("JNI_IsFoldClipEnabled",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL JNI_EnablePipelinedGeometry(JNIEnv* env,
+                                                   jobject obj,
+                                                   jboolean enable) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->enablePipelinedGeometry(enable);
+    }
+    else {
+        LOGE("JNI_EnablePipelinedGeometry",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jboolean JNICALL JNI_IsPipelinedGeometryEnabled(JNIEnv* env,
+                                                          jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jboolean) gPageFlip->isPipelinedGeometryEnabled();
+    }
+    else {
+        LOGE("JNI_IsPipelinedGeometryEnabled",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL JNI_SetGeometryThreads(JNIEnv* env,
+                                              jobject obj,
+                                              jint count) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setGeometryThreads(count);
+    }
+    else {
+        LOGE("JNI_SetGeometryThreads",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_GetGeometryThreads(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jint) gPageFlip->geometryThreads();
+    }
+    else {
+        LOGE("JNI_GetGeometryThreads",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetAnimationKeyframes(JNIEnv* env,
+                                                 jobject obj,
+                                                 jint count) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setAnimationKeyframes(count);
+    }
+    else {
+        LOGE("JNI_SetAnimationKeyframes",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_GetAnimationKeyframes(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jint) gPageFlip->animationKeyframes();
+    }
+    else {
+        LOGE("JNI_GetAnimationKeyframes",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_EnableDepthFree(JNIEnv* env,
+                                           jobject obj,
+                                           jboolean enable) {
+    gError.reset();
+    if (gPageFlip) {
+        gPageFlip->enableDepthFree(enable);
+        return Error::OK;
+    }
+    else {
+        LOGE("JNI_EnableDepthFree",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jboolean JNICALL JNI_IsDepthFreeEnabled(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jboolean) gPageFlip->isDepthFreeEnabled();
+    }
+    else {
+        LOGE("JNI_IsDepthFreeEnabled",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL JNI_SetMeshDensityMode(JNIEnv* env,
+                                              jobject obj,
+                                              jint mode) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setMeshDensityMode(mode);
+    }
+    else {
+        LOGE("JNI_SetMeshDensityMode",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_GetMeshDensityMode(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jint) gPageFlip->meshDensity().mode();
+    }
+    else {
+        LOGE("JNI_GetMeshDensityMode",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetMeshTolerance(JNIEnv* env,
+                                            jobject obj,
+                                            jfloat tolerance) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setMeshTolerance(tolerance);
+    }
+    else {
+        LOGE("JNI_SetMeshTolerance",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jfloat JNICALL JNI_GetMeshTolerance(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jfloat) gPageFlip->meshDensity().tolerance();
+    }
+    else {
+        LOGE("JNI_GetMeshTolerance",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return 0;
+}
+
+JNIEXPORT jint JNICALL JNI_SetFrameBudget(JNIEnv* env,
+                                          jobject obj,
+                                          jfloat ms) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setFrameBudget(ms);
+    }
+    else {
+        LOGE("JNI_SetFrameBudget",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jfloat JNICALL JNI_GetFrameTime(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jfloat) gPageFlip->meshDensity().frameTime();
+    }
+    else {
+        LOGE("JNI_GetFrameTime",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return 0;
+}
+
+JNIEXPORT jint JNICALL JNI_GetMeshCount(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jint) gPageFlip->meshCount();
+    }
+    else {
+        LOGE("JNI_GetMeshCount",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jfloat JNICALL JNI_GetBlendCoverage(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jfloat) gPageFlip->blendCoverage();
+    }
+    else {
+        LOGE("JNI_GetBlendCoverage",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return 0;
+}
+
+/**
+ * Get AHardwareBuffer from android.hardware.HardwareBuffer object
+ * <p>AHardwareBuffer_fromHardwareBuffer is only available since Android 8.0,
+ * it is loaded at runtime to keep the library working on old devices</p>
+ */
+static void* toAHardwareBuffer(JNIEnv* env, jobject buffer) {
+    typedef void* (*FromHardwareBufferFunc)(JNIEnv*, jobject);
+    static FromHardwareBufferFunc fromHardwareBuffer = NULL;
+    static bool isLoaded = false;
+
+    if (!isLoaded) {
+        isLoaded = true;
+        void *lib = dlopen("libandroid.so", RTLD_NOW);
+        if (lib) {
+            fromHardwareBuffer = (FromHardwareBufferFunc)
+                    dlsym(lib, "AHardwareBuffer_fromHardwareBuffer");
+        }
+    }
+
+    return fromHardwareBuffer ? fromHardwareBuffer(env, buffer) : NULL;
+}
+
+/**
+ * Convert Android color int(ARGB) to the color format used by textures
+ */
+static int toTextureColor(jint color) {
+    const int a = (color >> 24) & 0xFF;
+    const int r = (color >> 16) & 0xFF;
+    const int g = (color >> 8) & 0xFF;
+    const int b = color & 0xFF;
+    return ARGB(a, r, g, b);
+}
+
+static jint setHardwareTexture(JNIEnv* env,
+                               const char* tag,
+                               int index,
+                               jboolean is_first_page,
+                               jobject buffer,
+                               jint mask_color) {
+    gError.reset();
+    if (buffer == NULL && index != BACK_TEXTURE_ID) {
+        LOGE(tag, "Can't set texture with null HardwareBuffer object!");
+        return gError.set(Error::ERR_NULL_PARAMETER);
+    }
+    else if (gPageFlip) {
+        Page* page = gPageFlip->getPage(is_first_page);
+        if (page == NULL) {
+            return gError.set(Error::ERR_NULL_PAGE);
+        }
+
+        void *nativeBuffer = NULL;
+        if (buffer != NULL) {
+            nativeBuffer = toAHardwareBuffer(env, buffer);
+            if (nativeBuffer == NULL) {
+                return gError.set(Error::ERR_UNSUPPORT_HARDWARE_BUFFER);
+            }
+        }
+
+        TextureImporter& importer = gPageFlip->textureImporter();
+        const int color = toTextureColor(mask_color);
+        if (index == FIRST_TEXTURE_ID) {
+            return page->textures.setFirstTexture(importer, nativeBuffer,
+                                                  color);
+        }
+        else if (index == SECOND_TEXTURE_ID) {
+            return page->textures.setSecondTexture(importer, nativeBuffer,
+                                                   color);
+        }
+        return page->textures.setBackTexture(importer, nativeBuffer, color);
+    }
+    else {
+        LOGE(tag, "PageFlip object is null, please call init() first!");
+        return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    }
+}
+
+JNIEXPORT jboolean JNICALL JNI_IsHardwareTextureSupported(JNIEnv* env,
+                                                          jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jboolean) gPageFlip->textureImporter().isSupported();
+    }
+    else {
+        LOGE("JNI_IsHardwareTextureSupported",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL JNI_SetFirstHardwareTexture(JNIEnv* env,
+                                                   jobject obj,
+                                                   jboolean is_first_page,
+                                                   jobject buffer,
+                                                   jint mask_color) {
+    return setHardwareTexture(env, "JNI_SetFirstHardwareTexture",
+                              FIRST_TEXTURE_ID, is_first_page, buffer,
+                              mask_color);
+}
+
+JNIEXPORT jint JNICALL JNI_SetSecondHardwareTexture(JNIEnv* env,
+                                                    jobject obj,
+                                                    jboolean is_first_page,
+                                                    jobject buffer,
+                                                    jint mask_color) {
+    return setHardwareTexture(env, "JNI_SetSecondHardwareTexture",
+                              SECOND_TEXTURE_ID, is_first_page, buffer,
+                              mask_color);
+}
+
+JNIEXPORT jint JNICALL JNI_SetBackHardwareTexture(JNIEnv* env,
+                                                  jobject obj,
+                                                  jboolean is_first_page,
+                                                  jobject buffer,
+                                                  jint mask_color) {
+    return setHardwareTexture(env, "JNI_SetBackHardwareTexture",
+                              BACK_TEXTURE_ID, is_first_page, buffer,
+                              mask_color);
+}
+
+JNIEXPORT jboolean JNICALL JNI_IsPrefetchSupported(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jboolean) gPageFlip->prefetcher().isSupported();
+    }
+    else {
+        LOGE("JNI_IsPrefetchSupported",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL JNI_StartPrefetcher(JNIEnv* env,
+                                           jobject obj,
+                                           jint thread_count,
+                                           jint page_count,
+                                           jlong budget) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->prefetcher().start(thread_count, page_count,
+                                                (size_t)budget);
+    }
+    else {
+        LOGE("JNI_StartPrefetcher",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_StopPrefetcher(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        gPageFlip->prefetcher().stop();
+        return Error::OK;
+    }
+    else {
+        LOGE("JNI_StopPrefetcher",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetPrefetchPageSize(JNIEnv* env,
+                                               jobject obj,
+                                               jint width,
+                                               jint height) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->prefetcher().setPageSize(width, height);
+    }
+    else {
+        LOGE("JNI_SetPrefetchPageSize",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetPageSource(JNIEnv* env,
+                                         jobject obj,
+                                         jint page_index,
+                                         jbyteArray data) {
+    gError.reset();
+    if (gPageFlip) {
+        if (data == NULL) {
+            return gError.set(Error::ERR_NULL_PARAMETER);
+        }
+
+        jsize size = env->GetArrayLength(data);
+        jbyte *bytes = env->GetByteArrayElements(data, NULL);
+        if (bytes == NULL) {
+            return gError.set(Error::ERR_NULL_PARAMETER);
+        }
+
+        int ret = gPageFlip->prefetcher().setSource(page_index, bytes,
+                                                    (size_t)size);
+        env->ReleaseByteArrayElements(data, bytes, JNI_ABORT);
+        return ret;
+    }
+    else {
+        LOGE("JNI_SetPageSource",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_RemovePageSource(JNIEnv* env,
+                                            jobject obj,
+                                            jint page_index) {
+    gError.reset();
+    if (gPageFlip) {
+        gPageFlip->prefetcher().removeSource(page_index);
+        return Error::OK;
+    }
+    else {
+        LOGE("JNI_RemovePageSource",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_ClearPageSources(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        gPageFlip->prefetcher().clearSources();
+        return Error::OK;
+    }
+    else {
+        LOGE("JNI_ClearPageSources",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_PrefetchPages(JNIEnv* env,
+                                         jobject obj,
+                                         jint page_index,
+                                         jboolean is_forward) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->prefetcher().prefetch(page_index, is_forward);
+    }
+    else {
+        LOGE("JNI_PrefetchPages",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetFirstTextureOfPage(JNIEnv* env,
+                                                 jobject obj,
+                                                 jboolean is_first_page,
+                                                 jint page_index) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setTextureOfPage(FIRST_TEXTURE_ID,
+                                           is_first_page, page_index);
+    }
+    else {
+        LOGE("JNI_SetFirstTextureOfPage",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetSecondTextureOfPage(JNIEnv* env,
+                                                  jobject obj,
+                                                  jboolean is_first_page,
+                                                  jint page_index) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setTextureOfPage(SECOND_TEXTURE_ID,
+                                           is_first_page, page_index);
+    }
+    else {
+        LOGE("JNI_SetSecondTextureOfPage",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetBackTextureOfPage(JNIEnv* env,
+                                                jobject obj,
+                                                jboolean is_first_page,
+                                                jint page_index) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setTextureOfPage(BACK_TEXTURE_ID,
+                                           is_first_page, page_index);
+    }
+    else {
+        LOGE("JNI_SetBackTextureOfPage",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jfloat JNICALL JNI_GetPrefetchHitRate(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jfloat) gPageFlip->prefetcher().hitRate();
+    }
+    else {
+        LOGE("JNI_GetPrefetchHitRate",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return 0;
+}
+
+JNIEXPORT jfloat JNICALL JNI_GetPrefetchDecodeTime(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jfloat) gPageFlip->prefetcher().decodeTime();
+    }
+    else {
+        LOGE("JNI_GetPrefetchDecodeTime",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return 0;
+}
+
+JNIEXPORT jlong JNICALL JNI_GetPrefetchMemory(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jlong) gPageFlip->prefetcher().memoryUsage();
+    }
+    else {
+        LOGE("JNI_GetPrefetchMemory",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+    return 0;
+}
+
+JNIEXPORT jint JNICALL JNI_ExecuteCommands(JNIEnv* env,
+                                           jobject obj,
+                                           jobject buffer) {
+    gError.reset();
+    if (gPageFlip) {
+        if (buffer == NULL) {
+            return gError.set(Error::ERR_NULL_PARAMETER);
+        }
+
+        void *data = env->GetDirectBufferAddress(buffer);
+        jlong size = env->GetDirectBufferCapacity(buffer);
+        if (data == NULL || size < 0) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
+
+        CommandBuffer commands(data, (size_t)size);
+        return commands.execute(*gPageFlip);
+    }
+    else {
+        LOGE("JNI_ExecuteCommands",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetRenderBackend(JNIEnv* env,
+                                            jobject obj,
+                                            jint type) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setRenderBackendType(type);
+    }
+    else {
+        LOGE("JNI_SetRenderBackend",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_GetRenderBackend(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jint) gPageFlip->renderBackendType();
+    }
+    else {
+        LOGE("JNI_GetRenderBackend",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetPageStack(JNIEnv* env,
+                                        jobject obj,
+                                        jint maxLayers,
+                                        jfloat layerWidth) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setPageStack(maxLayers, layerWidth);
+    }
+    else {
+        LOGE("JNI_SetPageStack",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetBookProgress(JNIEnv* env,
+                                           jobject obj,
+                                           jfloat progress) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setBookProgress(progress);
+    }
+    else {
+        LOGE("JNI_SetBookProgress",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_SetBurstFlip(JNIEnv* env,
+                                        jobject obj,
+                                        jint pages,
+                                        jfloat stagger) {
+    gError.reset();
+    if (gPageFlip) {
+        return gPageFlip->setBurstFlip(pages, stagger);
+    }
+    else {
+        LOGE("JNI_SetBurstFlip",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
+
+JNIEXPORT jint JNICALL JNI_GetBurstingPages(JNIEnv* env, jobject obj) {
+    gError.reset();
+    if (gPageFlip) {
+        return (jint) gPageFlip->burstingPages();
+    }
+    else {
+        LOGE("JNI_GetBurstingPages",
+             "PageFlip object is null, please call init() first!");
+    }
+
+    return gError.set(Error::ERR_PAGE_FLIP_UNINIT);
+}
@@ -145,6 +145,128 @@ JNIEXPORT jint JNICALL JNI_SetSecondTextureWithFirst(JNIEnv* env,
 JNIEXPORT jint JNICALL JNI_SwapSecondTexturesWithFirst(JNIEnv* env,
                                                        jobject obj);
 JNIEXPORT jint JNICALL JNI_RecycleTextures(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_EnableSinglePass(JNIEnv* env,
+                                            jobject obj,
+                                            jboolean enable);
+JNIEXPORT jboolean JNICALL JNI_IsSinglePassEnabled(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_EnableGPUDeform(JNIEnv* env,
+                                           jobject obj,
+                                           jboolean enable);
+JNIEXPORT jboolean JNICALL JNI_IsGPUDeformEnabled(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_EnableAnalyticShadow(JNIEnv* env,
+                                                jobject obj,
+                                                jboolean enable);
+JNIEXPORT jboolean JNICALL JNI_IsAnalyticShadowEnabled(JNIEnv* env,
+                                                       jobject obj);
+JNIEXPORT jint JNICALL JNI_EnableFoldClip(JNIEnv* env,
+                                          jobject obj,
+                                          jboolean enable);
+JNIEXPORT jboolean JNICALL JNI_IsFoldClipEnabled(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_EnablePipelinedGeometry(JNIEnv* env,
+                                                   jobject obj,
+                                                   jboolean enable);
+JNIEXPORT jboolean JNICALL JNI_IsPipelinedGeometryEnabled(JNIEnv* env,
+                                                          jobject obj);
+JNIEXPORT jint JNICALL JNI_SetGeometryThreads(JNIEnv* env,
+                                              jobject obj,
+                                              jint count);
+JNIEXPORT jint JNICALL JNI_GetGeometryThreads(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_SetAnimationKeyframes(JNIEnv* env,
+                                                 jobject obj,
+                                                 jint count);
+JNIEXPORT jint JNICALL JNI_GetAnimationKeyframes(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_EnableDepthFree(JNIEnv* env,
+                                           jobject obj,
+                                           jboolean enable);
+JNIEXPORT jboolean JNICALL JNI_IsDepthFreeEnabled(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_SetMeshDensityMode(JNIEnv* env,
+                                              jobject obj,
+                                              jint mode);
+JNIEXPORT jint JNICALL JNI_GetMeshDensityMode(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_SetMeshTolerance(JNIEnv* env,
+                                            jobject obj,
+                                            jfloat tolerance);
+JNIEXPORT jfloat JNICALL JNI_GetMeshTolerance(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_SetFrameBudget(JNIEnv* env,
+                                          jobject obj,
+                                          jfloat ms);
+JNIEXPORT jfloat JNICALL JNI_GetFrameTime(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_GetMeshCount(JNIEnv* env, jobject obj);
+JNIEXPORT jfloat JNICALL JNI_GetBlendCoverage(JNIEnv* env, jobject obj);
+JNIEXPORT jboolean JNICALL JNI_IsHardwareTextureSupported(JNIEnv* env,
+                                                          jobject obj);
+JNIEXPORT jint JNICALL JNI_SetFirstHardwareTexture(JNIEnv* env,
+                                                   jobject obj,
+                                                   jboolean is_first_page,
+                                                   jobject buffer,
+                                                   jint mask_color);
+JNIEXPORT jint JNICALL JNI_SetSecondHardwareTexture(JNIEnv* env,
+                                                    jobject obj,
+                                                    jboolean is_first_page,
+                                                    jobject buffer,
+                                                    jint mask_color);
+JNIEXPORT jint JNICALL JNI_SetBackHardwareTexture(JNIEnv* env,
+                                                  jobject obj,
+                                                  jboolean is_first_page,
+                                                  jobject buffer,
+                                                  jint mask_color);
+JNIEXPORT jboolean JNICALL JNI_IsPrefetchSupported(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_StartPrefetcher(JNIEnv* env,
+                                           jobject obj,
+                                           jint thread_count,
+                                           jint page_count,
+                                           jlong budget);
+JNIEXPORT jint JNICALL JNI_StopPrefetcher(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_SetPrefetchPageSize(JNIEnv* env,
+                                               jobject obj,
+                                               jint width,
+                                               jint height);
+JNIEXPORT jint JNICALL JNI_SetPageSource(JNIEnv* env,
+                                         jobject obj,
+                                         jint page_index,
+                                         jbyteArray data);
+JNIEXPORT jint JNICALL JNI_RemovePageSource(JNIEnv* env,
+                                            jobject obj,
+                                            jint page_index);
+JNIEXPORT jint JNICALL JNI_ClearPageSources(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_PrefetchPages(JNIEnv* env,
+                                         jobject obj,
+                                         jint page_index,
+                                         jboolean is_forward);
+JNIEXPORT jint JNICALL JNI_SetFirstTextureOfPage(JNIEnv* env,
+                                                 jobject obj,
+                                                 jboolean is_first_page,
+                                                 jint page_index);
+JNIEXPORT jint JNICALL JNI_SetSecondTextureOfPage(JNIEnv* env,
+                                                  jobject obj,
+                                                  jboolean is_first_page,
+                                                  jint page_index);
+JNIEXPORT jint JNICALL JNI_SetBackTextureOfPage(JNIEnv* env,
+                                                jobject obj,
+                                                jboolean is_first_page,
+                                                jint page_index);
+JNIEXPORT jfloat JNICALL JNI_GetPrefetchHitRate(JNIEnv* env, jobject obj);
+JNIEXPORT jfloat JNICALL JNI_GetPrefetchDecodeTime(JNIEnv* env, jobject obj);
+JNIEXPORT jlong JNICALL JNI_GetPrefetchMemory(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_ExecuteCommands(JNIEnv* env,
+                                           jobject obj,
+                                           jobject buffer);
+JNIEXPORT jint JNICALL JNI_SetRenderBackend(JNIEnv* env,
+                                            jobject obj,
+                                            jint type);
+JNIEXPORT jint JNICALL JNI_GetRenderBackend(JNIEnv* env, jobject obj);
+JNIEXPORT jint JNICALL JNI_SetPageStack(JNIEnv* env,
+                                        jobject obj,
+                                        jint maxLayers,
+                                        jfloat layerWidth);
+JNIEXPORT jint JNICALL JNI_SetBookProgress(JNIEnv* env,
+                                           jobject obj,
+                                           jfloat progress);
+JNIEXPORT jint JNICALL JNI_SetBurstFlip(JNIEnv* env,
+                                        jobject obj,
+                                        jint pages,
+                                        jfloat stagger);
+JNIEXPORT jint JNICALL JNI_GetBurstingPages(JNIEnv* env, jobject obj);
 }
 
 #endif //ANDROID_PAGEFLIP_PAGEFLIP_JNI_H
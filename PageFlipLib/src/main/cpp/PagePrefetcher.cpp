@@ -0,0 +1,496 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <time.h>
+#include "PagePrefetcher.h"
+#include "Error.h"
+#include "Utility.h"
+
+namespace eschao {
+
+static const auto TAG = "PagePrefetcher";
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+PagePrefetcher::PagePrefetcher()
+        : mIsRunning(false),
+          mThreadCount(0),
+          mPageCount(kDefaultPrefetchPages),
+          mWidth(0),
+          mHeight(0),
+          mCurrentIndex(-1),
+          mIsForward(true),
+          mSerial(0),
+          mBudget(kDefaultPrefetchBudget),
+          mUsedBytes(0),
+          mPeakBytes(0),
+          mHits(0),
+          mMisses(0),
+          mDecodeCount(0),
+          mDecodeTime(0) {
+    pthread_mutex_init(&mLock, NULL);
+    pthread_cond_init(&mTaskCond, NULL);
+    pthread_cond_init(&mReadyCond, NULL);
+}
+
+PagePrefetcher::~PagePrefetcher() {
+    stop();
+    clearSources();
+    pthread_cond_destroy(&mReadyCond);
+    pthread_cond_destroy(&mTaskCond);
+    pthread_mutex_destroy(&mLock);
+}
+
+/**
+ * Start worker threads
+ *
+ * @param threadCount worker threads, [1, kMaxPrefetchThreads]
+ * @param pageCount pages prefetched in each direction
+ * @param budget max bytes of decoded pages
+ * @return Error::OK if successfully
+ */
+int PagePrefetcher::start(int threadCount, int pageCount, size_t budget) {
+    if (threadCount < 1 || threadCount > kMaxPrefetchThreads ||
+        pageCount < 0 || budget < 1) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    if (!mDecoder.isSupported()) {
+        LOGE(TAG, "Native image decoder is not supported!");
+        return gError.set(Error::ERR_UNSUPPORT_IMAGE_DECODER);
+    }
+
+    stop();
+    mPageCount = pageCount;
+    mBudget = budget;
+    mIsRunning = true;
+    for (; mThreadCount < threadCount; ++mThreadCount) {
+        if (pthread_create(&mThreads[mThreadCount], NULL, run, this) != 0) {
+            LOGE(TAG, "Can't create prefetch thread %d", mThreadCount);
+            stop();
+            return gError.set(Error::ERROR);
+        }
+    }
+
+    return Error::OK;
+}
+
+/**
+ * Stop worker threads and release all decoded pages except locked ones
+ */
+void PagePrefetcher::stop() {
+    pthread_mutex_lock(&mLock);
+    mIsRunning = false;
+    mTasks.clear();
+    pthread_cond_broadcast(&mTaskCond);
+    pthread_mutex_unlock(&mLock);
+
+    for (int i = 0; i < mThreadCount; ++i) {
+        pthread_join(mThreads[i], NULL);
+    }
+    mThreadCount = 0;
+
+    pthread_mutex_lock(&mLock);
+    evictOutOf(0, -1);
+    mCurrentIndex = -1;
+    pthread_mutex_unlock(&mLock);
+}
+
+/**
+ * Set page size, pages are decoded and scaled to this size
+ */
+int PagePrefetcher::setPageSize(int width, int height) {
+    if (width < 1 || height < 1) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    pthread_mutex_lock(&mLock);
+    if (width != mWidth || height != mHeight) {
+        mWidth = width;
+        mHeight = height;
+        mTasks.clear();
+        evictOutOf(0, -1);
+    }
+    pthread_mutex_unlock(&mLock);
+    return Error::OK;
+}
+
+/**
+ * Set compressed image data of page, data is copied
+ *
+ * @param index page index
+ * @param data compressed image data, e.g. content of a PNG or JPEG file
+ * @param size size of data
+ * @return Error::OK if successfully
+ */
+int PagePrefetcher::setSource(int index, const void *data, size_t size) {
+    if (index < 0 || data == NULL || size < 1) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    const unsigned char *bytes = (const unsigned char *)data;
+    Source_ source(new std::vector<unsigned char>(bytes, bytes + size));
+
+    pthread_mutex_lock(&mLock);
+    mSources[index] = source;
+    evict(index);
+    pthread_mutex_unlock(&mLock);
+    return Error::OK;
+}
+
+void PagePrefetcher::removeSource(int index) {
+    pthread_mutex_lock(&mLock);
+    mSources.erase(index);
+    evict(index);
+    pthread_mutex_unlock(&mLock);
+}
+
+void PagePrefetcher::clearSources() {
+    pthread_mutex_lock(&mLock);
+    mSources.clear();
+    mTasks.clear();
+    evictOutOf(0, -1);
+    pthread_mutex_unlock(&mLock);
+}
+
+/**
+ * Prefetch pages around the given page
+ * <p>Pages out of window are evicted, and the pages in reading direction are
+ * queued before others. If reading direction is changed, all queued tasks
+ * are cancelled. Pages are not queued any more if memory budget is used
+ * up.</p>
+ *
+ * @param index current page index
+ * @param isForward is reading forward
+ * @return Error::OK if successfully
+ */
+int PagePrefetcher::prefetch(int index, bool isForward) {
+    if (index < 0) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    pthread_mutex_lock(&mLock);
+    if (!mIsRunning || mWidth < 1 || mHeight < 1) {
+        pthread_mutex_unlock(&mLock);
+        LOGE(TAG, "Prefetcher isn't started or page size isn't set!");
+        return gError.set(Error::ERROR);
+    }
+
+    // cancel queued tasks if reading direction is changed
+    if (isForward != mIsForward) {
+        for (auto it = mPages.begin(); it != mPages.end();) {
+            if (it->second.state == QUEUED && !it->second.isLocked) {
+                releasePage(it->second);
+                it = mPages.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    mIsForward = isForward;
+    mCurrentIndex = index;
+    evictOutOf(index - mPageCount, index + mPageCount);
+
+    // rebuild task queue by priority: current page, pages in reading
+    // direction and then pages in opposite direction
+    const int step = isForward ? 1 : -1;
+    const size_t bytes = (size_t)mWidth * mHeight * 4;
+    mTasks.clear();
+    for (int i = 0; i <= mPageCount * 2; ++i) {
+        int k = (i <= mPageCount) ? index + i * step
+                                  : index - (i - mPageCount) * step;
+        if (k < 0 || mSources.find(k) == mSources.end()) {
+            continue;
+        }
+
+        auto it = mPages.find(k);
+        if (it != mPages.end()) {
+            if (it->second.state == QUEUED) {
+                mTasks.push_back(k);
+            }
+            continue;
+        }
+
+        if (mUsedBytes + bytes > mBudget) {
+            break;
+        }
+
+        Page_ &page = mPages[k];
+        page.state = QUEUED;
+        page.serial = ++mSerial;
+        page.isLocked = false;
+        page.pixels = NULL;
+        page.stride = 0;
+        page.bytes = bytes;
+        mUsedBytes += bytes;
+        if (mUsedBytes > mPeakBytes) {
+            mPeakBytes = mUsedBytes;
+        }
+        mTasks.push_back(k);
+    }
+
+    pthread_cond_broadcast(&mTaskCond);
+    pthread_mutex_unlock(&mLock);
+    return Error::OK;
+}
+
+/**
+ * Lock decoded pixels of page for uploading texture
+ * <p>If page isn't decoded yet, it will be decoded in the calling thread and
+ * counted as a miss. Locked page can't be evicted until it is unlocked.</p>
+ *
+ * @param index page index
+ * @param info bitmap info of decoded pixels
+ * @param pixels decoded pixels in RGBA_8888 format
+ * @return Error::OK if successfully
+ */
+int PagePrefetcher::lock(int index, AndroidBitmapInfo &info, void *&pixels) {
+    pthread_mutex_lock(&mLock);
+    if (mWidth < 1 || mHeight < 1) {
+        pthread_mutex_unlock(&mLock);
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    auto it = mPages.find(index);
+    bool isHit = (it != mPages.end() && it->second.state == READY);
+
+    // wait if the page is being decoded by worker thread
+    while (it != mPages.end() && it->second.state == DECODING) {
+        pthread_cond_wait(&mReadyCond, &mLock);
+        it = mPages.find(index);
+    }
+
+    if (it == mPages.end()) {
+        if (mSources.find(index) == mSources.end()) {
+            pthread_mutex_unlock(&mLock);
+            return gError.set(Error::ERR_NO_PAGE_SOURCE);
+        }
+
+        Page_ &page = mPages[index];
+        page.serial = ++mSerial;
+        page.pixels = NULL;
+        page.stride = 0;
+        page.bytes = 0;
+        page.state = QUEUED;
+        it = mPages.find(index);
+    }
+
+    Page_ &page = it->second;
+    page.isLocked = true;
+    if (page.state == QUEUED) {
+        page.state = DECODING;
+        decode(index, page);
+    }
+
+    int ret = Error::OK;
+    if (page.state == READY) {
+        info.width = (uint32_t)mWidth;
+        info.height = (uint32_t)mHeight;
+        info.stride = (uint32_t)page.stride;
+        info.format = ANDROID_BITMAP_FORMAT_RGBA_8888;
+        info.flags = 0;
+        pixels = page.pixels;
+    }
+    else {
+        page.isLocked = false;
+        ret = gError.set(Error::ERR_DECODE_IMAGE);
+    }
+
+    if (isHit) {
+        ++mHits;
+    }
+    else {
+        ++mMisses;
+    }
+    pthread_mutex_unlock(&mLock);
+    return ret;
+}
+
+void PagePrefetcher::unlock(int index) {
+    pthread_mutex_lock(&mLock);
+    auto it = mPages.find(index);
+    if (it != mPages.end()) {
+        it->second.isLocked = false;
+    }
+
+    // evict it if it is moved out of window when it is locked
+    if (mCurrentIndex < 0 ||
+        index < mCurrentIndex - mPageCount ||
+        index > mCurrentIndex + mPageCount) {
+        evict(index);
+    }
+    pthread_mutex_unlock(&mLock);
+}
+
+/**
+ * Ratio of pages which are decoded before they are locked
+ */
+float PagePrefetcher::hitRate() {
+    pthread_mutex_lock(&mLock);
+    const unsigned int total = mHits + mMisses;
+    const float rate = total > 0 ? (float)mHits / total : 0;
+    pthread_mutex_unlock(&mLock);
+    return rate;
+}
+
+/**
+ * Average decode time of a page in milliseconds
+ */
+float PagePrefetcher::decodeTime() {
+    pthread_mutex_lock(&mLock);
+    const float time = mDecodeCount > 0
+                       ? (float)(mDecodeTime / mDecodeCount) : 0;
+    pthread_mutex_unlock(&mLock);
+    return time;
+}
+
+/**
+ * Bytes of decoded pages, including the bytes reserved by queued pages
+ */
+size_t PagePrefetcher::memoryUsage() {
+    pthread_mutex_lock(&mLock);
+    const size_t bytes = mUsedBytes;
+    pthread_mutex_unlock(&mLock);
+    return bytes;
+}
+
+void* PagePrefetcher::run(void *self) {
+    ((PagePrefetcher *)self)->work();
+    return NULL;
+}
+
+void PagePrefetcher::work() {
+    pthread_mutex_lock(&mLock);
+    while (mIsRunning) {
+        if (mTasks.empty()) {
+            pthread_cond_wait(&mTaskCond, &mLock);
+            continue;
+        }
+
+        const int index = mTasks.front();
+        mTasks.pop_front();
+        auto it = mPages.find(index);
+        if (it != mPages.end() && it->second.state == QUEUED) {
+            it->second.state = DECODING;
+            decode(index, it->second);
+        }
+    }
+    pthread_mutex_unlock(&mLock);
+}
+
+/**
+ * Decode page, lock must be held by caller and it is released during
+ * decoding
+ * <p>The page state should be set to DECODING by caller, and the decoded
+ * pixels are dropped if the page is evicted during decoding</p>
+ */
+int PagePrefetcher::decode(int index, Page_ &page) {
+    const unsigned int serial = page.serial;
+    auto src = mSources.find(index);
+    if (src == mSources.end()) {
+        page.state = FAILED;
+        pthread_cond_broadcast(&mReadyCond);
+        return Error::ERR_NO_PAGE_SOURCE;
+    }
+
+    Source_ source = src->second;
+    const int width = mWidth;
+    const int height = mHeight;
+    pthread_mutex_unlock(&mLock);
+
+    unsigned char *pixels = NULL;
+    size_t stride = 0;
+    const double start = now();
+    int ret = mDecoder.decode(source->data(), source->size(), width, height,
+                              pixels, stride);
+    const double time = now() - start;
+
+    pthread_mutex_lock(&mLock);
+    ++mDecodeCount;
+    mDecodeTime += time;
+
+    auto it = mPages.find(index);
+    if (it != mPages.end() && it->second.serial == serial &&
+        it->second.state == DECODING) {
+        Page_ &p = it->second;
+        mUsedBytes -= p.bytes;
+        if (ret == Error::OK) {
+            p.pixels = pixels;
+            p.stride = stride;
+            p.bytes = stride * height;
+            p.state = READY;
+            mUsedBytes += p.bytes;
+            if (mUsedBytes > mPeakBytes) {
+                mPeakBytes = mUsedBytes;
+            }
+        }
+        else {
+            LOGE(TAG, "Failed to decode page %d", index);
+            p.bytes = 0;
+            p.state = FAILED;
+        }
+    }
+    else {
+        delete[] pixels;
+    }
+
+    pthread_cond_broadcast(&mReadyCond);
+    return ret;
+}
+
+void PagePrefetcher::releasePage(Page_ &page) {
+    mUsedBytes -= page.bytes;
+    delete[] page.pixels;
+    page.pixels = NULL;
+    page.bytes = 0;
+}
+
+/**
+ * Evict page if it is not locked, lock must be held by caller
+ */
+void PagePrefetcher::evict(int index) {
+    auto it = mPages.find(index);
+    if (it != mPages.end() && !it->second.isLocked) {
+        releasePage(it->second);
+        mPages.erase(it);
+        pthread_cond_broadcast(&mReadyCond);
+    }
+}
+
+/**
+ * Evict unlocked pages out of [first, last], lock must be held by caller
+ */
+void PagePrefetcher::evictOutOf(int first, int last) {
+    for (auto it = mPages.begin(); it != mPages.end();) {
+        if ((it->first < first || it->first > last) && !it->second.isLocked) {
+            releasePage(it->second);
+            it = mPages.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    pthread_cond_broadcast(&mReadyCond);
+}
+
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_PAGEPREFETCHER_H
+#define ANDROID_PAGEFLIP_PAGEPREFETCHER_H
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <pthread.h>
+#include <android/bitmap.h>
+#include "ImageDecoder.h"
+
+namespace eschao {
+
+// max worker threads of prefetcher
+static const int kMaxPrefetchThreads = 4;
+// default pages prefetched in each direction
+static const int kDefaultPrefetchPages = 2;
+// default memory budget of decoded pages
+static const size_t kDefaultPrefetchBudget = 64 * 1024 * 1024;
+
+/**
+ * Decode pages in worker threads before they are shown
+ * <p>App provides compressed image data of pages by page index, when the
+ * current page is changed, the next N and previous N pages are decoded and
+ * scaled to page size by worker threads, the pages in reading direction are
+ * decoded first. Decoded pixels are kept in a cache with bounded memory
+ * budget, pages out of window are evicted and pending tasks are cancelled
+ * when reading direction is changed.</p>
+ * <p>GL thread gets decoded pixels by {@link #lock(int, AndroidBitmapInfo&,
+ * void*&)} to upload texture, if the page isn't ready, it will be decoded
+ * in GL thread immediately and counted as a miss.</p>
+ */
+class PagePrefetcher {
+
+public:
+    PagePrefetcher();
+    ~PagePrefetcher();
+
+    int start(int threadCount, int pageCount, size_t budget);
+    void stop();
+    int setPageSize(int width, int height);
+    int setSource(int index, const void *data, size_t size);
+    void removeSource(int index);
+    void clearSources();
+    int prefetch(int index, bool isForward);
+    int lock(int index, AndroidBitmapInfo &info, void *&pixels);
+    void unlock(int index);
+    float hitRate();
+    float decodeTime();
+    size_t memoryUsage();
+
+    inline bool isSupported() {
+        return mDecoder.isSupported();
+    }
+
+    inline bool isRunning() {
+        return mIsRunning;
+    }
+
+    inline size_t peakMemoryUsage() {
+        return mPeakBytes;
+    }
+
+private:
+    enum PageState {
+        QUEUED,
+        DECODING,
+        READY,
+        FAILED,
+    };
+
+    // source is shared with worker threads which are decoding it
+    typedef std::shared_ptr<std::vector<unsigned char> > Source_;
+
+    struct Page_ {
+        PageState state;
+        // unique serial of page, decoded pixels are dropped if page is
+        // evicted while decoding
+        unsigned int serial;
+        // page is being uploaded by GL thread and can't be evicted
+        bool isLocked;
+        unsigned char *pixels;
+        size_t stride;
+        size_t bytes;
+    };
+
+    static void* run(void *self);
+    void work();
+    int decode(int index, Page_ &page);
+    void evict(int index);
+    void evictOutOf(int first, int last);
+    void releasePage(Page_ &page);
+
+private:
+    ImageDecoder mDecoder;
+
+    // worker threads
+    bool mIsRunning;
+    int mThreadCount;
+    pthread_t mThreads[kMaxPrefetchThreads];
+    pthread_mutex_t mLock;
+    pthread_cond_t mTaskCond;
+    pthread_cond_t mReadyCond;
+
+    // prefetch window and cache
+    int mPageCount;
+    int mWidth;
+    int mHeight;
+    int mCurrentIndex;
+    bool mIsForward;
+    unsigned int mSerial;
+    size_t mBudget;
+    size_t mUsedBytes;
+    size_t mPeakBytes;
+    std::map<int, Source_> mSources;
+    std::map<int, Page_> mPages;
+    std::deque<int> mTasks;
+
+    // statistics
+    unsigned int mHits;
+    unsigned int mMisses;
+    unsigned int mDecodeCount;
+    double mDecodeTime;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_PAGEPREFETCHER_H
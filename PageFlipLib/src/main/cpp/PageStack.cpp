@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <math.h>
+#include "PageStack.h"
+#include "RenderBackend.h"
+#include "Error.h"
+
+namespace eschao {
+
+// color of page edge and the line between two pages
+static const float kPageStackColor = 0.92f;
+static const float kPageStackLineColor = 0.7f;
+// deeper layer is darker
+static const float kPageStackDarkenRatio = 0.2f;
+
+PageStack::PageStack()
+        : mMaxLayers(0),
+          mLayerWidth(0),
+          mProgress(0),
+          mLeft(0),
+          mRight(0),
+          mHasLeftStack(false),
+          mInstanceCount(0) {
+    for (int i = 0; i < 8; ++i) {
+        mQuad[i] = 0;
+    }
+}
+
+/**
+ * Set layers of page stack
+ *
+ * @param maxLayers max layers on one side, 0 means disabling page stack
+ * @param layerWidth width of one layer in pixels
+ * @return Error::OK if parameters are valid
+ */
+int PageStack::set(int maxLayers, float layerWidth) {
+    if (maxLayers < 0 || maxLayers > kMaxPageStackLayers ||
+        (maxLayers > 0 && layerWidth < 1)) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    mMaxLayers = maxLayers;
+    mLayerWidth = maxLayers > 0 ? layerWidth : 0;
+    buildLayers();
+    return Error::OK;
+}
+
+/**
+ * Set book progress
+ *
+ * @param progress [0 .. 1], 0 is the begin of book and 1 is the end
+ * @return Error::OK if progress is valid
+ */
+int PageStack::setProgress(float progress) {
+    if (progress < 0 || progress > 1) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    mProgress = progress;
+    buildLayers();
+    return Error::OK;
+}
+
+/**
+ * Set outer edges of pages, stack layers are laid outside them
+ */
+void PageStack::setBounds(float left, float right, float top, float bottom,
+                          bool hasLeftStack) {
+    mLeft = left;
+    mRight = right;
+    mHasLeftStack = hasLeftStack;
+
+    // vertical quad with layer width
+    mQuad[0] = 0;
+    mQuad[1] = top;
+    mQuad[2] = 0;
+    mQuad[3] = bottom;
+    mQuad[4] = mLayerWidth;
+    mQuad[5] = top;
+    mQuad[6] = mLayerWidth;
+    mQuad[7] = bottom;
+    buildLayers();
+}
+
+void PageStack::buildLayers() {
+    mInstanceCount = 0;
+    if (mMaxLayers <= 0) {
+        return;
+    }
+
+    mQuad[4] = mQuad[6] = mLayerWidth;
+    const int leftCount = mHasLeftStack ?
+                          (int)roundf(mProgress * mMaxLayers) : 0;
+    const int rightCount = (int)roundf((1 - mProgress) * mMaxLayers);
+
+    float *instance = mInstances;
+    for (int i = 0; i < leftCount + rightCount; ++i, instance += 4) {
+        const bool isLeft = i < leftCount;
+        const int layer = isLeft ? i : i - leftCount;
+        const float color = (layer & 1) ? kPageStackLineColor
+                                        : kPageStackColor;
+        instance[0] = isLeft ? mLeft - (layer + 1) * mLayerWidth
+                             : mRight + layer * mLayerWidth;
+        instance[1] = 0;
+        instance[2] = color * (1 - kPageStackDarkenRatio * layer / mMaxLayers);
+        instance[3] = 1.0f;
+    }
+
+    mInstanceCount = leftCount + rightCount;
+}
+
+void PageStack::draw(RenderBackend &backend) {
+    if (mInstanceCount > 0) {
+        backend.drawInstancedQuads(mQuad, mInstances, mInstanceCount, 0);
+    }
+}
+
+}
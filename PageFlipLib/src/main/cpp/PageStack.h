@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_PAGESTACK_H
+#define ANDROID_PAGEFLIP_PAGESTACK_H
+
+namespace eschao {
+
+class RenderBackend;
+
+// max layers on one side of page stack
+static const int kMaxPageStackLayers = 32;
+
+/**
+ * Page stack shows the thickness of remaining pages on the outer edges of
+ * book
+ * <p>Every layer is the same thin quad with its own offset and color, all
+ * layers on both sides are drawn by one instanced draw call. The right side
+ * has the unread pages and the left side has the read pages if there are two
+ * pages on screen, their thickness are proportional to book progress</p>
+ * <p>Page stack is disabled by default, the outer edges of pages are inset
+ * by its thickness when it is enabled</p>
+ */
+class PageStack {
+
+public:
+    PageStack();
+
+    int set(int maxLayers, float layerWidth);
+    int setProgress(float progress);
+    void setBounds(float left, float right, float top, float bottom,
+                   bool hasLeftStack);
+    void draw(RenderBackend &backend);
+
+    inline bool isEnabled() {
+        return mMaxLayers > 0;
+    }
+
+    // thickness of one side when book is at the begin or the end
+    inline float thickness() {
+        return mMaxLayers * mLayerWidth;
+    }
+
+    inline float progress() {
+        return mProgress;
+    }
+
+    inline int layerCount() {
+        return mInstanceCount;
+    }
+
+private:
+    void buildLayers();
+
+private:
+    int mMaxLayers;
+    float mLayerWidth;
+    float mProgress;
+
+    // outer edges of pages
+    float mLeft;
+    float mRight;
+    bool mHasLeftStack;
+
+    // x, y of quad in triangle strip order
+    float mQuad[8];
+    // x, y offset, color and alpha of every layer
+    float mInstances[kMaxPageStackLayers * 2 * 4];
+    int mInstanceCount;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_PAGESTACK_H
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "PngWriter.h"
+#include "Error.h"
+
+namespace eschao {
+
+// max size of uncompressed deflate block
+static const size_t kMaxStoredBlock = 65535;
+
+static void putUint32(std::vector<unsigned char> &out, uint32_t v) {
+    out.push_back((unsigned char)(v >> 24));
+    out.push_back((unsigned char)(v >> 16));
+    out.push_back((unsigned char)(v >> 8));
+    out.push_back((unsigned char)v);
+}
+
+uint32_t PngWriter::crc32(uint32_t crc, const unsigned char *data,
+                          size_t size) {
+    static uint32_t table[256];
+    static bool isTableReady = false;
+    if (!isTableReady) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        isTableReady = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * Write pixels to PNG file
+ *
+ * @param path file path
+ * @param width image width
+ * @param height image height
+ * @param rgba RGBA_8888 pixels, the first row is the top of image
+ * @param stride bytes of a row
+ * @return Error::OK if successfully
+ */
+int PngWriter::write(const char *path, int width, int height,
+                     const unsigned char *rgba, size_t stride) {
+    if (path == NULL || rgba == NULL || width < 1 || height < 1) {
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    // raw image data: filter type 0 and pixels of every row
+    const size_t rowSize = (size_t)width * 4 + 1;
+    std::vector<unsigned char> raw(rowSize * height);
+    for (int y = 0; y < height; ++y) {
+        unsigned char *row = &raw[rowSize * y];
+        row[0] = 0;
+        memcpy(row + 1, rgba + stride * y, rowSize - 1);
+    }
+
+    // zlib stream with stored deflate blocks
+    std::vector<unsigned char> idat;
+    idat.reserve(raw.size() + raw.size() / kMaxStoredBlock * 5 + 16);
+    idat.push_back('I');
+    idat.push_back('D');
+    idat.push_back('A');
+    idat.push_back('T');
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    uint32_t a = 1, b = 0;
+    for (size_t pos = 0; pos < raw.size(); pos += kMaxStoredBlock) {
+        const size_t len = raw.size() - pos < kMaxStoredBlock
+                           ? raw.size() - pos : kMaxStoredBlock;
+        idat.push_back(pos + len == raw.size() ? 1 : 0);
+        idat.push_back((unsigned char)len);
+        idat.push_back((unsigned char)(len >> 8));
+        idat.push_back((unsigned char)~len);
+        idat.push_back((unsigned char)(~len >> 8));
+        idat.insert(idat.end(), raw.begin() + pos, raw.begin() + pos + len);
+        for (size_t i = pos; i < pos + len; ++i) {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+    }
+    putUint32(idat, (b << 16) | a);
+
+    std::vector<unsigned char> out;
+    static const unsigned char signature[] = {
+            0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+    };
+    out.insert(out.end(), signature, signature + sizeof(signature));
+
+    // IHDR: 8 bits RGBA, no interlace
+    unsigned char ihdr[17] = { 'I', 'H', 'D', 'R' };
+    ihdr[4] = (unsigned char)(width >> 24);
+    ihdr[5] = (unsigned char)(width >> 16);
+    ihdr[6] = (unsigned char)(width >> 8);
+    ihdr[7] = (unsigned char)width;
+    ihdr[8] = (unsigned char)(height >> 24);
+    ihdr[9] = (unsigned char)(height >> 16);
+    ihdr[10] = (unsigned char)(height >> 8);
+    ihdr[11] = (unsigned char)height;
+    ihdr[12] = 8;
+    ihdr[13] = 6;
+    putUint32(out, 13);
+    out.insert(out.end(), ihdr, ihdr + sizeof(ihdr));
+    putUint32(out, crc32(0, ihdr, sizeof(ihdr)));
+
+    putUint32(out, (uint32_t)idat.size() - 4);
+    out.insert(out.end(), idat.begin(), idat.end());
+    putUint32(out, crc32(0, &idat[0], idat.size()));
+
+    static const unsigned char iend[] = { 'I', 'E', 'N', 'D' };
+    putUint32(out, 0);
+    out.insert(out.end(), iend, iend + sizeof(iend));
+    putUint32(out, crc32(0, iend, sizeof(iend)));
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return Error::ERROR;
+    }
+
+    const bool isOk = fwrite(&out[0], 1, out.size(), file) == out.size();
+    fclose(file);
+    return isOk ? Error::OK : Error::ERROR;
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_PNGWRITER_H
+#define ANDROID_PAGEFLIP_PNGWRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace eschao {
+
+/**
+ * Write RGBA_8888 pixels to PNG file without any dependency
+ * <p>Image data is stored in uncompressed deflate blocks, the file is larger
+ * than a compressed one but it is fast to write and good enough for golden
+ * images and frame dumps</p>
+ */
+class PngWriter {
+
+public:
+    static int write(const char *path, int width, int height,
+                     const unsigned char *rgba, size_t stride);
+
+private:
+    static uint32_t crc32(uint32_t crc, const unsigned char *data,
+                          size_t size);
+};
+
+}
+#endif //ANDROID_PAGEFLIP_PNGWRITER_H
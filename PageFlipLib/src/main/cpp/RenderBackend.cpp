@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "RenderBackend.h"
+
+namespace eschao {
+
+void RenderBackend::drawTwoSidedFold(const float *vertexes,
+                                     const float *texCoords,
+                                     int backCount,
+                                     int frontOffset,
+                                     int count,
+                                     GLuint frontTextureId,
+                                     GLuint backTextureId,
+                                     GLuint gradientLightId,
+                                     const float *maskColor,
+                                     float maskAlpha,
+                                     float texXOffset) {
+    drawBackOfFold(vertexes, texCoords, backCount, backTextureId,
+                   gradientLightId, maskColor, maskAlpha, texXOffset);
+    drawPage(TRIANGLE_STRIP, vertexes, 4, texCoords, frontOffset,
+             count - frontOffset, frontTextureId);
+}
+
+void RenderBackend::drawInstancedQuads(const float *quad,
+                                       const float *instances,
+                                       int count,
+                                       float vertexZ) {
+    // color of instance is the gradient from black to white, instances are
+    // stitched until alpha changes
+    ShadowColor color;
+    color.endColor = 1;
+
+    for (int first = 0, last = 0; first < count; first = last) {
+        const float alpha = instances[(first << 2) + 3];
+        while (last < count && instances[(last << 2) + 3] == alpha) {
+            ++last;
+        }
+
+        // 4 vertexes of every quad and 2 degenerate ones between quads
+        const int quadCount = last - first;
+        const int vertexCount = (quadCount << 2) + ((quadCount - 1) << 1);
+        mInstancedVertexes.resize(vertexCount << 1);
+        mInstancedGradients.resize(vertexCount);
+
+        float *v = &mInstancedVertexes[0];
+        float *g = &mInstancedGradients[0];
+        const float *instance = instances + (first << 2);
+        for (int i = 0; i < quadCount; ++i, instance += 4) {
+            for (int j = 0; j < 4; ++j) {
+                // repeat the first vertex to stitch with previous quad
+                const int repeat = (i > 0 && j == 0) ? 2 : 1;
+                for (int k = 0; k < repeat; ++k, v += 2) {
+                    v[0] = quad[j << 1] + instance[0];
+                    v[1] = quad[(j << 1) + 1] + instance[1];
+                    *g++ = instance[2];
+                }
+            }
+
+            // repeat the last vertex to stitch with next quad
+            if (i < quadCount - 1) {
+                v[0] = v[-2];
+                v[1] = v[-1];
+                g[0] = g[-1];
+                v += 2;
+                ++g;
+            }
+        }
+
+        color.startAlpha = color.endAlpha = alpha;
+        drawShadow(&mInstancedVertexes[0], &mInstancedGradients[0],
+                   vertexCount, color, vertexZ);
+    }
+}
+
+}
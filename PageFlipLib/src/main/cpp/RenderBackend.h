@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_RENDERBACKEND_H
+#define ANDROID_PAGEFLIP_RENDERBACKEND_H
+
+#include <GLES2/gl2.h>
+#include <vector>
+#include <android/bitmap.h>
+#include "Matrix.h"
+#include "ShadowColor.h"
+
+namespace eschao {
+
+class FoldShadow;
+
+enum PrimitiveType {
+    TRIANGLE_STRIP = 0,
+    TRIANGLE_FAN,
+};
+
+// built-in GL backends which can be selected before surface is created,
+// Vulkan backend isn't implemented yet and is tracked separately, see
+// README.md
+enum RenderBackendType {
+    GLES2_RENDER_BACKEND = 0,
+    GLES3_RENDER_BACKEND,
+};
+
+/**
+ * Render backend of page flip frames
+ * <p>All draw calls of flip frame and page frame go through backend, the
+ * operations describe what is drawn instead of how it is drawn, so frames
+ * can be rendered by OpenGL ES on device or by CPU without GL context, e.g.
+ * rendering golden images in tests.</p>
+ * <p>Vertex formats are same with the vertex buffers:</p>
+ * <ul>
+ *     <li>page: x, y, z[, w] and texture coordinates s, t</li>
+ *     <li>shadow: x, y and an optional gradient of every vertex, color is
+ *     mixed from start to end color by gradient. Without gradients, the
+ *     even vertexes are shadow start and the odd ones are shadow end. z is
+ *     given by parameter</li>
+ *     <li>back of fold: x, y, z, shadow x and texture coordinates</li>
+ *     <li>two-sided fold: same with back of fold, the w of front vertexes
+ *     is 1</li>
+ *     <li>instanced quad: x, y of 4 vertexes in strip order, every instance
+ *     has x, y offset, color and alpha</li>
+ *     <li>fold clipped page: x, y, z of 4 apexes in fan order, z is given
+ *     by parameter</li>
+ * </ul>
+ * <p>Backend which supports {@link FoldShadow} casts analytic fold shadows
+ * on front of page while it is set, shadow meshes are not needed then</p>
+ */
+class RenderBackend {
+
+public:
+    RenderBackend() : mFoldShadow(NULL), mBlendScissor(NULL) { }
+    virtual ~RenderBackend() { }
+
+    // called when surface is created
+    virtual int init() = 0;
+    virtual void setViewport(int width, int height, const Mat4 &mvp) = 0;
+
+    // clear frame and set depth test
+    virtual void beginFrame(bool hasDepthTest) = 0;
+
+    virtual GLuint createTexture(AndroidBitmapInfo &info,
+                                 const void *data) = 0;
+    virtual void deleteTextures(int count, const GLuint *ids) = 0;
+
+    virtual void drawPage(PrimitiveType type,
+                          const float *vertexes,
+                          int sizeOfPerVex,
+                          const float *texCoords,
+                          int offset,
+                          int count,
+                          GLuint textureId) = 0;
+    virtual void drawShadow(const float *vertexes,
+                            const float *gradients,
+                            int count,
+                            const ShadowColor &color,
+                            float vertexZ) = 0;
+    virtual void drawBackOfFold(const float *vertexes,
+                                const float *texCoords,
+                                int count,
+                                GLuint textureId,
+                                GLuint gradientLightId,
+                                const float *maskColor,
+                                float maskAlpha,
+                                float texXOffset) = 0;
+
+    /**
+     * Draw back of fold and front of page in one triangle strip
+     * <p>Back facing triangles are shaded as back of fold and front facing
+     * ones with the front texture. The default implementation draws the two
+     * ranges of strip separately, backends which support two-sided shading
+     * should override it</p>
+     *
+     * @param vertexes x, y, z, w of strip, w is shadow x of back vertexes
+     * @param texCoords texture coordinates of strip
+     * @param backCount vertex count of back of fold, from the beginning
+     * @param frontOffset offset of the first front vertex
+     * @param count vertex count of the whole strip
+     * @param frontTextureId texture of front facing triangles
+     */
+    virtual void drawTwoSidedFold(const float *vertexes,
+                                  const float *texCoords,
+                                  int backCount,
+                                  int frontOffset,
+                                  int count,
+                                  GLuint frontTextureId,
+                                  GLuint backTextureId,
+                                  GLuint gradientLightId,
+                                  const float *maskColor,
+                                  float maskAlpha,
+                                  float texXOffset);
+
+    /**
+     * Draw one quad many times with per-instance offset and color in one
+     * draw call
+     * <p>The default implementation expands instances into one triangle
+     * strip of shadow vertexes stitched by degenerate triangles, colors of
+     * instances are passed as shadow gradients. Backends with hardware
+     * instancing should override it</p>
+     *
+     * @param quad x, y of 4 vertexes in triangle strip order
+     * @param instances x, y offset, color and alpha of every instance
+     * @param count instance count
+     * @param vertexZ z of all vertexes
+     */
+    virtual void drawInstancedQuads(const float *quad,
+                                    const float *instances,
+                                    int count,
+                                    float vertexZ);
+
+    virtual bool isFoldShadowSupported() {
+        return false;
+    }
+
+    /**
+     * Draw flat page quad with two textures split by fold line
+     * <p>Fragments with positive distance a * x + b * y + c of fold line
+     * (a, b, c) are revealed by fold and shaded with the second texture,
+     * the others are shaded with the first texture. It is only called if
+     * {@link #isFoldClipSupported} is true, otherwise the flat page is
+     * split into two polygons by fold line and drawn by {@link #drawPage}
+     * </p>
+     *
+     * @param vertexes x, y, z of page apexes in triangle fan order
+     * @param texCoords texture coordinates of apexes
+     * @param foldLine a, b, c of fold line, (a, b) is unit normal
+     * @param vertexZ z of all vertexes
+     */
+    virtual void drawFoldClippedPage(const float *vertexes,
+                                     const float *texCoords,
+                                     const float *foldLine,
+                                     float vertexZ,
+                                     GLuint firstTextureId,
+                                     GLuint secondTextureId) { }
+
+    virtual bool isFoldClipSupported() {
+        return false;
+    }
+
+    /**
+     * Set analytic fold shadows cast on pages drawn by {@link #drawPage}
+     * and front of {@link #drawTwoSidedFold}, NULL means no shadow
+     */
+    inline void setFoldShadow(const FoldShadow *foldShadow) {
+        mFoldShadow = foldShadow;
+    }
+
+    /**
+     * Set scissor of blended passes drawn by {@link #drawShadow}, pixels
+     * outside it are not touched. NULL means no scissor
+     *
+     * @param scissor x, y, width and height in pixels, y is from bottom of
+     *                surface like glScissor
+     */
+    inline void setBlendScissor(const int *scissor) {
+        mBlendScissor = scissor;
+    }
+
+protected:
+    const FoldShadow *mFoldShadow;
+    const int *mBlendScissor;
+
+    // expanded vertexes and gradients of instanced quads
+    std::vector<float> mInstancedVertexes;
+    std::vector<float> mInstancedGradients;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_RENDERBACKEND_H
@@ -30,7 +30,7 @@ Scroller::Scroller()
 }
 
 Scroller::Scroller(Interpolator *interpolator)
-        : mFinished(true), mInterpolator(interpolator) {
+        : mInterpolator(interpolator), mFinished(true) {
 }
 
 Scroller::~Scroller() {
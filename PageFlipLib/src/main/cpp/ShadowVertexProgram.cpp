@@ -15,7 +15,7 @@
  */
 
 #include "ShadowVertexProgram.h"
-#include "constant.h"
+#include "Constant.h"
 
 namespace eschao {
 
@@ -23,12 +23,16 @@ static const auto g_vertex_shader =
         "precision mediump float;\n"
         "uniform mat4 u_MVPMatrix;\n"
         "uniform float u_vexZ;\n"
-        "attribute vec4 a_vexPosition;\n"
+        "uniform vec2 u_startColor;\n"
+        "uniform vec2 u_endColor;\n"
+        "attribute vec2 a_vexPosition;\n"
+        "attribute float a_gradient;\n"
         "varying vec4 v_texColor;\n"
         "\n"
         "void main() {\n"
-        "    vec4 vexPos = vec4(a_vexPosition.xy, u_vexZ, 1.0);\n"
-        "    v_texColor = vec4(a_vexPosition.z, a_vexPosition.z, a_vexPosition.z, a_vexPosition.w);\n"
+        "    vec4 vexPos = vec4(a_vexPosition, u_vexZ, 1.0);\n"
+        "    vec2 color = mix(u_startColor, u_endColor, a_gradient);\n"
+        "    v_texColor = vec4(color.x, color.x, color.x, color.y);\n"
         "    gl_Position = u_MVPMatrix * vexPos;\n"
         "}";
 
@@ -41,14 +45,18 @@ static const auto g_fragment_shader =
         "    gl_FragColor = v_texColor;\n"
         "}";
 
-static const char *VAR_MVP_MATRIX   = "u_MVPMatrix";
 static const char *VAR_VERTEX_Z     = "u_vexZ";
+static const char *VAR_START_COLOR  = "u_startColor";
+static const char *VAR_END_COLOR    = "u_endColor";
 static const char *VAR_VERTEX_POS   = "a_vexPosition";
+static const char *VAR_GRADIENT     = "a_gradient";
 
 ShadowVertexProgram::ShadowVertexProgram()
-        : mMVPMatrixLoc(Constant::kGlInValidLocation),
-          mVertexZLoc(Constant::kGlInValidLocation),
-          mVertexPosLoc(Constant::kGlInValidLocation) {
+        : mVertexZLoc(Constant::kGlInValidLocation),
+          mStartColorLoc(Constant::kGlInValidLocation),
+          mEndColorLoc(Constant::kGlInValidLocation),
+          mVertexPosLoc(Constant::kGlInValidLocation),
+          mGradientLoc(Constant::kGlInValidLocation) {
 }
 
 ShadowVertexProgram::~ShadowVertexProgram() {
@@ -56,9 +64,11 @@ ShadowVertexProgram::~ShadowVertexProgram() {
 }
 
 void ShadowVertexProgram::clean() {
-    mMVPMatrixLoc = Constant::kGlInValidLocation;
     mVertexZLoc = Constant::kGlInValidLocation;
+    mStartColorLoc = Constant::kGlInValidLocation;
+    mEndColorLoc = Constant::kGlInValidLocation;
     mVertexPosLoc = Constant::kGlInValidLocation;
+    mGradientLoc = Constant::kGlInValidLocation;
 
     GLProgram::clean();
 }
@@ -70,8 +80,10 @@ int ShadowVertexProgram::init() {
 
 void ShadowVertexProgram::getVarsLocation() {
     mVertexZLoc = glGetUniformLocation(mProgramRef, VAR_VERTEX_Z);
-    mMVPMatrixLoc = glGetUniformLocation(mProgramRef, VAR_MVP_MATRIX);
+    mStartColorLoc = glGetUniformLocation(mProgramRef, VAR_START_COLOR);
+    mEndColorLoc = glGetUniformLocation(mProgramRef, VAR_END_COLOR);
     mVertexPosLoc = glGetAttribLocation(mProgramRef, VAR_VERTEX_POS);
+    mGradientLoc = glGetAttribLocation(mProgramRef, VAR_GRADIENT);
 }
 
 }
@@ -21,6 +21,10 @@
 
 namespace eschao {
 
+/**
+ * Program of shadow strip, vertex color is mixed from start and end color
+ * uniforms by gradient of vertex
+ */
 class ShadowVertexProgram : public GLProgram {
 
 public:
@@ -30,25 +34,35 @@ public:
     int init();
     virtual void clean();
 
-    inline GLint mvpMatrixLoc() {
-        return mMVPMatrixLoc;
-    }
-
     inline GLint vertexZLoc() {
         return mVertexZLoc;
     }
 
+    inline GLint startColorLoc() {
+        return mStartColorLoc;
+    }
+
+    inline GLint endColorLoc() {
+        return mEndColorLoc;
+    }
+
     inline GLint vertexPosLoc() {
         return mVertexPosLoc;
     }
 
+    inline GLint gradientLoc() {
+        return mGradientLoc;
+    }
+
 protected:
     virtual void getVarsLocation();
 
 protected:
-    GLint mMVPMatrixLoc;
     GLint mVertexZLoc;
+    GLint mStartColorLoc;
+    GLint mEndColorLoc;
     GLint mVertexPosLoc;
+    GLint mGradientLoc;
 };
 
 }
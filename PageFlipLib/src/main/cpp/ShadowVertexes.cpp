@@ -14,20 +14,21 @@
  * limitations under the License.
  */
 
+#include <string.h>
 #include "ShadowVertexes.h"
-#include "ShadowVertexProgram.h"
-#include "VertexProgram.h"
+#include "RenderBackend.h"
 
 namespace eschao {
 
 ShadowVertexes::ShadowVertexes(int spaceOfFrontRear,
                                float startColor, float startAlpha,
                                float endColor, float endAlpha)
-        : mSpaceOfFrontRear(spaceOfFrontRear),
+        : mCapacity(0),
+          mSpaceOfFrontRear(spaceOfFrontRear),
           mBackward(0),
           mForward(0),
           mMaxBackward(0),
-          mVertexes(NULL) {
+          mVertexZ(0) {
     color.set(startColor, startAlpha, endColor, endAlpha);
 }
 
@@ -36,21 +37,34 @@ ShadowVertexes::~ShadowVertexes() {
 }
 
 void ShadowVertexes::set(int meshCount) {
-    mMaxBackward = meshCount << 3;
-    mCapacity = (meshCount << 4) + (mSpaceOfFrontRear << 2);
-    mVertexes = new float[mCapacity];
+    release();
+    mMaxBackward = meshCount << 2;
+    mCapacity = capacityOf(meshCount);
+    mVertexes.allocate(mCapacity);
     reset();
 }
 
-void ShadowVertexes::release() {
-    if (mVertexes) {
-        delete[] mVertexes;
+/**
+ * Set buffer with memory from arena, nothing is allocated from heap
+ */
+int ShadowVertexes::set(VertexArena &arena, int meshCount) {
+    release();
+    mVertexes = arena.allocate(capacityOf(meshCount));
+    if (mVertexes.isNull()) {
+        return gError.set(Error::ERROR);
     }
 
+    mMaxBackward = meshCount << 2;
+    mCapacity = capacityOf(meshCount);
+    reset();
+    return Error::OK;
+}
+
+void ShadowVertexes::release() {
+    mVertexes.release();
     mBackward = 0;
     mForward = 0;
     mMaxBackward = 0;
-    mSpaceOfFrontRear = 0;
     mCapacity = 0;
 }
 
@@ -59,12 +73,8 @@ ShadowVertexes& ShadowVertexes::setVertexes(int offset,
                                             float endX, float endY) {
     mVertexes[offset++] = startX;
     mVertexes[offset++] = startY;
-    mVertexes[offset++] = color.startColor;
-    mVertexes[offset++] = color.startAlpha;
     mVertexes[offset++] = endX;
-    mVertexes[offset++] = endY;
-    mVertexes[offset++] = color.endColor;
-    mVertexes[offset] = color.endAlpha;
+    mVertexes[offset] = endY;
     return *this;
 }
 
@@ -72,12 +82,8 @@ ShadowVertexes& ShadowVertexes::addVertexesBackward(float startX,
                                                     float startY,
                                                     float endX,
                                                     float endY) {
-    mVertexes[--mBackward] = color.endAlpha;
-    mVertexes[--mBackward] = color.endColor;
     mVertexes[--mBackward] = endY;
     mVertexes[--mBackward] = endX;
-    mVertexes[--mBackward] = color.startAlpha;
-    mVertexes[--mBackward] = color.startColor;
     mVertexes[--mBackward] = startY;
     mVertexes[--mBackward] = startX;
     return *this;
@@ -89,32 +95,44 @@ ShadowVertexes& ShadowVertexes::addVertexesForward(float startX,
                                                    float endY) {
     mVertexes[mForward++] = startX;
     mVertexes[mForward++] = startY;
-    mVertexes[mForward++] = color.startColor;
-    mVertexes[mForward++] = color.startAlpha;
     mVertexes[mForward++] = endX;
     mVertexes[mForward++] = endY;
-    mVertexes[mForward++] = color.endColor;
-    mVertexes[mForward++] = color.endAlpha;
     return *this;
 }
 
-void ShadowVertexes::draw(ShadowVertexProgram &program) {
-    int count = (mForward - mBackward) >> 2;
-    if (count > 0) {
-        glUniformMatrix4fv(program.mvpMatrixLoc(), 1, GL_FALSE,
-                           VertexProgram::MVPMatrix);
-        glUniform1f(program.vertexZLoc(), mVertexZ);
+/**
+ * Copy vertexes and vertex z of src, they are put at the head of buffer
+ * <p>Buffer is allocated with the size of src if it is not enough, but the
+ * buffer borrowed from arena can't be reallocated. The copied vertexes can
+ * only be drawn, buffer should be {@link #reset} before adding vertexes</p>
+ *
+ * @return Error::OK if successfully
+ */
+int ShadowVertexes::copy(const ShadowVertexes &src) {
+    const int size = src.mForward - src.mBackward;
+    if (mCapacity < size) {
+        if (mVertexes.isBorrowed()) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
 
-        glDisable(GL_TEXTURE_2D);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        release();
+        mCapacity = size;
+        mVertexes.allocate(size);
+    }
 
-        glVertexAttribPointer(program.vertexPosLoc(), 4, GL_FLOAT, GL_FALSE,
-                              0, mVertexes + mBackward);
-        glEnableVertexAttribArray(program.vertexPosLoc());
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, count);
+    memcpy(mVertexes.data(), src.mVertexes.data() + src.mBackward,
+           size * sizeof(float));
+    mBackward = 0;
+    mForward = size;
+    mVertexZ = src.mVertexZ;
+    return Error::OK;
+}
 
-        glDisable(GL_BLEND);
+void ShadowVertexes::draw(RenderBackend &backend) {
+    int count = (mForward - mBackward) >> 1;
+    if (count > 0) {
+        backend.drawShadow(mVertexes.data() + mBackward, NULL, count, color,
+                           mVertexZ);
     }
 }
 
@@ -20,11 +20,17 @@
 #include <cassert>
 #include "ShadowColor.h"
 #include "Utility.h"
+#include "VertexArena.h"
 
 namespace eschao {
 
-class ShadowVertexProgram;
+class RenderBackend;
 
+/**
+ * Vertexes of shadow strip, every pair of vertexes is (x, y) of shadow start
+ * and end. The shadow color is not stored in vertexes, it is passed to
+ * backend when drawing, so changing color doesn't touch vertexes
+ */
 class ShadowVertexes {
 
 public:
@@ -35,6 +41,7 @@ public:
 
     void release();
     void set(int meshCount);
+    int set(VertexArena &arena, int meshCount);
     ShadowVertexes& setVertexes(int offset,
                                 float startX, float startY,
                                 float endX, float endY);
@@ -42,19 +49,44 @@ public:
                                         float endX, float endY);
     ShadowVertexes& addVertexesForward(float startX, float startY,
                                        float endX, float endY);
-    void draw(ShadowVertexProgram &program);
+    int copy(const ShadowVertexes &src);
+    void draw(RenderBackend &backend);
 
     // inline
     inline void reset() {
         mVertexZ = 0;
         mBackward = mMaxBackward;
-        mForward = mMaxBackward + (mSpaceOfFrontRear << 2);
+        mForward = mMaxBackward + (mSpaceOfFrontRear << 1);
+    }
+
+    inline int capacityOf(int meshCount) {
+        return (meshCount << 3) + (mSpaceOfFrontRear << 1);
+    }
+
+    inline size_t sizeInArena(int meshCount) {
+        return VertexArena::alignedSize(capacityOf(meshCount));
     }
 
     inline int maxBackward() {
         return mMaxBackward;
     }
 
+    inline int capacityOfVertexes() {
+        return mCapacity >> 1;
+    }
+
+    inline int count() {
+        return (mForward - mBackward) >> 1;
+    }
+
+    inline const float* vertexes() {
+        return mVertexes.data() + mBackward;
+    }
+
+    inline float vertexZ() {
+        return mVertexZ;
+    }
+
     inline void setVertexZ(float z) {
         mVertexZ = z;
     }
@@ -67,8 +99,30 @@ public:
                addVertexesBackward(startX, startY, endX, endY);
     }
 
+    /**
+     * Expand count pairs in forward direction which will be set by offset
+     *
+     * @return offset of the first expanded pair
+     */
+    inline int expandForward(int count) {
+        const int offset = mForward;
+        mForward += count << 2;
+        return offset;
+    }
+
+    /**
+     * Expand count pairs in backward direction, the pair which is expanded
+     * first is at the tail like {@link #addVertexesBackward}
+     *
+     * @return offset of the last expanded pair
+     */
+    inline int expandBackward(int count) {
+        mBackward -= count << 2;
+        return mBackward;
+    }
+
     inline void setRange(int backward, int forward) {
-        assert(backward > 0 && backward < forward && forward < mCapacity);
+        assert(backward >= 0 && backward < forward && forward <= mCapacity);
         mBackward = backward;
         mForward = forward;
     }
@@ -90,7 +144,8 @@ protected:
     int mMaxBackward;
 
     float mVertexZ;
-    float* mVertexes;
+    // buffer allocated by itself or borrowed from arena
+    VertexBlock mVertexes;
 };
 
 }
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SinglePassVertexProgram.h"
+#include "Constant.h"
+
+namespace eschao {
+
+// material of vertex, see SinglePassVertexes.h
+//  0: first texture of page     1: second texture of page
+//  2: back of fold              3: fold shadow
+//  4: first texture of the second page
+static const auto g_vertex_shader =
+        "precision mediump float;\n"
+        "uniform mat4 u_MVPMatrix;\n"
+        "uniform float u_texXOffset;\n"
+        "attribute vec4 a_vexPosition;\n"
+        "attribute vec2 a_texCoord;\n"
+        "attribute vec2 a_extra;\n"
+        "varying vec2 v_texCoord;\n"
+        "varying vec2 v_extra;\n"
+        "varying float v_material;\n"
+        "\n"
+        "void main() {\n"
+        "    float isBack = step(1.5, a_vexPosition.w) * step(a_vexPosition.w, 2.5);\n"
+        "    v_texCoord = vec2(mix(a_texCoord.x, abs(a_texCoord.x - u_texXOffset), isBack), a_texCoord.y);\n"
+        "    v_extra = mix(a_extra, vec2(clamp(abs(a_extra.x), 0.01, 1.0), 0), isBack);\n"
+        "    v_material = a_vexPosition.w;\n"
+        "    gl_Position = u_MVPMatrix * vec4(a_vexPosition.xyz, 1.0);\n"
+        "}";
+
+static const auto g_fragment_shader =
+        "precision mediump float;\n"
+        "uniform sampler2D u_firstTexture;\n"
+        "uniform sampler2D u_secondTexture;\n"
+        "uniform sampler2D u_backTexture;\n"
+        "uniform sampler2D u_shadow;\n"
+        "uniform sampler2D u_pageTexture;\n"
+        "uniform vec4 u_maskColor;\n"
+        "varying vec2 v_texCoord;\n"
+        "varying vec2 v_extra;\n"
+        "varying float v_material;\n"
+        "\n"
+        "void main() {\n"
+        "    if (v_material < 0.5) {\n"
+        "        gl_FragColor = vec4(texture2D(u_firstTexture, v_texCoord).rgb, 1.0);\n"
+        "    }\n"
+        "    else if (v_material < 1.5) {\n"
+        "        gl_FragColor = vec4(texture2D(u_secondTexture, v_texCoord).rgb, 1.0);\n"
+        "    }\n"
+        "    else if (v_material < 2.5) {\n"
+        "        vec4 texture = texture2D(u_backTexture, v_texCoord);\n"
+        "        vec4 shadow = texture2D(u_shadow, vec2(v_extra.x, 0));\n"
+        "        vec3 masked = mix(texture.rgb, u_maskColor.rgb, u_maskColor.a);\n"
+        "        gl_FragColor = vec4(masked * (1.0 - shadow.a) + shadow.rgb, 1.0);\n"
+        "    }\n"
+        "    else if (v_material < 3.5) {\n"
+        "        gl_FragColor = vec4(v_extra.x, v_extra.x, v_extra.x, v_extra.y);\n"
+        "    }\n"
+        "    else {\n"
+        "        gl_FragColor = vec4(texture2D(u_pageTexture, v_texCoord).rgb, 1.0);\n"
+        "    }\n"
+        "}";
+
+static const char *VAR_VERTEX_POS       = "a_vexPosition";
+static const char *VAR_TEXTURE_COORD    = "a_texCoord";
+static const char *VAR_EXTRA            = "a_extra";
+static const char *VAR_FIRST_TEXTURE    = "u_firstTexture";
+static const char *VAR_SECOND_TEXTURE   = "u_secondTexture";
+static const char *VAR_BACK_TEXTURE     = "u_backTexture";
+static const char *VAR_SHADOW_TEXTURE   = "u_shadow";
+static const char *VAR_PAGE_TEXTURE     = "u_pageTexture";
+static const char *VAR_MASK_COLOR       = "u_maskColor";
+static const char *VAR_TEXTURE_OFFSET   = "u_texXOffset";
+
+SinglePassVertexProgram::SinglePassVertexProgram()
+        : mVertexPosLoc(Constant::kGlInValidLocation),
+          mTexCoordLoc(Constant::kGlInValidLocation),
+          mExtraLoc(Constant::kGlInValidLocation),
+          mFirstTextureLoc(Constant::kGlInValidLocation),
+          mSecondTextureLoc(Constant::kGlInValidLocation),
+          mBackTextureLoc(Constant::kGlInValidLocation),
+          mShadowLoc(Constant::kGlInValidLocation),
+          mPageTextureLoc(Constant::kGlInValidLocation),
+          mMaskColorLoc(Constant::kGlInValidLocation),
+          mTexXOffsetLoc(Constant::kGlInValidLocation) {
+}
+
+SinglePassVertexProgram::~SinglePassVertexProgram() {
+    clean();
+}
+
+void SinglePassVertexProgram::clean() {
+    mVertexPosLoc = Constant::kGlInValidLocation;
+    mTexCoordLoc = Constant::kGlInValidLocation;
+    mExtraLoc = Constant::kGlInValidLocation;
+    mFirstTextureLoc = Constant::kGlInValidLocation;
+    mSecondTextureLoc = Constant::kGlInValidLocation;
+    mBackTextureLoc = Constant::kGlInValidLocation;
+    mShadowLoc = Constant::kGlInValidLocation;
+    mPageTextureLoc = Constant::kGlInValidLocation;
+    mMaskColorLoc = Constant::kGlInValidLocation;
+    mTexXOffsetLoc = Constant::kGlInValidLocation;
+
+    GLProgram::clean();
+}
+
+int SinglePassVertexProgram::init() {
+    clean();
+    return GLProgram::init(g_vertex_shader, g_fragment_shader);
+}
+
+void SinglePassVertexProgram::getVarsLocation() {
+    mVertexPosLoc = glGetAttribLocation(mProgramRef, VAR_VERTEX_POS);
+    mTexCoordLoc = glGetAttribLocation(mProgramRef, VAR_TEXTURE_COORD);
+    mExtraLoc = glGetAttribLocation(mProgramRef, VAR_EXTRA);
+    mFirstTextureLoc = glGetUniformLocation(mProgramRef, VAR_FIRST_TEXTURE);
+    mSecondTextureLoc = glGetUniformLocation(mProgramRef, VAR_SECOND_TEXTURE);
+    mBackTextureLoc = glGetUniformLocation(mProgramRef, VAR_BACK_TEXTURE);
+    mShadowLoc = glGetUniformLocation(mProgramRef, VAR_SHADOW_TEXTURE);
+    mPageTextureLoc = glGetUniformLocation(mProgramRef, VAR_PAGE_TEXTURE);
+    mMaskColorLoc = glGetUniformLocation(mProgramRef, VAR_MASK_COLOR);
+    mTexXOffsetLoc = glGetUniformLocation(mProgramRef, VAR_TEXTURE_OFFSET);
+}
+
+}
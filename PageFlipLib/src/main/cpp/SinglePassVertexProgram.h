@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_SINGLEPASSVERTEXPROGRAM_H
+#define ANDROID_PAGEFLIP_SINGLEPASSVERTEXPROGRAM_H
+
+#include "GLProgram.h"
+
+namespace eschao {
+
+/**
+ * Uber shader program which draws the whole flip frame: front page with the
+ * first and second texture, back of fold, fold shadows and the second page,
+ * in one draw call. The material of every vertex is stored in the w component
+ * of its position and selects the shading branch in fragment shader
+ */
+class SinglePassVertexProgram : public GLProgram {
+
+public:
+    SinglePassVertexProgram();
+    virtual ~SinglePassVertexProgram();
+
+    int init();
+    virtual void clean();
+
+    // inline
+    inline GLint vertexPosLoc() {
+        return mVertexPosLoc;
+    }
+
+    inline GLint texCoordLoc() {
+        return mTexCoordLoc;
+    }
+
+    inline GLint extraLoc() {
+        return mExtraLoc;
+    }
+
+    inline GLint firstTextureLoc() {
+        return mFirstTextureLoc;
+    }
+
+    inline GLint secondTextureLoc() {
+        return mSecondTextureLoc;
+    }
+
+    inline GLint backTextureLoc() {
+        return mBackTextureLoc;
+    }
+
+    inline GLint shadowLoc() {
+        return mShadowLoc;
+    }
+
+    inline GLint pageTextureLoc() {
+        return mPageTextureLoc;
+    }
+
+    inline GLint maskColorLoc() {
+        return mMaskColorLoc;
+    }
+
+    inline GLint texXOffsetLoc() {
+        return mTexXOffsetLoc;
+    }
+
+protected:
+    virtual void getVarsLocation();
+
+protected:
+    GLint mVertexPosLoc;
+    GLint mTexCoordLoc;
+    GLint mExtraLoc;
+    GLint mFirstTextureLoc;
+    GLint mSecondTextureLoc;
+    GLint mBackTextureLoc;
+    GLint mShadowLoc;
+    GLint mPageTextureLoc;
+    GLint mMaskColorLoc;
+    GLint mTexXOffsetLoc;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_SINGLEPASSVERTEXPROGRAM_H
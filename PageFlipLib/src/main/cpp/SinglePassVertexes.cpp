@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Page.h"
+#include "Error.h"
+#include "Utility.h"
+#include "SinglePassVertexes.h"
+#include "SinglePassVertexProgram.h"
+
+namespace eschao {
+
+static const auto TAG = "SinglePassVertexes";
+
+SinglePassVertexes::SinglePassVertexes()
+        : mCapacity(0),
+          mCount(0),
+          mIsStitching(false) {
+}
+
+SinglePassVertexes::~SinglePassVertexes() {
+    release();
+}
+
+void SinglePassVertexes::release() {
+    mVertexes.release();
+    mCount = 0;
+    mCapacity = 0;
+    mIsStitching = false;
+}
+
+/**
+ * Allocate buffer
+ *
+ * @param capacity vertex count, please include the extra vertexes used to
+ *                 stitch strips, at most 3 for every strip
+ */
+int SinglePassVertexes::set(int capacity) {
+    if (capacity < 1) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    release();
+    mCapacity = capacity;
+    mVertexes.allocate(capacity * kSinglePassVexSize);
+    return Error::OK;
+}
+
+/**
+ * Set buffer with memory from arena, nothing is allocated from heap
+ */
+int SinglePassVertexes::set(VertexArena &arena, int capacity) {
+    if (capacity < 1) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    release();
+    mVertexes = arena.allocate(capacity * kSinglePassVexSize);
+    if (mVertexes.isNull()) {
+        return gError.set(Error::ERROR);
+    }
+
+    mCapacity = capacity;
+    return Error::OK;
+}
+
+/**
+ * Prepare to append a new sub strip
+ * <p>If there are already vertexes in buffer, the last vertex will be
+ * repeated and the first vertex of new strip will be repeated too, that makes
+ * the joint triangles degenerated. The first triangle of new strip is always
+ * started at even position to keep the same winding with its source strip</p>
+ *
+ * @param length vertex count of the new strip
+ * @return false if there is nothing to add or buffer is overflow
+ */
+bool SinglePassVertexes::beginStrip(int length) {
+    if (length < 1) {
+        return false;
+    }
+
+    if (mCount + length + 3 > mCapacity) {
+        LOGE(TAG, "No enough space for strip, capacity: %d, count: %d, "
+                  "length: %d", mCapacity, mCount, length);
+        return false;
+    }
+
+    mIsStitching = mCount > 0;
+    if (mIsStitching) {
+        repeatLastVertex();
+        if ((mCount & 1) == 0) {
+            repeatLastVertex();
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Append a strip from page or back of fold vertexes
+ *
+ * @param material material of strip
+ * @param vertexes vertex buffer with 3 or 4 components per vertex, the 4th
+ *                 component is saved as the first extra component
+ * @param sizeOfPerVex component size of per vertex
+ * @param texCoords texture coordinates buffer
+ * @param offset the first vertex to append
+ * @param length vertex count to append
+ */
+SinglePassVertexes& SinglePassVertexes::addStrip(SinglePassMaterial material,
+                                                 const float *vertexes,
+                                                 int sizeOfPerVex,
+                                                 const float *texCoords,
+                                                 int offset, int length) {
+    if (!beginStrip(length)) {
+        return *this;
+    }
+
+    const float m = material;
+    const float *v = vertexes + offset * sizeOfPerVex;
+    const float *t = texCoords + (offset << 1);
+    for (int i = 0; i < length; ++i, v += sizeOfPerVex, t += 2) {
+        addVertex(v[0], v[1], v[2], m, t[0], t[1],
+                  sizeOfPerVex > 3 ? v[3] : 0, 0);
+        if (mIsStitching) {
+            repeatLastVertex();
+            mIsStitching = false;
+        }
+    }
+
+    return *this;
+}
+
+/**
+ * Append a strip from shadow vertexes which are (x, y) pairs of shadow start
+ * and end
+ *
+ * @param vertexes shadow vertex buffer
+ * @param length vertex count
+ * @param color shadow color of start and end
+ * @param z z coordinate of shadow
+ */
+SinglePassVertexes& SinglePassVertexes::addShadowStrip(const float *vertexes,
+                                                       int length,
+                                                       const ShadowColor &color,
+                                                       float z) {
+    if (!beginStrip(length)) {
+        return *this;
+    }
+
+    const float m = SHADOW_MATERIAL;
+    const float *v = vertexes;
+    for (int i = 0; i < length; ++i, v += 2) {
+        if (i & 1) {
+            addVertex(v[0], v[1], z, m, 0, 0, color.endColor, color.endAlpha);
+        }
+        else {
+            addVertex(v[0], v[1], z, m, 0, 0,
+                      color.startColor, color.startAlpha);
+        }
+
+        if (mIsStitching) {
+            repeatLastVertex();
+            mIsStitching = false;
+        }
+    }
+
+    return *this;
+}
+
+/**
+ * Append a page quad which is drawn as triangle fan in multi-passes
+ * rendering, the fan order 0, 1, 2, 3 is converted to strip order 0, 1, 3, 2
+ *
+ * @param material material of quad
+ * @param apexes 4 apexes with 3 components per apex
+ * @param texCoords texture coordinates of apexes
+ */
+SinglePassVertexes& SinglePassVertexes::addQuad(SinglePassMaterial material,
+                                                const float *apexes,
+                                                const float *texCoords) {
+    static const int kQuadStripOrder[] = {0, 1, 3, 2};
+    if (!beginStrip(4)) {
+        return *this;
+    }
+
+    const float m = material;
+    for (int i = 0; i < 4; ++i) {
+        const int k = kQuadStripOrder[i];
+        const float *v = apexes + k * 3;
+        const float *t = texCoords + (k << 1);
+        addVertex(v[0], v[1], v[2], m, t[0], t[1], 0, 0);
+        if (mIsStitching) {
+            repeatLastVertex();
+            mIsStitching = false;
+        }
+    }
+
+    return *this;
+}
+
+/**
+ * Draw all strips with one draw call
+ * <p>Blend is enabled for the whole strip, since page materials always
+ * output opaque color, the result is same with multi-passes rendering</p>
+ *
+ * @param program single pass program
+ * @param page the first page
+ * @param secondPage the second page, NULL if there is only one page
+ * @param maskAlpha mask alpha of back of fold
+ * @param gradientLightId gradient light texture id
+ */
+void SinglePassVertexes::draw(SinglePassVertexProgram &program,
+                              Page &page,
+                              Page *secondPage,
+                              float maskAlpha,
+                              GLuint gradientLightId) {
+    if (mCount < 3) {
+        return;
+    }
+
+    program.uploadMVPMatrix();
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, page.textures.firstTextureId());
+    glUniform1i(program.firstTextureLoc(), 0);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, page.textures.secondTextureId());
+    glUniform1i(program.secondTextureLoc(), 1);
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, page.textures.backTextureId());
+    glUniform1i(program.backTextureLoc(), 2);
+
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, gradientLightId);
+    glUniform1i(program.shadowLoc(), 3);
+
+    if (secondPage) {
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, secondPage->textures.firstTextureId());
+        glUniform1i(program.pageTextureLoc(), 4);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    glUniform1f(program.texXOffsetLoc(), secondPage ? 1.0f : 0);
+    const float *maskColor = page.textures.getMaskColorOfFirstTexture();
+    glUniform4f(program.maskColorLoc(),
+                maskColor[0], maskColor[1], maskColor[2],
+                secondPage ? 0 : maskAlpha);
+
+    const GLsizei stride = sizeof(float) * kSinglePassVexSize;
+    glVertexAttribPointer(program.vertexPosLoc(), 4, GL_FLOAT, GL_FALSE,
+                          stride, mVertexes.data());
+    glEnableVertexAttribArray(program.vertexPosLoc());
+    glVertexAttribPointer(program.texCoordLoc(), 2, GL_FLOAT, GL_FALSE,
+                          stride, mVertexes.data() + 4);
+    glEnableVertexAttribArray(program.texCoordLoc());
+    glVertexAttribPointer(program.extraLoc(), 2, GL_FLOAT, GL_FALSE,
+                          stride, mVertexes.data() + 6);
+    glEnableVertexAttribArray(program.extraLoc());
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, mCount);
+    glDisable(GL_BLEND);
+
+    // the extra attribute is not used by other programs
+    glDisableVertexAttribArray(program.extraLoc());
+}
+
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_SINGLEPASSVERTEXES_H
+#define ANDROID_PAGEFLIP_SINGLEPASSVERTEXES_H
+
+#include <string.h>
+#include <GLES2/gl2.h>
+#include "ShadowColor.h"
+#include "VertexArena.h"
+
+namespace eschao {
+
+class Page;
+class SinglePassVertexProgram;
+
+// float size of every vertex: x, y, z, material, tx, ty, ex, ey
+static const int kSinglePassVexSize = 8;
+
+enum SinglePassMaterial {
+    FIRST_TEXTURE_MATERIAL = 0,
+    SECOND_TEXTURE_MATERIAL,
+    BACK_OF_FOLD_MATERIAL,
+    SHADOW_MATERIAL,
+    SECOND_PAGE_MATERIAL,
+};
+
+/**
+ * Interleaved vertex buffer for drawing the whole flip frame in one triangle
+ * strip. Every part of frame is appended as a sub strip and sub strips are
+ * stitched together with degenerate triangles
+ * <p>The extra two components are different with material:</p>
+ * <ul>
+ *     <li>Back of fold: ex is the x coordinate of gradient light texture</li>
+ *     <li>Shadow: ex is the shadow color and ey is the alpha</li>
+ * </ul>
+ */
+class SinglePassVertexes {
+
+public:
+    SinglePassVertexes();
+    ~SinglePassVertexes();
+
+    void release();
+    int set(int capacity);
+    int set(VertexArena &arena, int capacity);
+    SinglePassVertexes& addStrip(SinglePassMaterial material,
+                                 const float *vertexes, int sizeOfPerVex,
+                                 const float *texCoords,
+                                 int offset, int length);
+    SinglePassVertexes& addShadowStrip(const float *vertexes, int length,
+                                       const ShadowColor &color, float z);
+    SinglePassVertexes& addQuad(SinglePassMaterial material,
+                                const float *apexes, const float *texCoords);
+    void draw(SinglePassVertexProgram &program, Page &page, Page *secondPage,
+              float maskAlpha, GLuint gradientLightId);
+
+    // inline
+    inline int capacity() {
+        return mCapacity;
+    }
+
+    inline int count() {
+        return mCount;
+    }
+
+    inline void reset() {
+        mCount = 0;
+    }
+
+    static inline size_t sizeInArena(int capacity) {
+        return VertexArena::alignedSize(capacity * kSinglePassVexSize);
+    }
+
+private:
+    bool beginStrip(int length);
+
+    inline void addVertex(float x, float y, float z, float material,
+                          float tx, float ty, float ex, float ey) {
+        float *v = mVertexes.data() + mCount * kSinglePassVexSize;
+        v[0] = x;
+        v[1] = y;
+        v[2] = z;
+        v[3] = material;
+        v[4] = tx;
+        v[5] = ty;
+        v[6] = ex;
+        v[7] = ey;
+        ++mCount;
+    }
+
+    inline void repeatLastVertex() {
+        float *v = mVertexes.data() + mCount * kSinglePassVexSize;
+        memcpy(v, v - kSinglePassVexSize, sizeof(float) * kSinglePassVexSize);
+        ++mCount;
+    }
+
+private:
+    int mCapacity;
+    int mCount;
+    // is the first vertex of current strip needed to repeat for stitching
+    bool mIsStitching;
+    // buffer allocated by itself or borrowed from arena
+    VertexBlock mVertexes;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_SINGLEPASSVERTEXES_H
@@ -0,0 +1,453 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "SoftwareRenderBackend.h"
+#include "PngWriter.h"
+#include "Error.h"
+
+using namespace std;
+
+namespace eschao {
+
+static inline float clampf(float v, float min, float max) {
+    return v < min ? min : (v > max ? max : v);
+}
+
+SoftwareRenderBackend::SoftwareRenderBackend()
+        : mWidth(0),
+          mHeight(0),
+          mHasDepthTest(true),
+          mNextTextureId(1) {
+}
+
+int SoftwareRenderBackend::init() {
+    return Error::OK;
+}
+
+void SoftwareRenderBackend::setViewport(int width, int height,
+                                        const Mat4 &mvp) {
+    mWidth = width;
+    mHeight = height;
+    mMVPMatrix = mvp;
+    mColorBuffer.assign((size_t)width * height * 4, 0);
+    mDepthBuffer.assign((size_t)width * height, 1.0f);
+}
+
+/**
+ * Clear color buffer to opaque black and depth buffer to 1.0, same with GL
+ * backend
+ */
+void SoftwareRenderBackend::beginFrame(bool hasDepthTest) {
+    mHasDepthTest = hasDepthTest;
+    for (size_t i = 0; i < mColorBuffer.size(); i += 4) {
+        mColorBuffer[i] = 0;
+        mColorBuffer[i + 1] = 0;
+        mColorBuffer[i + 2] = 0;
+        mColorBuffer[i + 3] = 255;
+    }
+
+    if (hasDepthTest) {
+        fill(mDepthBuffer.begin(), mDepthBuffer.end(), 1.0f);
+    }
+}
+
+GLuint SoftwareRenderBackend::createTexture(AndroidBitmapInfo &info,
+                                            const void *data) {
+    if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 &&
+        info.format != ANDROID_BITMAP_FORMAT_RGB_565) {
+        return 0;
+    }
+
+    const GLuint id = mNextTextureId++;
+    Bitmap_ &bitmap = mTextures[id];
+    bitmap.width = info.width;
+    bitmap.height = info.height;
+    bitmap.pixels.resize((size_t)info.width * info.height * 4);
+
+    unsigned char *dst = &bitmap.pixels[0];
+    for (uint32_t y = 0; y < info.height; ++y) {
+        const unsigned char *row = (const unsigned char *)data +
+                                   (size_t)info.stride * y;
+        if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
+            memcpy(dst, row, (size_t)info.width * 4);
+            dst += info.width * 4;
+            continue;
+        }
+
+        const uint16_t *rgb565 = (const uint16_t *)row;
+        for (uint32_t x = 0; x < info.width; ++x, dst += 4) {
+            const uint16_t c = rgb565[x];
+            dst[0] = (unsigned char)(((c >> 11) & 0x1F) * 255 / 31);
+            dst[1] = (unsigned char)(((c >> 5) & 0x3F) * 255 / 63);
+            dst[2] = (unsigned char)((c & 0x1F) * 255 / 31);
+            dst[3] = 255;
+        }
+    }
+
+    return id;
+}
+
+void SoftwareRenderBackend::deleteTextures(int count, const GLuint *ids) {
+    for (int i = 0; i < count; ++i) {
+        mTextures.erase(ids[i]);
+    }
+}
+
+void SoftwareRenderBackend::drawPage(PrimitiveType type,
+                                     const float *vertexes,
+                                     int sizeOfPerVex,
+                                     const float *texCoords,
+                                     int offset,
+                                     int count,
+                                     GLuint textureId) {
+    mVertexes.resize(count > 0 ? count : 0);
+    for (int i = 0; i < count; ++i) {
+        const float *v = vertexes + (offset + i) * sizeOfPerVex;
+        const float *t = texCoords + (offset + i) * 2;
+        Vertex_ &vex = mVertexes[i];
+        vex = transform(v[0], v[1], v[2]);
+        vex.varyings[0] = t[0];
+        vex.varyings[1] = t[1];
+        if (mFoldShadow) {
+            mFoldShadow->computeVaryings(v[0], v[1], vex.varyings + 2);
+        }
+    }
+
+    Material_ material;
+    material.shading = PAGE_SHADING;
+    material.texture = texture(textureId);
+    material.foldShadow = mFoldShadow;
+    drawTriangles(type, mVertexes.data(), count, material);
+}
+
+void SoftwareRenderBackend::drawShadow(const float *vertexes,
+                                       const float *gradients,
+                                       int count,
+                                       const ShadowColor &color,
+                                       float vertexZ) {
+    mVertexes.resize(count > 0 ? count : 0);
+    for (int i = 0; i < count; ++i) {
+        const float *v = vertexes + i * 2;
+        const float t = gradients ? gradients[i] : (float)(i & 1);
+        Vertex_ &vex = mVertexes[i];
+        vex = transform(v[0], v[1], vertexZ);
+        vex.varyings[0] = color.startColor +
+                          (color.endColor - color.startColor) * t;
+        vex.varyings[1] = color.startAlpha +
+                          (color.endAlpha - color.startAlpha) * t;
+    }
+
+    Material_ material;
+    material.shading = SHADOW_SHADING;
+    material.foldShadow = NULL;
+    drawTriangles(TRIANGLE_STRIP, mVertexes.data(), count, material);
+}
+
+void SoftwareRenderBackend::drawBackOfFold(const float *vertexes,
+                                           const float *texCoords,
+                                           int count,
+                                           GLuint textureId,
+                                           GLuint gradientLightId,
+                                           const float *maskColor,
+                                           float maskAlpha,
+                                           float texXOffset) {
+    mVertexes.resize(count > 0 ? count : 0);
+    for (int i = 0; i < count; ++i) {
+        const float *v = vertexes + i * 4;
+        const float *t = texCoords + i * 2;
+        Vertex_ &vex = mVertexes[i];
+        vex = transform(v[0], v[1], v[2]);
+        vex.varyings[0] = fabsf(t[0] - texXOffset);
+        vex.varyings[1] = t[1];
+        vex.varyings[2] = clampf(fabsf(v[3]), 0.01f, 1.0f);
+    }
+
+    Material_ material;
+    material.shading = BACK_OF_FOLD_SHADING;
+    material.foldShadow = NULL;
+    material.texture = texture(textureId);
+    material.gradientLight = texture(gradientLightId);
+    material.maskColor[0] = maskColor[0];
+    material.maskColor[1] = maskColor[1];
+    material.maskColor[2] = maskColor[2];
+    material.maskColor[3] = maskAlpha;
+    drawTriangles(TRIANGLE_STRIP, mVertexes.data(), count, material);
+}
+
+void SoftwareRenderBackend::drawFoldClippedPage(const float *vertexes,
+                                                const float *texCoords,
+                                                const float *foldLine,
+                                                float vertexZ,
+                                                GLuint firstTextureId,
+                                                GLuint secondTextureId) {
+    mVertexes.resize(4);
+    for (int i = 0; i < 4; ++i) {
+        const float *v = vertexes + i * 3;
+        const float *t = texCoords + i * 2;
+        Vertex_ &vex = mVertexes[i];
+        vex = transform(v[0], v[1], vertexZ);
+        vex.varyings[0] = t[0];
+        vex.varyings[1] = t[1];
+        if (mFoldShadow) {
+            mFoldShadow->computeVaryings(v[0], v[1], vex.varyings + 2);
+        }
+        vex.varyings[2 + kFoldShadowVaryingCount] =
+                foldLine[0] * v[0] + foldLine[1] * v[1] + foldLine[2];
+    }
+
+    Material_ material;
+    material.shading = FOLD_CLIP_SHADING;
+    material.texture = texture(firstTextureId);
+    material.secondTexture = texture(secondTextureId);
+    material.foldShadow = mFoldShadow;
+    drawTriangles(TRIANGLE_FAN, mVertexes.data(), 4, material);
+}
+
+int SoftwareRenderBackend::writePNG(const char *path) {
+    if (mColorBuffer.empty()) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    return PngWriter::write(path, mWidth, mHeight, &mColorBuffer[0],
+                            (size_t)mWidth * 4);
+}
+
+/**
+ * Transform vertex to screen space, the first row of screen is the top
+ */
+SoftwareRenderBackend::Vertex_ SoftwareRenderBackend::transform(float x,
+                                                                float y,
+                                                                float z) {
+    const float *m = mMVPMatrix.data();
+    const float cx = m[0] * x + m[4] * y + m[8] * z + m[12];
+    const float cy = m[1] * x + m[5] * y + m[9] * z + m[13];
+    const float cz = m[2] * x + m[6] * y + m[10] * z + m[14];
+    const float cw = m[3] * x + m[7] * y + m[11] * z + m[15];
+    const float invW = cw != 0 ? 1.0f / cw : 0;
+
+    Vertex_ vex;
+    vex.x = (cx * invW + 1.0f) * 0.5f * mWidth;
+    vex.y = (1.0f - cy * invW) * 0.5f * mHeight;
+    vex.z = (cz * invW + 1.0f) * 0.5f;
+    memset(vex.varyings, 0, sizeof(vex.varyings));
+    return vex;
+}
+
+const SoftwareRenderBackend::Bitmap_* SoftwareRenderBackend::texture(
+        GLuint id) {
+    std::map<GLuint, Bitmap_>::const_iterator it = mTextures.find(id);
+    return it != mTextures.end() ? &it->second : NULL;
+}
+
+void SoftwareRenderBackend::drawTriangles(PrimitiveType type,
+                                          const Vertex_ *vertexes,
+                                          int count,
+                                          const Material_ &material) {
+    for (int i = 2; i < count; ++i) {
+        if (type == TRIANGLE_FAN) {
+            rasterize(vertexes[0], vertexes[i - 1], vertexes[i], material);
+        }
+        else {
+            rasterize(vertexes[i - 2], vertexes[i - 1], vertexes[i],
+                      material);
+        }
+    }
+}
+
+/**
+ * Rasterize triangle with edge functions at pixel centers
+ * <p>Pixels exactly on an edge are only drawn by the triangle on the top or
+ * left side, so shared edges of strips are not blended twice</p>
+ */
+void SoftwareRenderBackend::rasterize(const Vertex_ &a,
+                                      const Vertex_ &b0,
+                                      const Vertex_ &c0,
+                                      const Material_ &material) {
+    float area = (b0.x - a.x) * (c0.y - a.y) - (b0.y - a.y) * (c0.x - a.x);
+    if (fabsf(area) < 1e-6f) {
+        return;
+    }
+
+    // make triangle in positive orientation
+    const bool isSwapped = area < 0;
+    const Vertex_ &b = isSwapped ? c0 : b0;
+    const Vertex_ &c = isSwapped ? b0 : c0;
+    area = fabsf(area);
+
+    int minX = max(0, (int)floorf(min(a.x, min(b.x, c.x))));
+    int maxX = min(mWidth - 1, (int)ceilf(max(a.x, max(b.x, c.x))));
+    int minY = max(0, (int)floorf(min(a.y, min(b.y, c.y))));
+    int maxY = min(mHeight - 1, (int)ceilf(max(a.y, max(b.y, c.y))));
+
+    // scissor of blended passes, its y is from bottom of surface
+    const bool isBlending = material.shading == SHADOW_SHADING;
+    if (isBlending && mBlendScissor) {
+        minX = max(minX, mBlendScissor[0]);
+        maxX = min(maxX, mBlendScissor[0] + mBlendScissor[2] - 1);
+        minY = max(minY, mHeight - mBlendScissor[1] - mBlendScissor[3]);
+        maxY = min(maxY, mHeight - mBlendScissor[1] - 1);
+    }
+
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+
+    // edge function of v0->v1: (v1.x - v0.x) * (p.y - v0.y) -
+    //                          (v1.y - v0.y) * (p.x - v0.x)
+    const Vertex_ *edges[3][2] = { { &b, &c }, { &c, &a }, { &a, &b } };
+    float dx[3], dy[3], rowE[3], bias[3];
+    const float px = minX + 0.5f;
+    const float py = minY + 0.5f;
+    for (int i = 0; i < 3; ++i) {
+        const Vertex_ &v0 = *edges[i][0];
+        const Vertex_ &v1 = *edges[i][1];
+        dx[i] = v1.x - v0.x;
+        dy[i] = v1.y - v0.y;
+        rowE[i] = dx[i] * (py - v0.y) - dy[i] * (px - v0.x);
+        // top-left rule: pixels on other edges are excluded
+        bias[i] = (dy[i] < 0 || (dy[i] == 0 && dx[i] > 0)) ? 0 : -1e-7f;
+    }
+
+    const float invArea = 1.0f / area;
+    const int varyingCount = material.shading == BACK_OF_FOLD_SHADING ? 3 :
+                             (material.shading == FOLD_CLIP_SHADING ?
+                              3 + kFoldShadowVaryingCount :
+                              (material.foldShadow ?
+                               2 + kFoldShadowVaryingCount : 2));
+    float varyings[3 + kFoldShadowVaryingCount];
+    float color[4];
+
+    for (int y = minY; y <= maxY; ++y) {
+        float e0 = rowE[0], e1 = rowE[1], e2 = rowE[2];
+        for (int x = minX; x <= maxX; ++x,
+                e0 -= dy[0], e1 -= dy[1], e2 -= dy[2]) {
+            if (e0 + bias[0] < 0 || e1 + bias[1] < 0 || e2 + bias[2] < 0 ||
+                (e0 == 0 && bias[0] < 0) || (e1 == 0 && bias[1] < 0) ||
+                (e2 == 0 && bias[2] < 0)) {
+                continue;
+            }
+
+            const float wa = e0 * invArea;
+            const float wb = e1 * invArea;
+            const float wc = 1.0f - wa - wb;
+            const size_t index = (size_t)y * mWidth + x;
+            if (mHasDepthTest) {
+                const float z = wa * a.z + wb * b.z + wc * c.z;
+                if (z >= mDepthBuffer[index]) {
+                    continue;
+                }
+                mDepthBuffer[index] = z;
+            }
+
+            for (int i = 0; i < varyingCount; ++i) {
+                varyings[i] = wa * a.varyings[i] + wb * b.varyings[i] +
+                              wc * c.varyings[i];
+            }
+            shade(material, varyings, color);
+
+            unsigned char *dst = &mColorBuffer[index * 4];
+            if (isBlending) {
+                const float alpha = color[3];
+                for (int i = 0; i < 4; ++i) {
+                    const float d = dst[i] / 255.0f;
+                    const float s = i < 3 ? color[i] : alpha;
+                    color[i] = s * alpha + d * (1.0f - alpha);
+                }
+            }
+
+            for (int i = 0; i < 4; ++i) {
+                dst[i] = (unsigned char)(clampf(color[i], 0, 1) * 255 + 0.5f);
+            }
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            rowE[i] += dx[i];
+        }
+    }
+}
+
+/**
+ * Fragment shading, same with fragment shaders of GL programs
+ */
+void SoftwareRenderBackend::shade(const Material_ &material,
+                                  const float *varyings,
+                                  float *color) {
+    if (material.shading == PAGE_SHADING ||
+        material.shading == FOLD_CLIP_SHADING) {
+        const bool isRevealed = material.shading == FOLD_CLIP_SHADING &&
+                                varyings[2 + kFoldShadowVaryingCount] > 0;
+        sample(isRevealed ? material.secondTexture : material.texture,
+               varyings[0], varyings[1], color);
+        if (material.foldShadow) {
+            material.foldShadow->cast(varyings + 2, color);
+        }
+    }
+    else if (material.shading == SHADOW_SHADING) {
+        color[0] = color[1] = color[2] = varyings[0];
+        color[3] = varyings[1];
+    }
+    else {
+        float texture[4], shadow[4];
+        sample(material.texture, varyings[0], varyings[1], texture);
+        sample(material.gradientLight, varyings[2], 0, shadow);
+        const float *mask = material.maskColor;
+        for (int i = 0; i < 3; ++i) {
+            const float masked = texture[i] + (mask[i] - texture[i]) * mask[3];
+            color[i] = masked * (1.0f - shadow[3]) + shadow[i];
+        }
+        color[3] = 1.0f;
+    }
+}
+
+/**
+ * Bilinear sampling with clamp to edge, missing texture is sampled as
+ * opaque black like an incomplete GL texture
+ */
+void SoftwareRenderBackend::sample(const Bitmap_ *bitmap, float s, float t,
+                                   float *color) {
+    if (bitmap == NULL || bitmap->pixels.empty()) {
+        color[0] = color[1] = color[2] = 0;
+        color[3] = 1.0f;
+        return;
+    }
+
+    const float u = clampf(s * bitmap->width - 0.5f, 0, bitmap->width - 1);
+    const float v = clampf(t * bitmap->height - 0.5f, 0, bitmap->height - 1);
+    const int x0 = (int)u;
+    const int y0 = (int)v;
+    const int x1 = min(x0 + 1, bitmap->width - 1);
+    const int y1 = min(y0 + 1, bitmap->height - 1);
+    const float fx = u - x0;
+    const float fy = v - y0;
+
+    const unsigned char *p = &bitmap->pixels[0];
+    const size_t rowSize = (size_t)bitmap->width * 4;
+    const unsigned char *p00 = p + y0 * rowSize + x0 * 4;
+    const unsigned char *p01 = p + y0 * rowSize + x1 * 4;
+    const unsigned char *p10 = p + y1 * rowSize + x0 * 4;
+    const unsigned char *p11 = p + y1 * rowSize + x1 * 4;
+    for (int i = 0; i < 4; ++i) {
+        const float top = p00[i] + (p01[i] - p00[i]) * fx;
+        const float bottom = p10[i] + (p11[i] - p10[i]) * fx;
+        color[i] = (top + (bottom - top) * fy) / 255.0f;
+    }
+}
+
+}
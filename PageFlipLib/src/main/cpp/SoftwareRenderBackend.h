@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_SOFTWARERENDERBACKEND_H
+#define ANDROID_PAGEFLIP_SOFTWARERENDERBACKEND_H
+
+#include <map>
+#include <vector>
+#include "RenderBackend.h"
+#include "FoldShadow.h"
+
+namespace eschao {
+
+/**
+ * Render backend with CPU triangle rasterizer
+ * <p>It renders flip frames without GL context, e.g. golden-image tests on
+ * Linux. Shading is same with shaders of GL backend: bilinear texture
+ * sampling, alpha blending of shadows and depth test with GL_LESS.</p>
+ * <p>Color buffer is RGBA_8888 and its first row is the top of frame, it
+ * can be written to PNG file by {@link #writePNG(const char*)}</p>
+ */
+class SoftwareRenderBackend : public RenderBackend {
+
+public:
+    SoftwareRenderBackend();
+
+    virtual int init();
+    virtual void setViewport(int width, int height, const Mat4 &mvp);
+    virtual void beginFrame(bool hasDepthTest);
+    virtual GLuint createTexture(AndroidBitmapInfo &info, const void *data);
+    virtual void deleteTextures(int count, const GLuint *ids);
+    virtual void drawPage(PrimitiveType type,
+                          const float *vertexes,
+                          int sizeOfPerVex,
+                          const float *texCoords,
+                          int offset,
+                          int count,
+                          GLuint textureId);
+    virtual void drawShadow(const float *vertexes,
+                            const float *gradients,
+                            int count,
+                            const ShadowColor &color,
+                            float vertexZ);
+    virtual void drawBackOfFold(const float *vertexes,
+                                const float *texCoords,
+                                int count,
+                                GLuint textureId,
+                                GLuint gradientLightId,
+                                const float *maskColor,
+                                float maskAlpha,
+                                float texXOffset);
+    virtual void drawFoldClippedPage(const float *vertexes,
+                                     const float *texCoords,
+                                     const float *foldLine,
+                                     float vertexZ,
+                                     GLuint firstTextureId,
+                                     GLuint secondTextureId);
+
+    virtual bool isFoldShadowSupported() {
+        return true;
+    }
+
+    virtual bool isFoldClipSupported() {
+        return true;
+    }
+
+    int writePNG(const char *path);
+
+    inline int width() {
+        return mWidth;
+    }
+
+    inline int height() {
+        return mHeight;
+    }
+
+    inline const unsigned char* pixels() {
+        return mColorBuffer.empty() ? NULL : &mColorBuffer[0];
+    }
+
+private:
+    enum Shading {
+        PAGE_SHADING,
+        SHADOW_SHADING,
+        BACK_OF_FOLD_SHADING,
+        FOLD_CLIP_SHADING,
+    };
+
+    // RGBA_8888 texture
+    struct Bitmap_ {
+        int width;
+        int height;
+        std::vector<unsigned char> pixels;
+    };
+
+    // vertex in screen space, varyings are interpolated linearly, the
+    // page varyings are followed by varyings of fold shadow and distance to
+    // fold line
+    struct Vertex_ {
+        float x;
+        float y;
+        float z;
+        float varyings[3 + kFoldShadowVaryingCount];
+    };
+
+    // uniforms of current draw call
+    struct Material_ {
+        Shading shading;
+        const Bitmap_ *texture;
+        const Bitmap_ *secondTexture;
+        const Bitmap_ *gradientLight;
+        float maskColor[4];
+        const FoldShadow *foldShadow;
+    };
+
+    Vertex_ transform(float x, float y, float z);
+    const Bitmap_* texture(GLuint id);
+    void drawTriangles(PrimitiveType type, const Vertex_ *vertexes,
+                       int count, const Material_ &material);
+    void rasterize(const Vertex_ &a, const Vertex_ &b, const Vertex_ &c,
+                   const Material_ &material);
+    void shade(const Material_ &material, const float *varyings,
+               float *color);
+    void sample(const Bitmap_ *bitmap, float s, float t, float *color);
+
+private:
+    int mWidth;
+    int mHeight;
+    Mat4 mMVPMatrix;
+    bool mHasDepthTest;
+    std::vector<unsigned char> mColorBuffer;
+    std::vector<float> mDepthBuffer;
+    std::vector<Vertex_> mVertexes;
+
+    GLuint mNextTextureId;
+    std::map<GLuint, Bitmap_> mTextures;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_SOFTWARERENDERBACKEND_H
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_TEXTUREIMPORTER_H
+#define ANDROID_PAGEFLIP_TEXTUREIMPORTER_H
+
+#include <GLES2/gl2.h>
+
+namespace eschao {
+
+/**
+ * Interface of importing a native buffer as texture without CPU copy
+ * <p>The buffer is opaque here, for example: AHardwareBuffer on Android. An
+ * importer returns a texture id and an image handle which is kept alive with
+ * the texture and released by the same importer when texture is recycled.</p>
+ * <p>Textures only depends on this interface, so the slot logic can run with
+ * any implementation, including a stub one without GPU</p>
+ */
+class TextureImporter {
+
+public:
+    virtual ~TextureImporter() { }
+
+    /**
+     * Is importing supported in current GL context?
+     */
+    virtual bool isSupported() = 0;
+
+    /**
+     * Import buffer as GL_TEXTURE_2D texture
+     *
+     * @param buffer native buffer
+     * @param texId [out] texture id
+     * @param image [out] image handle which is bound to texture
+     * @return Error::OK if successfully
+     */
+    virtual int import(void *buffer, GLuint &texId, void *&image) = 0;
+
+    /**
+     * Release image handle, texture id is deleted by caller
+     *
+     * @param image image handle returned by import()
+     */
+    virtual void release(void *image) = 0;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_TEXTUREIMPORTER_H
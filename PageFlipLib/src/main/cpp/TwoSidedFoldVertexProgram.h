@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_TWOSIDEDFOLDVERTEXPROGRAM_H
+#define ANDROID_PAGEFLIP_TWOSIDEDFOLDVERTEXPROGRAM_H
+
+#include "BackOfFoldVertexProgram.h"
+#include "FoldShadow.h"
+
+namespace eschao {
+
+/**
+ * Program of two-sided fold strip
+ * <p>Back of fold and front of page are drawn by one triangle strip, the
+ * front facing triangles are shaded with the first texture and the back
+ * facing ones are shaded like {@link BackOfFoldVertexProgram}. Fold
+ * shadows can be cast on the front facing ones</p>
+ */
+class TwoSidedFoldVertexProgram : public BackOfFoldVertexProgram {
+
+public:
+    TwoSidedFoldVertexProgram();
+    virtual ~TwoSidedFoldVertexProgram();
+
+    virtual void clean();
+    virtual int init();
+
+    // inline
+    inline GLint frontTextureLoc() {
+        return mFrontTextureLoc;
+    }
+
+    inline FoldShadowUniforms& foldShadowUniforms() {
+        return mFoldShadowUniforms;
+    }
+
+protected:
+    virtual void getVarsLocation();
+
+protected:
+    GLint mFrontTextureLoc;
+    FoldShadowUniforms mFoldShadowUniforms;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_TWOSIDEDFOLDVERTEXPROGRAM_H
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Page.h"
+#include "BackOfFoldVertexes.h"
+#include "TwoSidedFoldVertexes.h"
+#include "RenderBackend.h"
+
+namespace eschao {
+
+/**
+ * Link back vertexes and the first part of front vertexes into one strip
+ * <p>Winding of triangle strip is alternated by vertex index, a degenerate
+ * vertex is repeated before each part if its winding is not expected</p>
+ *
+ * @param backVertexes vertexes of back of fold
+ * @param frontVertexes vertexes of front page
+ * @param frontCount vertex count of the first texture part of front page
+ */
+void TwoSidedFoldVertexes::build(BackOfFoldVertexes &backVertexes,
+                                 Vertexes &frontVertexes,
+                                 int frontCount) {
+    reset();
+
+    // back of fold must be clockwise
+    const float *back = backVertexes.vertexes();
+    const float *backTexCoords = backVertexes.texCoords();
+    const int backCount = backVertexes.count();
+    if (backCount > 0 && windingOf(back, 4, backCount) > 0) {
+        appendVertex(back, 4, backTexCoords, 0);
+    }
+
+    for (int i = 0; i < backCount; ++i) {
+        appendVertex(back, 4, backTexCoords, i);
+    }
+
+    mBackCount = count();
+    mFrontOffset = mBackCount;
+    if (frontCount <= 0) {
+        return;
+    }
+
+    // link with degenerate triangles and make front counter-clockwise
+    const float *front = frontVertexes.vertexes();
+    const float *frontTexCoords = frontVertexes.texCoords();
+    const int sizeOfFrontVex = frontVertexes.sizeOfPerVex();
+    if (mBackCount > 0) {
+        appendVertex(back, 4, backTexCoords, backCount - 1);
+        appendVertex(front, sizeOfFrontVex, frontTexCoords, 0);
+    }
+
+    const bool isCCW = windingOf(front, sizeOfFrontVex, frontCount) > 0;
+    if (isCCW != ((count() & 1) == 0)) {
+        appendVertex(front, sizeOfFrontVex, frontTexCoords, 0);
+    }
+
+    mFrontOffset = count();
+    for (int i = 0; i < frontCount; ++i) {
+        appendVertex(front, sizeOfFrontVex, frontTexCoords, i);
+    }
+}
+
+void TwoSidedFoldVertexes::draw(RenderBackend &backend,
+                                Page &page,
+                                bool hasSecondPage,
+                                GLuint gradientLightId,
+                                float maskAlpha) {
+    backend.drawTwoSidedFold(mVertexes.data(), mTexCoords.data(),
+                             mBackCount, mFrontOffset, count(),
+                             page.textures.firstTextureId(),
+                             page.textures.backTextureId(),
+                             gradientLightId,
+                             page.textures.getMaskColorOfFirstTexture(),
+                             hasSecondPage ? 0 : maskAlpha,
+                             hasSecondPage ? 1.0f : 0);
+}
+
+/**
+ * Append one vertex of given buffer, w of vertex without it is 1
+ */
+void TwoSidedFoldVertexes::appendVertex(const float *vertexes,
+                                        int sizeOfPerVex,
+                                        const float *texCoords,
+                                        int index) {
+    const float *v = vertexes + index * sizeOfPerVex;
+    const float *t = texCoords + (index << 1);
+    addVertex(v[0], v[1], v[2], sizeOfPerVex > 3 ? v[3] : 1, t[0], t[1]);
+}
+
+/**
+ * Compute winding of a triangle strip which starts at even index
+ * <p>It is the sum of signed areas of all triangles, positive means
+ * counter-clockwise. Degenerate triangles have no contribution</p>
+ */
+float TwoSidedFoldVertexes::windingOf(const float *vertexes,
+                                      int sizeOfPerVex,
+                                      int count) {
+    float sum = 0;
+    const float *a = vertexes;
+    for (int i = 0; i < count - 2; ++i, a += sizeOfPerVex) {
+        const float *b = a + sizeOfPerVex;
+        const float *c = b + sizeOfPerVex;
+        const float area = (b[0] - a[0]) * (c[1] - a[1]) -
+                           (b[1] - a[1]) * (c[0] - a[0]);
+        sum += (i & 1) ? -area : area;
+    }
+
+    return sum;
+}
+
+}
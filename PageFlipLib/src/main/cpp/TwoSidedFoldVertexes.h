@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_PAGEFLIP_TWOSIDEDFOLDVERTEXES_H
+#define ANDROID_PAGEFLIP_TWOSIDEDFOLDVERTEXES_H
+
+#include "Vertexes.h"
+
+namespace eschao {
+
+class Page;
+
+class RenderBackend;
+
+class BackOfFoldVertexes;
+
+/**
+ * Two-sided fold strip
+ * <p>Back of fold page, front of fold page and unfold page with the first
+ * texture are one continuous surface, they are linked into one triangle
+ * strip to be drawn by one draw call. The back part is wound clockwise and
+ * the front part counter-clockwise, so the shader can tell them apart by
+ * facing of triangle.</p>
+ * <p>Vertex format is same with {@link BackOfFoldVertexes}: x, y, z, w and
+ * texture coordinates, w of front vertexes is 1</p>
+ */
+class TwoSidedFoldVertexes : public Vertexes {
+
+public:
+    TwoSidedFoldVertexes() : mBackCount(0), mFrontOffset(0) { };
+    ~TwoSidedFoldVertexes() { };
+
+    void build(BackOfFoldVertexes &backVertexes,
+               Vertexes &frontVertexes,
+               int frontCount);
+    void draw(RenderBackend &backend, Page &page, bool hasSecondPage,
+              GLuint gradientLightId, float maskAlpha);
+
+    // inline
+    inline int set(VertexArena &arena, int capacity) {
+        return Vertexes::set(arena, capacity + kStitchVexCount, 4, true);
+    }
+
+    static inline size_t sizeInArena(int capacity) {
+        return Vertexes::sizeInArena(capacity + kStitchVexCount, 4, true);
+    }
+
+    inline int backCount() {
+        return mBackCount;
+    }
+
+    inline int frontOffset() {
+        return mFrontOffset;
+    }
+
+private:
+    void appendVertex(const float *vertexes, int sizeOfPerVex,
+                      const float *texCoords, int index);
+    static float windingOf(const float *vertexes, int sizeOfPerVex,
+                           int count);
+
+private:
+    // degenerate vertexes to adjust winding and link two parts
+    static const int kStitchVexCount = 4;
+
+    int mBackCount;
+    int mFrontOffset;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_TWOSIDEDFOLDVERTEXES_H
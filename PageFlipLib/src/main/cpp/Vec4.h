@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef ANDROID_PAGEFLIP_VEC4_H
+#define ANDROID_PAGEFLIP_VEC4_H
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PAGEFLIP_VEC4_NEON
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define PAGEFLIP_VEC4_SSE
+#endif
+
+namespace eschao {
+
+/**
+ * 4 lanes float vector
+ * <p>It is backed by NEON or SSE register if available, otherwise by a plain
+ * float array. Fold geometry maps 4 points at a time with it, every lane is
+ * one point and goes through the same operations as the scalar code</p>
+ */
+struct Vec4 {
+#if defined(PAGEFLIP_VEC4_NEON)
+    float32x4_t v;
+#elif defined(PAGEFLIP_VEC4_SSE)
+    __m128 v;
+#else
+    float v[4];
+#endif
+
+    inline Vec4() { }
+
+    /**
+     * Set all lanes with the same value
+     */
+    inline explicit Vec4(float s) {
+#if defined(PAGEFLIP_VEC4_NEON)
+        v = vdupq_n_f32(s);
+#elif defined(PAGEFLIP_VEC4_SSE)
+        v = _mm_set1_ps(s);
+#else
+        v[0] = v[1] = v[2] = v[3] = s;
+#endif
+    }
+
+    /**
+     * Set lanes from registers, don't compose lanes in memory and then load
+     * them, the load can't be forwarded from 4 float stores and will stall
+     */
+    inline Vec4(float a, float b, float c, float d) {
+#if defined(PAGEFLIP_VEC4_NEON)
+        v = vcombine_f32(vset_lane_f32(b, vdup_n_f32(a), 1),
+                         vset_lane_f32(d, vdup_n_f32(c), 1));
+#elif defined(PAGEFLIP_VEC4_SSE)
+        v = _mm_setr_ps(a, b, c, d);
+#else
+        v[0] = a; v[1] = b; v[2] = c; v[3] = d;
+#endif
+    }
+
+    /**
+     * Load 4 floats from unaligned address
+     */
+    static inline Vec4 load(const float *p) {
+        Vec4 r;
+#if defined(PAGEFLIP_VEC4_NEON)
+        r.v = vld1q_f32(p);
+#elif defined(PAGEFLIP_VEC4_SSE)
+        r.v = _mm_loadu_ps(p);
+#else
+        r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3];
+#endif
+        return r;
+    }
+
+    /**
+     * Store 4 floats to unaligned address
+     */
+    inline void store(float *p) const {
+#if defined(PAGEFLIP_VEC4_NEON)
+        vst1q_f32(p, v);
+#elif defined(PAGEFLIP_VEC4_SSE)
+        _mm_storeu_ps(p, v);
+#else
+        p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3];
+#endif
+    }
+
+    inline Vec4 operator+(const Vec4 &rhs) const {
+        Vec4 r;
+#if defined(PAGEFLIP_VEC4_NEON)
+        r.v = vaddq_f32(v, rhs.v);
+#elif defined(PAGEFLIP_VEC4_SSE)
+        r.v = _mm_add_ps(v, rhs.v);
+#else
+        for (int i = 0; i < 4; ++i) r.v[i] = v[i] + rhs.v[i];
+#endif
+        return r;
+    }
+
+    inline Vec4 operator-(const Vec4 &rhs) const {
+        Vec4 r;
+#if defined(PAGEFLIP_VEC4_NEON)
+        r.v = vsubq_f32(v, rhs.v);
+#elif defined(PAGEFLIP_VEC4_SSE)
+        r.v = _mm_sub_ps(v, rhs.v);
+#else
+        for (int i = 0; i < 4; ++i) r.v[i] = v[i] - rhs.v[i];
+#endif
+        return r;
+    }
+
+    inline Vec4 operator*(const Vec4 &rhs) const {
+        Vec4 r;
+#if defined(PAGEFLIP_VEC4_NEON)
+        r.v = vmulq_f32(v, rhs.v);
+#elif defined(PAGEFLIP_VEC4_SSE)
+        r.v = _mm_mul_ps(v, rhs.v);
+#else
+        for (int i = 0; i < 4; ++i) r.v[i] = v[i] * rhs.v[i];
+#endif
+        return r;
+    }
+
+    /**
+     * Divide lane by lane
+     * <p>ARMv7 NEON has no division but an estimate of reciprocal, lanes are
+     * divided one by one there to keep the same result with scalar</p>
+     */
+    inline Vec4 operator/(const Vec4 &rhs) const {
+        Vec4 r;
+#if defined(PAGEFLIP_VEC4_NEON) && defined(__aarch64__)
+        r.v = vdivq_f32(v, rhs.v);
+#elif defined(PAGEFLIP_VEC4_SSE)
+        r.v = _mm_div_ps(v, rhs.v);
+#else
+        float a[4], b[4];
+        store(a);
+        rhs.store(b);
+        for (int i = 0; i < 4; ++i) a[i] /= b[i];
+        r = load(a);
+#endif
+        return r;
+    }
+
+    /**
+     * Transpose 4 vectors as rows of 4x4 matrix, it turns 4 lanes of x, y,
+     * z and w into 4 vertexes of (x, y, z, w)
+     */
+    static inline void transpose(Vec4 &a, Vec4 &b, Vec4 &c, Vec4 &d) {
+#if defined(PAGEFLIP_VEC4_NEON)
+        const float32x4x2_t ab = vtrnq_f32(a.v, b.v);
+        const float32x4x2_t cd = vtrnq_f32(c.v, d.v);
+        a.v = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+        b.v = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+        c.v = vcombine_f32(vget_high_f32(ab.val[0]),
+                           vget_high_f32(cd.val[0]));
+        d.v = vcombine_f32(vget_high_f32(ab.val[1]),
+                           vget_high_f32(cd.val[1]));
+#elif defined(PAGEFLIP_VEC4_SSE)
+        _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+#else
+        float m[16];
+        a.store(m);
+        b.store(m + 4);
+        c.store(m + 8);
+        d.store(m + 12);
+        for (int i = 0; i < 4; ++i) {
+            a.v[i] = m[i << 2];
+            b.v[i] = m[(i << 2) + 1];
+            c.v[i] = m[(i << 2) + 2];
+            d.v[i] = m[(i << 2) + 3];
+        }
+#endif
+    }
+};
+
+}
+#endif //ANDROID_PAGEFLIP_VEC4_H
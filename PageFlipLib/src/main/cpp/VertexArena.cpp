@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include "VertexArena.h"
+#include "Error.h"
+#include "Utility.h"
+
+namespace eschao {
+
+static const auto TAG = "VertexArena";
+
+VertexArena::VertexArena()
+        : mData(NULL),
+          mCapacity(0),
+          mUsed(0) {
+}
+
+VertexArena::~VertexArena() {
+    release();
+}
+
+void VertexArena::release() {
+    if (mData) {
+        free(mData);
+        mData = NULL;
+    }
+
+    mCapacity = 0;
+    mUsed = 0;
+}
+
+/**
+ * Make sure arena can hold the given float count and reset it
+ * <p>Memory is only re-allocated when the capacity is not enough</p>
+ *
+ * @param floats float count
+ * @return Error::OK if successfully
+ */
+int VertexArena::reserve(size_t floats) {
+    floats = alignedSize(floats);
+    if (floats > mCapacity) {
+        release();
+
+        void *data = NULL;
+        if (posix_memalign(&data, kVertexArenaAlignment,
+                           floats * sizeof(float)) != 0) {
+            LOGE(TAG, "Can't allocate %zu floats for vertex arena", floats);
+            return gError.set(Error::ERROR);
+        }
+
+        mData = static_cast<float*>(data);
+        mCapacity = floats;
+    }
+
+    mUsed = 0;
+    return Error::OK;
+}
+
+/**
+ * Take a piece of memory from arena
+ *
+ * @param floats float count
+ * @return borrowed block of 64-byte aligned memory, it is null if arena is
+ *         not enough
+ */
+VertexBlock VertexArena::allocate(size_t floats) {
+    floats = alignedSize(floats);
+    if (mUsed + floats > mCapacity) {
+        LOGE(TAG, "Vertex arena overflow, capacity: %zu, used: %zu, "
+                  "required: %zu", mCapacity, mUsed, floats);
+        return VertexBlock();
+    }
+
+    float *p = mData + mUsed;
+    mUsed += floats;
+    return VertexBlock(p, false);
+}
+
+VertexBlock::VertexBlock()
+        : mData(NULL),
+          mIsHeap(false) {
+}
+
+VertexBlock::VertexBlock(float *data, bool isHeap)
+        : mData(data),
+          mIsHeap(isHeap) {
+}
+
+VertexBlock::VertexBlock(VertexBlock &&other)
+        : mData(other.mData),
+          mIsHeap(other.mIsHeap) {
+    other.mData = NULL;
+    other.mIsHeap = false;
+}
+
+VertexBlock::~VertexBlock() {
+    release();
+}
+
+VertexBlock& VertexBlock::operator=(VertexBlock &&other) {
+    if (this != &other) {
+        release();
+        mData = other.mData;
+        mIsHeap = other.mIsHeap;
+        other.mData = NULL;
+        other.mIsHeap = false;
+    }
+
+    return *this;
+}
+
+/**
+ * Allocate buffer from heap, the current buffer is released first
+ *
+ * @param floats float count
+ */
+void VertexBlock::allocate(size_t floats) {
+    release();
+    mData = new float[floats];
+    mIsHeap = true;
+}
+
+void VertexBlock::release() {
+    if (mIsHeap) {
+        delete[] mData;
+    }
+
+    mData = NULL;
+    mIsHeap = false;
+}
+
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_VERTEXARENA_H
+#define ANDROID_PAGEFLIP_VERTEXARENA_H
+
+#include <stddef.h>
+
+namespace eschao {
+
+// alignment of arena and every buffer allocated from it, in bytes
+static const size_t kVertexArenaAlignment = 64;
+static const size_t kVertexArenaAlignFloats = kVertexArenaAlignment /
+                                              sizeof(float);
+
+/**
+ * Scoped handle of a vertex buffer
+ * <p>The buffer is either a piece borrowed from {@link VertexArena} or a heap
+ * block allocated by handle itself. Only the heap block is freed when handle
+ * is released or destroyed, the borrowed piece is given back with arena. A
+ * handle can't be copied, it can be moved to pass the buffer on</p>
+ */
+class VertexBlock {
+
+public:
+    VertexBlock();
+    VertexBlock(VertexBlock &&other);
+    ~VertexBlock();
+
+    VertexBlock& operator=(VertexBlock &&other);
+    void allocate(size_t floats);
+    void release();
+
+    // inline
+    inline float* data() const {
+        return mData;
+    }
+
+    inline float& operator[](int index) const {
+        return mData[index];
+    }
+
+    inline bool isNull() const {
+        return mData == NULL;
+    }
+
+    /**
+     * Is buffer borrowed from arena, it can't be re-allocated by handle
+     */
+    inline bool isBorrowed() const {
+        return mData != NULL && !mIsHeap;
+    }
+
+private:
+    friend class VertexArena;
+    VertexBlock(float *data, bool isHeap);
+
+    VertexBlock(const VertexBlock&);
+    VertexBlock& operator=(const VertexBlock&);
+
+private:
+    float *mData;
+    bool mIsHeap;
+};
+
+/**
+ * One contiguous memory block which holds all vertex buffers
+ * <p>The arena is reserved with the total size of buffers when surface is
+ * changed, then every buffer takes its piece from the arena with a bump
+ * pointer. Nothing is allocated from heap on drawing path, and memory is only
+ * re-allocated when a larger size is required, the old block is freed at the
+ * same time.</p>
+ * <p>Buffers allocated from arena are borrowed {@link VertexBlock}, they don't
+ * own memory and become invalid after {@link #reserve(size_t)} or
+ * {@link #reset()}</p>
+ */
+class VertexArena {
+
+public:
+    VertexArena();
+    ~VertexArena();
+
+    int reserve(size_t floats);
+    void release();
+    VertexBlock allocate(size_t floats);
+
+    // inline
+    inline void reset() {
+        mUsed = 0;
+    }
+
+    inline size_t capacity() {
+        return mCapacity;
+    }
+
+    inline size_t used() {
+        return mUsed;
+    }
+
+    /**
+     * Float count which a buffer really takes in arena
+     */
+    static inline size_t alignedSize(size_t floats) {
+        return (floats + kVertexArenaAlignFloats - 1) &
+               ~(kVertexArenaAlignFloats - 1);
+    }
+
+private:
+    // arena is the only owner of its memory
+    VertexArena(const VertexArena&);
+    VertexArena& operator=(const VertexArena&);
+
+private:
+    float *mData;
+    size_t mCapacity;
+    size_t mUsed;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_VERTEXARENA_H
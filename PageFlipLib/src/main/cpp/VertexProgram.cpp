@@ -15,13 +15,14 @@
  */
 
 #include "VertexProgram.h"
-#include "constant.h"
-#include "Matrix.h"
+#include "Constant.h"
 
 namespace eschao {
 
+// page is flat, fold shadows can be cast on it, see FoldShadow.h
 static const auto g_vertex_shader =
         "precision mediump float;\n"
+        FOLD_SHADOW_VERTEX_GLSL
         "uniform mat4 u_MVPMatrix;\n"
         "attribute vec4 a_vexPosition;\n"
         "attribute vec2 a_texCoord;\n"
@@ -30,28 +31,26 @@ static const auto g_vertex_shader =
         "void main() {\n"
         "    gl_Position = u_MVPMatrix * a_vexPosition;\n"
         "    v_texCoord = a_texCoord;\n"
+        "    computeFoldShadow(toFoldAxis(a_vexPosition.xy));\n"
         "}";
 
 static const auto g_fragment_shader =
         "precision mediump float;\n"
+        FOLD_SHADOW_FRAGMENT_GLSL
         "uniform sampler2D u_texture;\n"
         "varying vec2 v_texCoord;\n"
         "\n"
         "void main() {\n"
-        "    gl_FragColor = texture2D(u_texture, v_texCoord);\n"
+        "    vec4 color = texture2D(u_texture, v_texCoord);\n"
+        "    gl_FragColor = vec4(castFoldShadows(color.rgb), color.a);\n"
         "}";
 
-static const char* VAR_MVP_MATRIX       = "u_MVPMatrix";
 static const char* VAR_VERTEX_POS       = "a_vexPosition";
 static const char* VAR_TEXTURE_COORD    = "a_texCoord";
 static const char* VAR_TEXTURE          = "u_texture";
 
-float VertexProgram::MVMatrix[16]   = {0};
-float VertexProgram::MVPMatrix[16]  = {0};
-
 VertexProgram::VertexProgram()
-        : mMVPMatrixLoc(Constant::kGlInValidLocation),
-          mVertexPosLoc(Constant::kGlInValidLocation),
+        : mVertexPosLoc(Constant::kGlInValidLocation),
           mTexCoordLoc(Constant::kGlInValidLocation),
           mTextureLoc(Constant::kGlInValidLocation) {
 }
@@ -62,9 +61,9 @@ VertexProgram::~VertexProgram() {
 
 void VertexProgram::clean() {
     mTextureLoc = Constant::kGlInValidLocation;
-    mMVPMatrixLoc = Constant::kGlInValidLocation;
     mTexCoordLoc = Constant::kGlInValidLocation;
     mVertexPosLoc = Constant::kGlInValidLocation;
+    mFoldShadowUniforms.clean();
 
     GLProgram::clean();
 }
@@ -74,21 +73,11 @@ int VertexProgram::init() {
     return GLProgram::init(g_vertex_shader, g_fragment_shader);
 }
 
-void VertexProgram::initMatrix(float left, float right,
-                               float bottom, float top) {
-    float projectMatrix[16];
-    Matrix::ortho(projectMatrix, left, right, bottom, top, 0, 6000);
-    Matrix::setIdentity(MVMatrix);
-    Matrix::setLookAt(MVMatrix, 0, 0, 3000, 0, 0, 0, 0, 1, 0);
-    Matrix::setIdentity(MVPMatrix);
-    Matrix::multiplyMM(MVPMatrix, projectMatrix, MVMatrix);
-}
-
 void VertexProgram::getVarsLocation() {
     mTextureLoc = glGetUniformLocation(mProgramRef, VAR_TEXTURE);
-    mMVPMatrixLoc = glGetUniformLocation(mProgramRef, VAR_MVP_MATRIX);
     mTexCoordLoc = glGetAttribLocation(mProgramRef, VAR_TEXTURE_COORD);
     mVertexPosLoc = glGetAttribLocation(mProgramRef, VAR_VERTEX_POS);
+    mFoldShadowUniforms.getLocations(mProgramRef);
 }
 
 }
@@ -18,6 +18,7 @@
 #define ANDROID_PAGEFLIP_VERTEXPROGRAM_H
 
 #include "GLProgram.h"
+#include "FoldShadow.h"
 
 namespace eschao {
 
@@ -29,13 +30,8 @@ public:
 
     virtual void clean();
     virtual int init();
-    void initMatrix(float left, float right, float bottom, float top);
 
     // inline
-    inline GLint mvpMatrixLoc() {
-        return mMVPMatrixLoc;
-    }
-
     inline GLint vertexPosLoc() {
         return mVertexPosLoc;
     }
@@ -48,18 +44,18 @@ public:
         return mTextureLoc;
     }
 
+    inline FoldShadowUniforms& foldShadowUniforms() {
+        return mFoldShadowUniforms;
+    }
+
 protected:
     virtual void getVarsLocation();
 
-public:
-    static float MVMatrix[16];
-    static float MVPMatrix[16];
-
 protected:
-    GLint mMVPMatrixLoc;
     GLint mVertexPosLoc;
     GLint mTexCoordLoc;
     GLint mTextureLoc;
+    FoldShadowUniforms mFoldShadowUniforms;
 };
 
 }
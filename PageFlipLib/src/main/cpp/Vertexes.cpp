@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <string.h>
 #include "Vertexes.h"
 #include "Error.h"
 #include "Utility.h"
@@ -21,14 +22,15 @@
 namespace eschao {
 
 Vertexes::Vertexes()
-        : mNext(0),
+        : mSizeOfPerVex(0),
           mCapacity(0),
-          mSizeOfPerVex(0),
-          mVertexes(NULL),
-          mTexCoords(NULL) {
+          mNext(0) {
 }
 
-Vertexes::Vertexes(int capacity, int sizeOfPerVex, bool hasTexture) {
+Vertexes::Vertexes(int capacity, int sizeOfPerVex, bool hasTexture)
+        : mSizeOfPerVex(0),
+          mCapacity(0),
+          mNext(0) {
     set(capacity, sizeOfPerVex, hasTexture);
 }
 
@@ -37,14 +39,8 @@ Vertexes::~Vertexes() {
 }
 
 void Vertexes::release() {
-    if (mVertexes) {
-        delete[] mVertexes;
-    }
-
-    if (mTexCoords) {
-        delete[] mTexCoords;
-    }
-
+    mVertexes.release();
+    mTexCoords.release();
     mNext = 0;
     mCapacity = 0;
     mSizeOfPerVex = 0;
@@ -58,15 +54,41 @@ int Vertexes::set(int capacity, int sizeOfPerVex, bool hasTexture) {
     release();
     this->mCapacity = capacity;
     this->mSizeOfPerVex = sizeOfPerVex;
-    mVertexes = new float[capacity * sizeOfPerVex];
+    mVertexes.allocate(capacity * sizeOfPerVex);
 
     if (hasTexture) {
-        mTexCoords = new float[capacity << 1];
+        mTexCoords.allocate(capacity << 1);
     }
 
     return Error::OK;
 }
 
+/**
+ * Set buffer with memory from arena, nothing is allocated from heap
+ */
+int Vertexes::set(VertexArena &arena, int capacity, int sizeOfPerVex,
+                  bool hasTexture) {
+    if (sizeOfPerVex < 2) {
+        return gError.set(Error::ERR_INVALID_PARAMETER);
+    }
+
+    release();
+    mVertexes = arena.allocate(capacity * sizeOfPerVex);
+    if (hasTexture) {
+        mTexCoords = arena.allocate(capacity << 1);
+    }
+
+    if (mVertexes.isNull() || (hasTexture && mTexCoords.isNull())) {
+        mVertexes.release();
+        mTexCoords.release();
+        return gError.set(Error::ERROR);
+    }
+
+    this->mCapacity = capacity;
+    this->mSizeOfPerVex = sizeOfPerVex;
+    return Error::OK;
+}
+
 Vertexes& Vertexes::addVertex(float x, float y, float z) {
     mVertexes[mNext++] = x;
     mVertexes[mNext++] = y;
@@ -118,30 +140,90 @@ Vertexes& Vertexes::addVertex(GLPoint &p) {
     return *this;
 }
 
-void Vertexes::drawWith(GLenum type, GLint vertexPosLoc,
-                        GLint texCoordLoc) {
-    glVertexAttribPointer(vertexPosLoc, mSizeOfPerVex, GL_FLOAT,
-                          GL_FALSE, 0, mVertexes);
-    glEnableVertexAttribArray(vertexPosLoc);
+/**
+ * Set vertex at given index, the index must be added or expanded before
+ */
+Vertexes& Vertexes::setVertex(int index, float x, float y, float z,
+                              float tx, float ty) {
+    int i = index * mSizeOfPerVex;
+    int j = index << 1;
+    mVertexes[i++] = x;
+    mVertexes[i++] = y;
+    mVertexes[i] = z;
 
-    glVertexAttribPointer(texCoordLoc, 2, GL_FLOAT, GL_FALSE,
-                          0, mTexCoords);
-    glEnableVertexAttribArray(texCoordLoc);
+    mTexCoords[j++] = tx;
+    mTexCoords[j] = ty;
+    return *this;
+}
+
+Vertexes& Vertexes::setVertex(int index, float x, float y, float z, float w,
+                              float tx, float ty) {
+    int i = index * mSizeOfPerVex;
+    int j = index << 1;
+    mVertexes[i++] = x;
+    mVertexes[i++] = y;
+    mVertexes[i++] = z;
+    mVertexes[i] = w;
+
+    mTexCoords[j++] = tx;
+    mTexCoords[j] = ty;
+    return *this;
+}
+
+/**
+ * Set count vertexes from given index without texture coordinates, the
+ * vertexes must be added or expanded before
+ * <p>Every source vertex has 4 floats, the first mSizeOfPerVex floats of it
+ * are taken, so the mapped vertexes of fold cylinder can be set into both
+ * back and front buffers</p>
+ */
+Vertexes& Vertexes::setVertexes(int index, int count, const float *vertexes) {
+    float *dst = mVertexes.data() + index * mSizeOfPerVex;
+    if (mSizeOfPerVex == 4) {
+        memcpy(dst, vertexes, (count << 2) * sizeof(float));
+    }
+    else {
+        for (int i = 0; i < count; ++i, vertexes += 4) {
+            for (int j = 0; j < mSizeOfPerVex; ++j) {
+                *dst++ = vertexes[j];
+            }
+        }
+    }
 
-    glDrawArrays(type, 0, count());
+    return *this;
 }
 
-void Vertexes::drawWith(GLenum type, GLint vertexPosLoc, GLint texCoordLoc,
-                        int offset, int length) {
-    glVertexAttribPointer(vertexPosLoc, mSizeOfPerVex, GL_FLOAT,
-                          GL_FALSE, 0, mVertexes);
-    glEnableVertexAttribArray(vertexPosLoc);
+/**
+ * Copy vertexes and texture coordinates of src
+ * <p>Buffer is allocated with the size of src if it is not enough, but the
+ * buffer borrowed from arena can't be reallocated</p>
+ *
+ * @return Error::OK if successfully
+ */
+int Vertexes::copy(const Vertexes &src) {
+    const int count = src.mNext / src.mSizeOfPerVex;
+    const bool hasTexture = !src.mTexCoords.isNull();
+    if (mCapacity < count || mSizeOfPerVex != src.mSizeOfPerVex ||
+        (hasTexture && mTexCoords.isNull())) {
+        if (mVertexes.isBorrowed()) {
+            return gError.set(Error::ERR_INVALID_PARAMETER);
+        }
+
+        const int ret = set(count, src.mSizeOfPerVex, hasTexture);
+        if (ret != Error::OK) {
+            return ret;
+        }
+    }
 
-    glVertexAttribPointer(texCoordLoc, 2, GL_FLOAT, GL_FALSE,
-                          0, mTexCoords);
-    glEnableVertexAttribArray(texCoordLoc);
+    memcpy(mVertexes.data(), src.mVertexes.data(),
+           src.mNext * sizeof(float));
+    if (hasTexture) {
+        memcpy(mTexCoords.data(), src.mTexCoords.data(),
+               (count << 1) * sizeof(float));
+    }
 
-    glDrawArrays(type, offset, length);
+    mNext = src.mNext;
+    return Error::OK;
 }
 
 void Vertexes::printVertexes() {
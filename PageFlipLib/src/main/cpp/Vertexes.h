@@ -19,6 +19,7 @@
 
 #include <GLES2/gl2.h>
 #include "GLPoint.h"
+#include "VertexArena.h"
 
 namespace eschao {
 
@@ -31,14 +32,19 @@ public:
 
     void release();
     int set(int capacity, int sizeOfPerVex, bool hasTexture = false);
+    int set(VertexArena &arena, int capacity, int sizeOfPerVex,
+            bool hasTexture = false);
     Vertexes& addVertex(float x, float y, float z);
     Vertexes& addVertex(float x, float y, float z, float w);
     Vertexes& addVertex(float x, float y, float z, float tx, float ty);
     Vertexes& addVertex(float x, float y, float z, float w, float tx, float ty);
     Vertexes& addVertex(GLPoint &p);
-    void drawWith(GLenum type, GLint vertexPosLoc, GLint texCoordLoc);
-    void drawWith(GLenum type, GLint vertexPosLoc, GLint texCoordLoc,
-                  int offset, int length);
+    Vertexes& setVertex(int index, float x, float y, float z,
+                        float tx, float ty);
+    Vertexes& setVertex(int index, float x, float y, float z, float w,
+                        float tx, float ty);
+    Vertexes& setVertexes(int index, int count, const float *vertexes);
+    int copy(const Vertexes &src);
     void printVertexes();
 
     // inline
@@ -58,6 +64,40 @@ public:
         mNext = 0;
     }
 
+    /**
+     * Expand buffer with count vertexes which will be set by index
+     *
+     * @return index of the first expanded vertex
+     */
+    inline int expand(int count) {
+        const int first = mNext / mSizeOfPerVex;
+        mNext += count * mSizeOfPerVex;
+        return first;
+    }
+
+    static inline size_t sizeInArena(int capacity, int sizeOfPerVex,
+                                     bool hasTexture = false) {
+        return VertexArena::alignedSize(capacity * sizeOfPerVex) +
+               (hasTexture ? VertexArena::alignedSize(capacity << 1) : 0);
+    }
+
+    inline const float* vertexes() {
+        return mVertexes.data();
+    }
+
+    inline const float* texCoords() {
+        return mTexCoords.data();
+    }
+
+    /**
+     * Set texture coordinate of vertex at given index, the index must be
+     * added or expanded before
+     */
+    inline void setTexCoord(int index, float tx, float ty) {
+        mTexCoords[index << 1] = tx;
+        mTexCoords[(index << 1) + 1] = ty;
+    }
+
     inline float floatAt(int index) {
         return (index >= 0 && index < mNext) ? mVertexes[index] : 0;
     }
@@ -67,8 +107,9 @@ protected:
     int mCapacity;
     int mNext;
 
-    float* mVertexes;
-    float* mTexCoords;
+    // buffers allocated by itself or borrowed from arena
+    VertexBlock mVertexes;
+    VertexBlock mTexCoords;
 };
 
 }
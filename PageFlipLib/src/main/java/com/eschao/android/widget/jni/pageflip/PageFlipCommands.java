@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.eschao.android.widget.jni.pageflip;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Batch of PageFlip commands executed by one JNI call
+ * <p>Commands of a frame are written into a direct ByteBuffer and executed
+ * by {@link #execute()}, then flip state, state flags and results of
+ * commands can be read without crossing JNI again. Layout of buffer must be
+ * same with native CommandBuffer.h</p>
+ * <pre>
+ *     mCommands.reset();
+ *     mCommands.recycleTextures();
+ *     mCommands.setTextureOfPage(SECOND_TEXTURE, true, pageNo + 1, true);
+ *     mCommands.drawFlipFrame();
+ *     mCommands.execute();
+ *     if (mCommands.isAnimating()) { ... }
+ * </pre>
+ *
+ * @author eschao
+ */
+public class PageFlipCommands {
+
+    // commands
+    private final static int CMD_FINGER_DOWN                     = 1;
+    private final static int CMD_FINGER_MOVE                     = 2;
+    private final static int CMD_FINGER_UP                       = 3;
+    private final static int CMD_CAN_ANIMATE                     = 4;
+    private final static int CMD_ANIMATING                       = 5;
+    private final static int CMD_ABORT_ANIMATING                 = 6;
+    private final static int CMD_RECYCLE_TEXTURES                = 7;
+    private final static int CMD_SET_FIRST_TEXTURE_WITH_SECOND   = 8;
+    private final static int CMD_SET_SECOND_TEXTURE_WITH_FIRST   = 9;
+    private final static int CMD_SWAP_SECOND_TEXTURES_WITH_FIRST = 10;
+    private final static int CMD_SET_TEXTURE_OF_PAGE             = 11;
+    private final static int CMD_DRAW_FLIP_FRAME                 = 12;
+    private final static int CMD_DRAW_PAGE_FRAME                 = 13;
+
+    // state flags
+    private final static int STATE_ANIMATING                  = 0x0001;
+    private final static int STATE_HAS_FIRST_PAGE             = 0x0002;
+    private final static int STATE_HAS_SECOND_PAGE            = 0x0004;
+    private final static int STATE_FIRST_PAGE_FIRST_TEXTURE   = 0x0008;
+    private final static int STATE_SECOND_PAGE_FIRST_TEXTURE  = 0x0040;
+
+    // texture slots of page
+    public final static int FIRST_TEXTURE   = 0;
+    public final static int SECOND_TEXTURE  = 1;
+    public final static int BACK_TEXTURE    = 2;
+
+    // header: word count, flip state, state flags, error
+    private final static int HEADER_SIZE    = 4;
+    private final static int DEFAULT_SIZE   = 64;
+
+    private ByteBuffer mBuffer;
+    private int mWordCount;
+
+    public PageFlipCommands() {
+        this(DEFAULT_SIZE);
+    }
+
+    /**
+     * Constructor
+     *
+     * @param capacity max words of commands
+     */
+    public PageFlipCommands(int capacity) {
+        mBuffer = ByteBuffer.allocateDirect((HEADER_SIZE + capacity) * 4)
+                            .order(ByteOrder.nativeOrder());
+        reset();
+    }
+
+    /**
+     * Clear all commands
+     */
+    public void reset() {
+        mWordCount = 0;
+        mBuffer.putInt(0, 0);
+    }
+
+    /**
+     * Execute all commands in one JNI call
+     *
+     * @return {@link PageFlipLib#OK} if all commands are executed
+     *         successfully, otherwise the first error
+     */
+    public int execute() {
+        mBuffer.putInt(0, mWordCount);
+        return PageFlipLib.executeCommands(mBuffer);
+    }
+
+    /**
+     * Commands, every one returns a handle for reading its result after
+     * executing
+     */
+    public int onFingerDown(float x, float y) {
+        final int handle = add(CMD_FINGER_DOWN, 2);
+        putFloat(handle + 2, x);
+        putFloat(handle + 3, y);
+        return handle;
+    }
+
+    public int onFingerMove(float x, float y,
+                            boolean canForward, boolean canBackward) {
+        final int handle = add(CMD_FINGER_MOVE, 4);
+        putFloat(handle + 2, x);
+        putFloat(handle + 3, y);
+        putInt(handle + 4, canForward ? 1 : 0);
+        putInt(handle + 5, canBackward ? 1 : 0);
+        return handle;
+    }
+
+    public int onFingerUp(float x, float y, int duration,
+                          boolean canForward, boolean canBackward) {
+        final int handle = add(CMD_FINGER_UP, 5);
+        putFloat(handle + 2, x);
+        putFloat(handle + 3, y);
+        putInt(handle + 4, duration);
+        putInt(handle + 5, canForward ? 1 : 0);
+        putInt(handle + 6, canBackward ? 1 : 0);
+        return handle;
+    }
+
+    public int canAnimate(float x, float y) {
+        final int handle = add(CMD_CAN_ANIMATE, 2);
+        putFloat(handle + 2, x);
+        putFloat(handle + 3, y);
+        return handle;
+    }
+
+    public int animating() {
+        return add(CMD_ANIMATING, 0);
+    }
+
+    public int abortAnimating() {
+        return add(CMD_ABORT_ANIMATING, 0);
+    }
+
+    public int recycleTextures() {
+        return add(CMD_RECYCLE_TEXTURES, 0);
+    }
+
+    public int setFirstTextureWithSecond() {
+        return add(CMD_SET_FIRST_TEXTURE_WITH_SECOND, 0);
+    }
+
+    public int setSecondTextureWithFirst() {
+        return add(CMD_SET_SECOND_TEXTURE_WITH_FIRST, 0);
+    }
+
+    public int swapSecondTexturesWithFirst() {
+        return add(CMD_SWAP_SECOND_TEXTURES_WITH_FIRST, 0);
+    }
+
+    /**
+     * Set texture with page decoded by prefetcher
+     *
+     * @param texture texture slot: {@link #FIRST_TEXTURE},
+     *                {@link #SECOND_TEXTURE} or {@link #BACK_TEXTURE}
+     * @param isFirstPage is the first page
+     * @param pageIndex page index given to
+     *                  {@link PageFlipLib#setPageSource(int, byte[])}
+     * @param ifUnset only set texture if it isn't set
+     * @return handle of command
+     */
+    public int setTextureOfPage(int texture, boolean isFirstPage,
+                                int pageIndex, boolean ifUnset) {
+        final int handle = add(CMD_SET_TEXTURE_OF_PAGE, 4);
+        putInt(handle + 2, texture);
+        putInt(handle + 3, isFirstPage ? 1 : 0);
+        putInt(handle + 4, pageIndex);
+        putInt(handle + 5, ifUnset ? 1 : 0);
+        return handle;
+    }
+
+    public int drawFlipFrame() {
+        return add(CMD_DRAW_FLIP_FRAME, 0);
+    }
+
+    public int drawPageFrame() {
+        return add(CMD_DRAW_PAGE_FRAME, 0);
+    }
+
+    /**
+     * Results after executing
+     */
+    public int getResult(int handle) {
+        return mBuffer.getInt((handle + 1) * 4);
+    }
+
+    public boolean getBooleanResult(int handle) {
+        return getResult(handle) != 0;
+    }
+
+    public int getError() {
+        return mBuffer.getInt(12);
+    }
+
+    public int getFlipState() {
+        return mBuffer.getInt(4);
+    }
+
+    public boolean isAnimating() {
+        return (getStateFlags() & STATE_ANIMATING) != 0;
+    }
+
+    public boolean hasFirstPage() {
+        return (getStateFlags() & STATE_HAS_FIRST_PAGE) != 0;
+    }
+
+    public boolean hasSecondPage() {
+        return (getStateFlags() & STATE_HAS_SECOND_PAGE) != 0;
+    }
+
+    public boolean isFirstTextureSet(boolean isFirstPage) {
+        return isTextureSet(isFirstPage, FIRST_TEXTURE);
+    }
+
+    public boolean isSecondTextureSet(boolean isFirstPage) {
+        return isTextureSet(isFirstPage, SECOND_TEXTURE);
+    }
+
+    public boolean isBackTextureSet(boolean isFirstPage) {
+        return isTextureSet(isFirstPage, BACK_TEXTURE);
+    }
+
+    private boolean isTextureSet(boolean isFirstPage, int texture) {
+        final int flag = (isFirstPage ? STATE_FIRST_PAGE_FIRST_TEXTURE
+                                      : STATE_SECOND_PAGE_FIRST_TEXTURE)
+                         << texture;
+        return (getStateFlags() & flag) != 0;
+    }
+
+    private int getStateFlags() {
+        return mBuffer.getInt(8);
+    }
+
+    private int add(int command, int argCount) {
+        final int handle = HEADER_SIZE + mWordCount;
+        if ((handle + 2 + argCount) * 4 > mBuffer.capacity()) {
+            throw new IllegalStateException("Command buffer is full");
+        }
+
+        putInt(handle, command);
+        putInt(handle + 1, 0);
+        mWordCount += 2 + argCount;
+        return handle;
+    }
+
+    private void putInt(int word, int value) {
+        mBuffer.putInt(word * 4, value);
+    }
+
+    private void putFloat(int word, float value) {
+        mBuffer.putFloat(word * 4, value);
+    }
+}
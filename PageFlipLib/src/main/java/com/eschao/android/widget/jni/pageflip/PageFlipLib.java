@@ -6,6 +6,10 @@ import android.graphics.LinearGradient;
 import android.graphics.Paint;
 import android.graphics.Shader;
 
+import java.nio.ByteBuffer;
+
+import dalvik.annotation.optimization.CriticalNative;
+
 public class PageFlipLib {
 
     public static int BEGIN_FLIP        = 0;
@@ -17,6 +21,14 @@ public class PageFlipLib {
     public static int END_WITH_BACKWARD = 6;
     public static int END_WITH_RESTORE  = 7;
 
+    // mesh density mode
+    public static final int FIXED_MESH_DENSITY      = 0;
+    public static final int ADAPTIVE_MESH_DENSITY   = 1;
+
+    // render backend, it should be set before onSurfaceCreated()
+    public static final int GLES2_RENDER_BACKEND    = 0;
+    public static final int GLES3_RENDER_BACKEND    = 1;
+
     static {
         System.loadLibrary("pageflip");
     }
@@ -48,6 +60,22 @@ public class PageFlipLib {
     public static native boolean isAutoPageEnabled();
     public static native int enableClickToFlip(boolean enable);
     public static native int setWidthRatioOfClickToFlip(float ratio);
+    public static native int enableSinglePass(boolean enable);
+    public static native boolean isSinglePassEnabled();
+    public static native int enableGPUDeform(boolean enable);
+    public static native boolean isGPUDeformEnabled();
+    public static native int enableAnalyticShadow(boolean enable);
+    public static native boolean isAnalyticShadowEnabled();
+    public static native int enableFoldClip(boolean enable);
+    public static native boolean isFoldClipEnabled();
+    public static native int enablePipelinedGeometry(boolean enable);
+    public static native boolean isPipelinedGeometryEnabled();
+    public static native int setGeometryThreads(int count);
+    public static native int getGeometryThreads();
+    public static native int setAnimationKeyframes(int count);
+    public static native int getAnimationKeyframes();
+    public static native int enableDepthFree(boolean enable);
+    public static native boolean isDepthFreeEnabled();
     public static native int setPixelsOfMesh(int pixelsOfMesh);
     public static native int setSemiPerimeterRatio(float ratio);
     public static native int setMaskAlphaOfFold(int alpha);
@@ -66,6 +94,43 @@ public class PageFlipLib {
                                                       float max,
                                                       float ratio);
     public static native int getPixelsOfMesh();
+    public static native int setMeshDensityMode(int mode);
+    public static native int getMeshDensityMode();
+    public static native int setRenderBackend(int backend);
+    public static native int getRenderBackend();
+
+    /**
+     * Show thickness of remaining pages on the outer edges of book
+     * <p>The outer edges of pages are inset by maxLayers * layerWidth, the
+     * visible layers of each side are proportional to book progress</p>
+     *
+     * @param maxLayers max layers on one side, [0 .. 32], 0 means disabling
+     * @param layerWidth width of one layer in pixels
+     * @return {@link #OK} if successfully
+     */
+    public static native int setPageStack(int maxLayers, float layerWidth);
+    public static native int setBookProgress(float progress);
+
+    /**
+     * Flip several pages forward with one gesture in single page mode
+     * <p>Pages fan over with staggered phases, the second texture should be
+     * the page after the last flipped one. When flip is ended with
+     * {@link #END_WITH_FORWARD}, call {@link #getBurstingPages()} to know
+     * how many pages are flipped</p>
+     *
+     * @param pages page count, [1 .. 8], 1 means normal flip
+     * @param stagger phase delay between two pages, e.g. 0.1,
+     *                (pages - 1) * stagger must be less than 1
+     * @return {@link #OK} if successfully
+     */
+    public static native int setBurstFlip(int pages, float stagger);
+    public static native int getBurstingPages();
+    public static native int setMeshTolerance(float pixels);
+    public static native float getMeshTolerance();
+    public static native int setFrameBudget(float ms);
+    public static native float getFrameTime();
+    public static native int getMeshCount();
+    public static native float getBlendCoverage();
     public static native int getSurfaceWidth();
     public static native int getSurfaceHeight();
     public static native int onSurfaceCreated();
@@ -73,21 +138,89 @@ public class PageFlipLib {
 
     public static native boolean animating();
     public static native boolean canAnimate(float x, float y);
+    @CriticalNative
     public static native boolean isAnimating();
     public static native int abortAnimating();
 
     public static native int drawFlipFrame();
     public static native int drawPageFrame();
 
+    @CriticalNative
     public static native boolean hasFirstPage();
+    @CriticalNative
     public static native boolean hasSecondPage();
+    @CriticalNative
     public static native boolean isFirstTextureSet(boolean isFirstPage);
+    @CriticalNative
     public static native boolean isSecondTextureSet(boolean isFirstPage);
+    @CriticalNative
     public static native boolean isBackTextureSet(boolean isFirstPage);
     public static native int setFirstTexture(boolean isFirstPage, Bitmap b);
     public static native int setSecondTexture(boolean isFirstPage, Bitmap b);
     public static native int setBackTexture(boolean isFirstPage, Bitmap b);
     public static native int setGradientLightTexture(Bitmap b);
+
+    /**
+     * Set page textures with android.hardware.HardwareBuffer (Android 8.0+)
+     * <p>The buffer is bound to texture through EGLImage without copying
+     * pixels, it is declared as Object to keep compatible with old SDK.
+     * Since pixels can't be read by CPU, the mask color of back of fold
+     * page needs to be given, for example: the average color of page</p>
+     *
+     * @param isFirstPage is the first page
+     * @param hardwareBuffer HardwareBuffer object, null to recycle back texture
+     * @param maskColor mask color in {@link android.graphics.Color} format
+     * @return {@link #OK} if successfully
+     */
+    public static native boolean isHardwareTextureSupported();
+    public static native int setFirstTexture(boolean isFirstPage,
+                                             Object hardwareBuffer,
+                                             int maskColor);
+    public static native int setSecondTexture(boolean isFirstPage,
+                                              Object hardwareBuffer,
+                                              int maskColor);
+    public static native int setBackTexture(boolean isFirstPage,
+                                            Object hardwareBuffer,
+                                            int maskColor);
+
+    /**
+     * Decode pages in native worker threads before they are shown
+     * <p>Compressed image data(PNG, JPEG, WebP ...) of pages is given by
+     * {@link #setPageSource(int, byte[])}, when current page is changed, call
+     * {@link #prefetchPages(int, boolean)} to decode the next and previous
+     * pages in background, then set textures by page index in GL thread.
+     * Native decoder requires Android 11, check it with
+     * {@link #isPrefetchSupported()} and decode bitmaps in Java on old
+     * devices</p>
+     */
+    public static native boolean isPrefetchSupported();
+    public static native int startPrefetcher(int threadCount,
+                                             int pageCount,
+                                             long memoryBudget);
+    public static native int stopPrefetcher();
+    public static native int setPrefetchPageSize(int width, int height);
+    public static native int setPageSource(int pageIndex, byte[] data);
+    public static native int removePageSource(int pageIndex);
+    public static native int clearPageSources();
+    public static native int prefetchPages(int pageIndex, boolean isForward);
+    public static native int setFirstTextureOfPage(boolean isFirstPage,
+                                                   int pageIndex);
+    public static native int setSecondTextureOfPage(boolean isFirstPage,
+                                                    int pageIndex);
+    public static native int setBackTextureOfPage(boolean isFirstPage,
+                                                  int pageIndex);
+    public static native float getPrefetchHitRate();
+    public static native float getPrefetchDecodeTime();
+    public static native long getPrefetchMemory();
+
+    /**
+     * Execute commands written in direct buffer by {@link PageFlipCommands}
+     * with one JNI call
+     *
+     * @param buffer direct buffer in native byte order
+     * @return {@link #OK} if all commands are executed successfully
+     */
+    public static native int executeCommands(ByteBuffer buffer);
     public static native int setFirstTextureWithSecond();
     public static native int setSecondTextureWithFirst();
     public static native int swapSecondTexturesWithFirst();
@@ -99,6 +232,7 @@ public class PageFlipLib {
     public static native boolean isLeftPage(boolean isFirstPage);
     public static native boolean isRightPage(boolean isFirstPage);
 
+    @CriticalNative
     public static native int getFlipState();
     private static native boolean onFingerMove(float x, float y,
                                                boolean canForward,
@@ -149,6 +283,22 @@ public class PageFlipLib {
     public static final int ERR_GET_BITMAP_DATA            = OK - 14;
     public static final int ERR_NO_TWO_PAGES               = OK - 15;
     public static final int ERR_NULL_PAGE                  = OK - 16;
+    public static final int ERR_UNSUPPORT_HARDWARE_BUFFER  = OK - 17;
+    public static final int ERR_IMPORT_HARDWARE_BUFFER     = OK - 18;
+    public static final int ERR_UNSUPPORT_IMAGE_DECODER    = OK - 19;
+    public static final int ERR_DECODE_IMAGE               = OK - 20;
+    public static final int ERR_NO_PAGE_SOURCE             = OK - 21;
+    public static final int ERR_UNSUPPORT_GLES3            = OK - 22;
 
+    @CriticalNative
     public static native int getError();
+
+    /**
+     * Regular natives bound to the same native functions as critical
+     * getters, only for timing JNI transitions of both kinds in
+     * JNICallBenchmark
+     */
+    static native int getFlipStateRegular();
+    static native boolean isAnimatingRegular();
+    static native boolean isFirstTextureSetRegular(boolean isFirstPage);
 }
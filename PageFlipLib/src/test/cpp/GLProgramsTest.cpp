@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <EGL/egl.h>
+#include "GLRenderBackend.h"
+#include "GLES3RenderBackend.h"
+#include "Error.h"
+
+using namespace eschao;
+
+// ctest skips the test with this code if there is no EGL, e.g. no Mesa
+static const int kSkipCode = 77;
+
+/**
+ * Make a pbuffer context of given GLES version current
+ *
+ * @return true if successfully
+ */
+static bool makeContext(EGLDisplay display, int version) {
+    const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE,
+            version >= 3 ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_ES2_BIT,
+            EGL_DEPTH_SIZE, 16,
+            EGL_NONE
+    };
+    EGLConfig config;
+    EGLint count = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &count) ||
+        count < 1) {
+        return false;
+    }
+
+    const EGLint surfaceAttribs[] = { EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE };
+    const EGLint contextAttribs[] = {
+            EGL_CONTEXT_CLIENT_VERSION, version, EGL_NONE
+    };
+    EGLSurface surface = eglCreatePbufferSurface(display, config,
+                                                 surfaceAttribs);
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT,
+                                          contextAttribs);
+    return surface != EGL_NO_SURFACE && context != EGL_NO_CONTEXT &&
+           eglMakeCurrent(display, surface, surface, context);
+}
+
+/**
+ * Compile and link GLSL of all programs of both GL backends, shader errors
+ * are only found by GL driver
+ */
+int main() {
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL) ||
+        !eglBindAPI(EGL_OPENGL_ES_API)) {
+        fprintf(stderr, "SKIP: no EGL display\n");
+        return kSkipCode;
+    }
+
+    int failures = 0;
+    if (!makeContext(display, 2)) {
+        fprintf(stderr, "SKIP: no GLES2 context\n");
+        return kSkipCode;
+    }
+
+    GLRenderBackend gles2Backend;
+    if (gles2Backend.init() != Error::OK) {
+        fprintf(stderr, "FAIL: GLES2 backend: %s\n", gError.desc());
+        ++failures;
+    }
+
+    if (makeContext(display, 3)) {
+        GLES3RenderBackend gles3Backend;
+        if (gles3Backend.init() != Error::OK) {
+            fprintf(stderr, "FAIL: GLES3 backend: %s\n", gError.desc());
+            ++failures;
+        }
+    }
+    else {
+        fprintf(stderr, "GLES3 context isn't supported, skip its backend\n");
+    }
+
+    if (failures == 0) {
+        printf("PASS\n");
+    }
+    return failures ? 1 : 0;
+}
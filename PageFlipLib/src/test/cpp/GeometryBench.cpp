@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "GeometryThreadPool.h"
+#include "PageFlip.h"
+#include "SoftwareRenderBackend.h"
+#include "Error.h"
+
+using namespace eschao;
+
+// surface of a large phone, the longest fold has most steps
+static const int kSurfaceWidth = 1440;
+static const int kSurfaceHeight = 2560;
+static const int kMovesOfGesture = 64;
+static const int kRounds = 5;
+static const int kDispatchRuns = 20000;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void emptyJob(void *arg, int begin, int end) {
+}
+
+/**
+ * Time of one run() of thread pool with nothing to compute, it is the cost
+ * of posting slices to workers and waiting for them
+ *
+ * @return microseconds of one run
+ */
+static double measureDispatch(int threads) {
+    GeometryThreadPool pool;
+    if (pool.setThreads(threads) != Error::OK) {
+        return -1;
+    }
+
+    double best = 0;
+    for (int r = 0; r < kRounds; ++r) {
+        const double start = now();
+        for (int i = 0; i < kDispatchRuns; ++i) {
+            pool.run(emptyJob, NULL, threads, 1);
+        }
+        const double time = (now() - start) / kDispatchRuns;
+        best = r == 0 || time < best ? time : best;
+    }
+    return best;
+}
+
+/**
+ * Time of one slope move, meshes are computed in onFingerMove()
+ *
+ * @param steps [out] mean steps of slope meshes in one move
+ * @return microseconds of one move
+ */
+static double measureMove(int threads, int pixelsOfMesh, double &steps) {
+    SoftwareRenderBackend backend;
+    PageFlip pageFlip;
+    pageFlip.setRenderBackend(&backend);
+    pageFlip.setPixelsOfMesh(pixelsOfMesh);
+    if (pageFlip.onSurfaceCreated() != Error::OK) {
+        return -1;
+    }
+    pageFlip.onSurfaceChanged(kSurfaceWidth, kSurfaceHeight);
+    if (pageFlip.setGeometryThreads(threads) != Error::OK) {
+        return -1;
+    }
+
+    double best = 0;
+    for (int r = 0; r < kRounds; ++r) {
+        const float x0 = kSurfaceWidth - 4.0f;
+        const float y0 = kSurfaceHeight - 4.0f;
+        int meshes = 0;
+        double time = 0;
+        pageFlip.onFingerDown(x0, y0);
+        for (int i = 1; i <= kMovesOfGesture; ++i) {
+            const float x = x0 - i * (kSurfaceWidth * 0.9f / kMovesOfGesture);
+            const float y = y0 - i * (kSurfaceHeight * 0.3f / kMovesOfGesture);
+            const double start = now();
+            pageFlip.onFingerMove(x, y, true, false);
+            time += now() - start;
+            meshes += pageFlip.meshCount();
+        }
+        pageFlip.onFingerUp(x0, y0, 0, true, false);
+
+        // back and front strips of slope meshes
+        steps = 2.0 * meshes / kMovesOfGesture + 1;
+        time /= kMovesOfGesture;
+        best = r == 0 || time < best ? time : best;
+    }
+    return best;
+}
+
+/**
+ * Measure cost of geometry threads and the min steps of one thread which
+ * is worth waking it up
+ * <p>Cost of one step is the slope of move time over steps at different
+ * mesh densities in one thread. Splitting n steps to two threads saves
+ * n / 2 steps and costs one dispatch, so the min steps of one thread is
+ * dispatch time / step time</p>
+ */
+int main(int argc, char **argv) {
+    const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    const int maxThreads = argc > 1 ? atoi(argv[1]) : kMaxGeometryThreads;
+    if (maxThreads < 1 || maxThreads > kMaxGeometryThreads) {
+        fprintf(stderr, "Usage: pageflip_geometry_bench [max threads]\n");
+        return 2;
+    }
+
+    printf("online cores: %ld\n", cores);
+    if (cores < 2) {
+        printf("only one core, threads take turns and speedup is noise, "
+               "dispatch is a context switch, not a wake-up on another core\n");
+    }
+    printf("\n");
+    printf("%8s %14s\n", "threads", "dispatch us");
+    double dispatch2 = 0;
+    for (int t = 2; t <= maxThreads; ++t) {
+        const double time = measureDispatch(t);
+        printf("%8d %14.2f\n", t, time);
+        if (t == 2) {
+            dispatch2 = time;
+        }
+    }
+
+    // least squares of move time over steps in one thread
+    static const int pixels[] = { 1, 2, 4, 8, 16 };
+    const int count = sizeof(pixels) / sizeof(pixels[0]);
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    printf("\n%8s %10s %10s\n", "pixels", "steps", "move us");
+    for (int i = 0; i < count; ++i) {
+        double steps = 0;
+        const double time = measureMove(1, pixels[i], steps);
+        printf("%8d %10.1f %10.2f\n", pixels[i], steps, time);
+        sx += steps;
+        sy += time;
+        sxx += steps * steps;
+        sxy += steps * time;
+    }
+    const double stepTime = (count * sxy - sx * sy) / (count * sxx - sx * sx);
+    printf("one step: %.4f us\n", stepTime);
+
+    printf("\n%8s %10s %10s %10s\n", "threads", "steps", "move us",
+           "speedup");
+    double single = 0;
+    for (int t = 1; t <= maxThreads; ++t) {
+        double steps = 0;
+        const double time = measureMove(t, 1, steps);
+        single = t == 1 ? time : single;
+        printf("%8d %10.1f %10.2f %10.2f\n", t, steps, time, single / time);
+    }
+
+    if (maxThreads >= 2 && stepTime > 0) {
+        printf("\nmin steps of one geometry thread: %d "
+               "(dispatch %.2f us / step %.4f us)\n",
+               (int)ceil(dispatch2 / stepTime), dispatch2, stepTime);
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <android/log.h>
+
+/**
+ * Print log of priority PAGEFLIP_LOG_LEVEL or higher to stderr, only
+ * warnings and errors are printed by default
+ */
+int __android_log_print(int prio, const char *tag, const char *fmt, ...) {
+    static int level = -1;
+    if (level < 0) {
+        const char *env = getenv("PAGEFLIP_LOG_LEVEL");
+        level = env ? atoi(env) : ANDROID_LOG_WARN;
+    }
+
+    if (prio < level) {
+        return 0;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int n = fprintf(stderr, "%s: ", tag);
+    n += vfprintf(stderr, fmt, args);
+    n += fprintf(stderr, "\n");
+    va_end(args);
+    return n;
+}
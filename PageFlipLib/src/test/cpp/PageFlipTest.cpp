@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <new>
+#include "PageFlip.h"
+#include "SoftwareRenderBackend.h"
+#include "Error.h"
+
+using namespace eschao;
+
+static const int kSurfaceWidth = 240;
+static const int kSurfaceHeight = 360;
+
+static int gFailures = 0;
+
+// heap allocations are counted while it is true
+static bool gIsCountingNew = false;
+static int gNewCount = 0;
+
+void* operator new(size_t size) {
+    if (gIsCountingNew) {
+        ++gNewCount;
+    }
+
+    void *p = malloc(size ? size : 1);
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", \
+                    __FILE__, __LINE__, #cond); \
+            ++gFailures; \
+        } \
+    } while (0)
+
+static bool setUp(PageFlip &pageFlip, SoftwareRenderBackend &backend) {
+    pageFlip.setRenderBackend(&backend);
+    if (pageFlip.onSurfaceCreated() != Error::OK) {
+        return false;
+    }
+
+    pageFlip.onSurfaceChanged(kSurfaceWidth, kSurfaceHeight);
+    return true;
+}
+
+/**
+ * Drag from bottom right corner to the middle of page, it leaves page in
+ * forward flip
+ */
+static void drag(PageFlip &pageFlip) {
+    pageFlip.onFingerDown(kSurfaceWidth - 4, kSurfaceHeight - 4);
+    for (int i = 1; i <= 8; ++i) {
+        pageFlip.onFingerMove(kSurfaceWidth - 4 - i * 15,
+                              kSurfaceHeight - 4 - i * 10, true, false);
+    }
+}
+
+/**
+ * Buffers are only re-laid out out of flipping, the meshes on screen are
+ * kept while page is flipping
+ */
+static void testLayoutInFlipping() {
+    SoftwareRenderBackend backend;
+    PageFlip pageFlip;
+    CHECK(setUp(pageFlip, backend));
+
+    drag(pageFlip);
+    CHECK(pageFlip.flipState() == FORWARD_FLIP);
+    const int meshCount = pageFlip.meshCount();
+    CHECK(meshCount > 0);
+
+    CHECK(pageFlip.setPixelsOfMesh(2) == Error::ERR_INVALID_PARAMETER);
+    CHECK(pageFlip.pixelsOfMesh() != 2);
+    CHECK(pageFlip.setBurstFlip(2, 0.2f) == Error::ERR_INVALID_PARAMETER);
+    CHECK(pageFlip.enablePipelinedGeometry(true) ==
+          Error::ERR_INVALID_PARAMETER);
+    CHECK(pageFlip.meshCount() == meshCount);
+
+    // animation to the end of flip, then settings are accepted
+    pageFlip.onFingerUp(kSurfaceWidth - 124, kSurfaceHeight - 84, 100,
+                        true, false);
+    for (int i = 0; i < 100 && pageFlip.animating(); ++i) {
+        usleep(10000);
+    }
+    CHECK(pageFlip.isEndedFlip());
+    CHECK(pageFlip.setPixelsOfMesh(2) == Error::OK);
+    CHECK(pageFlip.pixelsOfMesh() == 2);
+}
+
+/**
+ * Click to flip the page at the same point and play the animation
+ *
+ * @return played frames
+ */
+static int clickToFlip(PageFlip &pageFlip) {
+    const float x = kSurfaceWidth - 20;
+    const float y = kSurfaceHeight - 20;
+    pageFlip.onFingerDown(x, y);
+    int frames = 0;
+    if (pageFlip.onFingerUp(x, y, 200, true, false)) {
+        for (; frames < 100 && pageFlip.animating(); ++frames) {
+            usleep(5000);
+        }
+    }
+    return frames;
+}
+
+/**
+ * Keyframes are recorded and replayed into meshes which are allocated when
+ * buffers are laid out, animating doesn't allocate from heap
+ */
+static void testKeyframesWithoutAllocation() {
+    SoftwareRenderBackend backend;
+    PageFlip pageFlip;
+    CHECK(pageFlip.setAnimationKeyframes(16) == Error::OK);
+    CHECK(setUp(pageFlip, backend));
+
+    // the first animation records keyframes, the second one replays them
+    gNewCount = 0;
+    gIsCountingNew = true;
+    CHECK(clickToFlip(pageFlip) > 0);
+    CHECK(clickToFlip(pageFlip) > 0);
+    gIsCountingNew = false;
+    CHECK(gNewCount == 0);
+
+    // keyframe count is a layout setting
+    drag(pageFlip);
+    CHECK(pageFlip.setAnimationKeyframes(8) == Error::ERR_INVALID_PARAMETER);
+    CHECK(pageFlip.animationKeyframes() == 16);
+}
+
+/**
+ * Pages of burst flip are computed in animating, drawing a frame only
+ * submits their meshes and doesn't touch geometry
+ */
+static void testBurstDrawing() {
+    SoftwareRenderBackend backend;
+    PageFlip pageFlip;
+    CHECK(pageFlip.setBurstFlip(4, 0.2f) == Error::OK);
+    CHECK(setUp(pageFlip, backend));
+
+    drag(pageFlip);
+    CHECK(pageFlip.onFingerUp(kSurfaceWidth - 124, kSurfaceHeight - 84, 200,
+                              true, false));
+    int frames = 0;
+    for (; frames < 100 && pageFlip.animating(); ++frames) {
+        const int meshCount = pageFlip.meshCount();
+        pageFlip.drawFlipFrame();
+        CHECK(pageFlip.meshCount() == meshCount);
+        CHECK(pageFlip.flipState() == FORWARD_FLIP);
+        usleep(5000);
+    }
+    CHECK(frames > 0);
+}
+
+int main() {
+    testLayoutInFlipping();
+    testKeyframesWithoutAllocation();
+    testBurstDrawing();
+
+    if (gFailures) {
+        fprintf(stderr, "%d checks failed\n", gFailures);
+        return 1;
+    }
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "PngImage.h"
+#include "Error.h"
+
+namespace eschao {
+
+static const unsigned char kSignature[] = {
+        0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+};
+
+static uint32_t getUint32(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void putUint32(std::vector<unsigned char> &out, uint32_t v) {
+    out.push_back((unsigned char)(v >> 24));
+    out.push_back((unsigned char)(v >> 16));
+    out.push_back((unsigned char)(v >> 8));
+    out.push_back((unsigned char)v);
+}
+
+static void putChunk(std::vector<unsigned char> &out, const char *type,
+                     const unsigned char *data, size_t size) {
+    putUint32(out, (uint32_t)size);
+    const size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+    putUint32(out, (uint32_t)::crc32(0, &out[start], (uInt)(size + 4)));
+}
+
+static int paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = abs(p - a);
+    const int pb = abs(p - b);
+    const int pc = abs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+PngImage::PngImage()
+        : mWidth(0),
+          mHeight(0) {
+}
+
+/**
+ * Load 8 bits RGB or RGBA PNG file without interlace
+ *
+ * @param path file path
+ * @return Error::OK if successfully
+ */
+int PngImage::load(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    std::vector<unsigned char> data;
+    unsigned char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    fclose(file);
+
+    if (data.size() < sizeof(kSignature) ||
+        memcmp(&data[0], kSignature, sizeof(kSignature)) != 0) {
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    int width = 0, height = 0, bpp = 0;
+    std::vector<unsigned char> idat;
+    for (size_t pos = sizeof(kSignature); pos + 12 <= data.size(); ) {
+        const uint32_t size = getUint32(&data[pos]);
+        const unsigned char *type = &data[pos + 4];
+        const unsigned char *chunk = &data[pos + 8];
+        if (pos + 12 + size > data.size()) {
+            return Error::ERR_INVALID_PARAMETER;
+        }
+
+        if (memcmp(type, "IHDR", 4) == 0) {
+            width = (int)getUint32(chunk);
+            height = (int)getUint32(chunk + 4);
+            // bit depth 8, color type RGB or RGBA, no interlace
+            if (size < 13 || chunk[8] != 8 || chunk[12] != 0 ||
+                (chunk[9] != 2 && chunk[9] != 6)) {
+                return Error::ERR_INVALID_PARAMETER;
+            }
+            bpp = chunk[9] == 6 ? 4 : 3;
+        }
+        else if (memcmp(type, "IDAT", 4) == 0) {
+            idat.insert(idat.end(), chunk, chunk + size);
+        }
+        else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + size;
+    }
+
+    if (width < 1 || height < 1 || idat.empty()) {
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    const size_t rowSize = (size_t)width * bpp;
+    std::vector<unsigned char> raw((rowSize + 1) * height);
+    uLongf rawSize = (uLongf)raw.size();
+    if (uncompress(&raw[0], &rawSize, &idat[0], (uLong)idat.size()) != Z_OK ||
+        rawSize != raw.size()) {
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    // undo row filters in place, then expand to RGBA
+    mWidth = width;
+    mHeight = height;
+    mPixels.resize((size_t)width * height * 4);
+    for (int y = 0; y < height; ++y) {
+        unsigned char *row = &raw[(rowSize + 1) * y];
+        const unsigned char *prev = y > 0 ? row - rowSize : NULL;
+        const int filter = *row++;
+        for (size_t x = 0; x < rowSize; ++x) {
+            const int a = x >= (size_t)bpp ? row[x - bpp] : 0;
+            const int b = prev ? prev[x] : 0;
+            const int c = (prev && x >= (size_t)bpp) ? prev[x - bpp] : 0;
+            switch (filter) {
+                case 0: break;
+                case 1: row[x] += a; break;
+                case 2: row[x] += b; break;
+                case 3: row[x] += (a + b) >> 1; break;
+                case 4: row[x] += paeth(a, b, c); break;
+                default: return Error::ERR_INVALID_PARAMETER;
+            }
+        }
+
+        unsigned char *dst = &mPixels[(size_t)width * 4 * y];
+        for (int x = 0; x < width; ++x, dst += 4, row += bpp) {
+            dst[0] = row[0];
+            dst[1] = row[1];
+            dst[2] = row[2];
+            dst[3] = bpp == 4 ? row[3] : 255;
+        }
+    }
+
+    return Error::OK;
+}
+
+/**
+ * Save as compressed RGBA PNG file, rows are filtered by the up filter which
+ * suits rendered pages well
+ *
+ * @param path file path
+ * @return Error::OK if successfully
+ */
+int PngImage::save(const char *path) {
+    if (mPixels.empty()) {
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    const size_t rowSize = (size_t)mWidth * 4;
+    std::vector<unsigned char> raw((rowSize + 1) * mHeight);
+    for (int y = 0; y < mHeight; ++y) {
+        unsigned char *dst = &raw[(rowSize + 1) * y];
+        const unsigned char *row = &mPixels[rowSize * y];
+        const unsigned char *prev = y > 0 ? row - rowSize : NULL;
+        *dst++ = 2;
+        for (size_t x = 0; x < rowSize; ++x) {
+            dst[x] = (unsigned char)(row[x] - (prev ? prev[x] : 0));
+        }
+    }
+
+    uLongf size = compressBound((uLong)raw.size());
+    std::vector<unsigned char> idat(size);
+    if (compress2(&idat[0], &size, &raw[0], (uLong)raw.size(), 9) != Z_OK) {
+        return Error::ERROR;
+    }
+
+    unsigned char ihdr[13] = { 0 };
+    ihdr[0] = (unsigned char)(mWidth >> 24);
+    ihdr[1] = (unsigned char)(mWidth >> 16);
+    ihdr[2] = (unsigned char)(mWidth >> 8);
+    ihdr[3] = (unsigned char)mWidth;
+    ihdr[4] = (unsigned char)(mHeight >> 24);
+    ihdr[5] = (unsigned char)(mHeight >> 16);
+    ihdr[6] = (unsigned char)(mHeight >> 8);
+    ihdr[7] = (unsigned char)mHeight;
+    ihdr[8] = 8;
+    ihdr[9] = 6;
+
+    std::vector<unsigned char> out(kSignature,
+                                   kSignature + sizeof(kSignature));
+    putChunk(out, "IHDR", ihdr, sizeof(ihdr));
+    putChunk(out, "IDAT", &idat[0], size);
+    putChunk(out, "IEND", NULL, 0);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    const bool isOK = fwrite(&out[0], 1, out.size(), file) == out.size();
+    fclose(file);
+    return isOK ? Error::OK : Error::ERROR;
+}
+
+/**
+ * Set with RGBA_8888 pixels, the first row is the top of image
+ *
+ * @return Error::OK if successfully
+ */
+int PngImage::set(int width, int height, const unsigned char *rgba,
+                  size_t stride) {
+    if (rgba == NULL || width < 1 || height < 1) {
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mPixels.resize((size_t)width * height * 4);
+    for (int y = 0; y < height; ++y) {
+        memcpy(&mPixels[(size_t)width * 4 * y], rgba + stride * y,
+               (size_t)width * 4);
+    }
+    return Error::OK;
+}
+
+/**
+ * Compare with other image of the same size
+ *
+ * @param other other image
+ * @param diff difference of RGB channels, alpha is ignored
+ * @return false if size is different
+ */
+bool PngImage::compare(const PngImage &other, ImageDiff &diff) const {
+    diff.meanDiff = 0;
+    diff.offPixels = 0;
+    diff.maxDiff = 0;
+    if (mWidth != other.mWidth || mHeight != other.mHeight ||
+        mPixels.empty()) {
+        return false;
+    }
+
+    const size_t count = (size_t)mWidth * mHeight;
+    double sum = 0;
+    size_t offCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned char *a = &mPixels[i * 4];
+        const unsigned char *b = &other.mPixels[i * 4];
+        int maxDiff = 0;
+        for (int k = 0; k < 3; ++k) {
+            const int d = abs((int)a[k] - (int)b[k]);
+            sum += d;
+            maxDiff = d > maxDiff ? d : maxDiff;
+        }
+
+        if (maxDiff > ImageDiff::kOffPixelThreshold) {
+            ++offCount;
+        }
+        diff.maxDiff = maxDiff > diff.maxDiff ? maxDiff : diff.maxDiff;
+    }
+
+    diff.meanDiff = (float)(sum / (count * 3));
+    diff.offPixels = (float)offCount / count;
+    return true;
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_PNGIMAGE_H
+#define ANDROID_PAGEFLIP_PNGIMAGE_H
+
+#include <stddef.h>
+#include <vector>
+
+namespace eschao {
+
+/**
+ * Difference between two images
+ * <p>meanDiff is the mean absolute difference of all color channels, in
+ * [0 .. 255]. offPixels is the fraction of pixels which have any channel
+ * differed more than {@link #kOffPixelThreshold}</p>
+ */
+struct ImageDiff {
+    static const int kOffPixelThreshold = 16;
+
+    float meanDiff;
+    float offPixels;
+    int maxDiff;
+};
+
+/**
+ * RGBA_8888 image read from or written to PNG file for host tests
+ * <p>It reads 8 bits RGB and RGBA PNG files of any filter, including the
+ * uncompressed ones dumped by {@link PngWriter}, and writes compressed files
+ * for golden images</p>
+ */
+class PngImage {
+
+public:
+    PngImage();
+
+    int load(const char *path);
+    int save(const char *path);
+    int set(int width, int height, const unsigned char *rgba, size_t stride);
+    bool compare(const PngImage &other, ImageDiff &diff) const;
+
+    // inline
+    inline int width() const {
+        return mWidth;
+    }
+
+    inline int height() const {
+        return mHeight;
+    }
+
+    inline const unsigned char* pixels() const {
+        return mPixels.empty() ? NULL : &mPixels[0];
+    }
+
+private:
+    int mWidth;
+    int mHeight;
+    std::vector<unsigned char> mPixels;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_PNGIMAGE_H
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "FoldCylinder.h"
+#include "Matrix.h"
+#include "Vec4.h"
+
+using namespace eschao;
+
+#if defined(PAGEFLIP_VEC4_NEON) && defined(__aarch64__)
+static const char *kPath = "NEON (AArch64)";
+#elif defined(PAGEFLIP_VEC4_NEON)
+static const char *kPath = "NEON (ARMv7)";
+#elif defined(PAGEFLIP_VEC4_SSE)
+static const char *kPath = "SSE";
+#else
+static const char *kPath = "scalar";
+#endif
+
+static const int kRandomRuns = 1000;
+static const int kBenchPoints = 1 << 12;
+static const int kBenchRounds = 200;
+
+static int gFailures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", \
+                    __FILE__, __LINE__, #cond); \
+            ++gFailures; \
+        } \
+    } while (0)
+
+static float random(float min, float max) {
+    return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000.0 + ts.tv_nsec;
+}
+
+static bool isNear(float a, float b, float tolerance) {
+    return fabsf(a - b) <= tolerance * (1 + fabsf(b));
+}
+
+/**
+ * Every lane goes through the same float operation as scalar code, results
+ * must be equal bit by bit
+ */
+static void testVec4() {
+    for (int n = 0; n < kRandomRuns; ++n) {
+        float a[4], b[4], r[4];
+        for (int i = 0; i < 4; ++i) {
+            a[i] = random(-1000, 1000);
+            b[i] = random(0.01f, 1000) * (i & 1 ? -1 : 1);
+        }
+
+        const Vec4 va = Vec4::load(a);
+        const Vec4 vb = Vec4::load(b);
+        va.store(r);
+        CHECK(memcmp(r, a, sizeof(r)) == 0);
+
+        Vec4(a[0], a[1], a[2], a[3]).store(r);
+        CHECK(memcmp(r, a, sizeof(r)) == 0);
+
+        Vec4(a[2]).store(r);
+        CHECK(r[0] == a[2] && r[1] == a[2] && r[2] == a[2] && r[3] == a[2]);
+
+        (va + vb).store(r);
+        for (int i = 0; i < 4; ++i) CHECK(r[i] == a[i] + b[i]);
+        (va - vb).store(r);
+        for (int i = 0; i < 4; ++i) CHECK(r[i] == a[i] - b[i]);
+        (va * vb).store(r);
+        for (int i = 0; i < 4; ++i) CHECK(r[i] == a[i] * b[i]);
+        (va / vb).store(r);
+        for (int i = 0; i < 4; ++i) CHECK(r[i] == a[i] / b[i]);
+    }
+
+    // rows of 4x4 become columns
+    float m[16], t[16];
+    for (int i = 0; i < 16; ++i) {
+        m[i] = (float)i;
+    }
+    Vec4 a = Vec4::load(m);
+    Vec4 b = Vec4::load(m + 4);
+    Vec4 c = Vec4::load(m + 8);
+    Vec4 d = Vec4::load(m + 12);
+    Vec4::transpose(a, b, c, d);
+    a.store(t);
+    b.store(t + 4);
+    c.store(t + 8);
+    d.store(t + 12);
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            CHECK(t[(i << 2) + j] == m[(j << 2) + i]);
+        }
+    }
+}
+
+/**
+ * Plain column-major multiplication, the reference of Mat4::operator*
+ */
+static void multiply(const float *lhs, const float *rhs, float *out) {
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            float sum = 0;
+            for (int k = 0; k < 4; ++k) {
+                sum += lhs[(k << 2) + j] * rhs[(i << 2) + k];
+            }
+            out[(i << 2) + j] = sum;
+        }
+    }
+}
+
+static void randomMatrix(Mat4 &m) {
+    for (int i = 0; i < 16; ++i) {
+        m.m[i] = random(-100, 100);
+    }
+}
+
+static void testMat4() {
+    for (int n = 0; n < kRandomRuns; ++n) {
+        Mat4 a, b;
+        randomMatrix(a);
+        randomMatrix(b);
+
+        float ref[16];
+        multiply(a.m, b.m, ref);
+        const Mat4 r = a * b;
+        for (int i = 0; i < 16; ++i) {
+            CHECK(isNear(r.m[i], ref[i], 1e-5f));
+        }
+    }
+
+    const Mat4 m = Mat4::translation(3, 4, 5) * Mat4::scale(2, 2, 2);
+    CHECK(m * Mat4::identity() == m);
+    CHECK(Mat4::identity() * m == m);
+}
+
+static void randomCylinder(FoldCylinder<float> &cylinder) {
+    const float angle = random(-3.1f, 3.1f);
+    cylinder.set(random(10, 200), random(-500, 500), sinf(angle),
+                 cosf(angle), random(0, 1440), random(0, 2560));
+}
+
+/**
+ * Vector kernel must map 4 points as scalar kernel does one by one
+ */
+static void testMap4() {
+    FoldCylinder<float> cylinder;
+    for (int n = 0; n < kRandomRuns; ++n) {
+        randomCylinder(cylinder);
+
+        float x[4], y[4], out[16];
+        for (int i = 0; i < 4; ++i) {
+            x[i] = random(-1440, 1440);
+            y[i] = random(-2560, 2560);
+        }
+        cylinder.map4(Vec4::load(x), Vec4::load(y), out);
+
+        for (int i = 0; i < 4; ++i) {
+            float cx, cy, cz;
+            const float sinR = cylinder.map(x[i], y[i], cx, cy, cz);
+            const float *v = out + (i << 2);
+            CHECK(isNear(v[0], cx, 1e-5f));
+            CHECK(isNear(v[1], cy, 1e-5f));
+            CHECK(isNear(v[2], cz, 1e-5f));
+            CHECK(isNear(v[3], sinR, 1e-5f));
+        }
+    }
+}
+
+/**
+ * Time vector paths against scalar ones, nanoseconds of one point or one
+ * matrix multiplication are printed
+ */
+static void bench() {
+    static float x[kBenchPoints], y[kBenchPoints], out[kBenchPoints << 2];
+    for (int i = 0; i < kBenchPoints; ++i) {
+        x[i] = random(-1440, 1440);
+        y[i] = random(-2560, 2560);
+    }
+    FoldCylinder<float> cylinder;
+    randomCylinder(cylinder);
+
+    double best4 = 0, best1 = 0;
+    for (int r = 0; r < kBenchRounds; ++r) {
+        double start = now();
+        for (int i = 0; i < kBenchPoints; i += 4) {
+            cylinder.map4(Vec4::load(x + i), Vec4::load(y + i),
+                          out + (i << 2));
+        }
+        const double time4 = now() - start;
+
+        start = now();
+        for (int i = 0; i < kBenchPoints; ++i) {
+            float *v = out + (i << 2);
+            v[3] = cylinder.map(x[i], y[i], v[0], v[1], v[2]);
+        }
+        const double time1 = now() - start;
+        best4 = r == 0 || time4 < best4 ? time4 : best4;
+        best1 = r == 0 || time1 < best1 ? time1 : best1;
+    }
+    printf("map4: %.2f ns/point, map: %.2f ns/point, speedup %.2f\n",
+           best4 / kBenchPoints, best1 / kBenchPoints, best1 / best4);
+
+    // products of neighbours, chained products would overflow
+    static Mat4 m[kBenchPoints], p[kBenchPoints];
+    static float ref[kBenchPoints][16];
+    for (int i = 0; i < kBenchPoints; ++i) {
+        randomMatrix(m[i]);
+    }
+    double bestM = 0, bestR = 0;
+    for (int r = 0; r < kBenchRounds; ++r) {
+        double start = now();
+        for (int i = 1; i < kBenchPoints; ++i) {
+            p[i] = m[i - 1] * m[i];
+        }
+        const double timeM = now() - start;
+
+        start = now();
+        for (int i = 1; i < kBenchPoints; ++i) {
+            multiply(m[i - 1].m, m[i].m, ref[i]);
+        }
+        const double timeR = now() - start;
+        bestM = r == 0 || timeM < bestM ? timeM : bestM;
+        bestR = r == 0 || timeR < bestR ? timeR : bestR;
+    }
+    CHECK(isNear(p[1].m[0], ref[1][0], 1e-5f));
+    printf("Mat4 *: %.2f ns, plain: %.2f ns, speedup %.2f\n",
+           bestM / kBenchPoints, bestR / kBenchPoints, bestR / bestM);
+}
+
+/**
+ * Check vector paths of Vec4, Mat4 and FoldCylinder against scalar code,
+ * or time them with argument "bench"
+ */
+int main(int argc, char **argv) {
+    printf("vector path: %s\n", kPath);
+    srand(20161019);
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bench();
+        return 0;
+    }
+
+    testVec4();
+    testMat4();
+    testMap4();
+
+    if (gFailures) {
+        fprintf(stderr, "%d checks failed\n", gFailures);
+        return 1;
+    }
+
+    printf("PASS\n");
+    return 0;
+}
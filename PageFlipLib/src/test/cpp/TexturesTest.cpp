@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <set>
+#include <vector>
+#include "Page.h"
+#include "SoftwareRenderBackend.h"
+#include "TextureImporter.h"
+#include "Error.h"
+
+using namespace eschao;
+
+static int gFailures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", \
+                    __FILE__, __LINE__, #cond); \
+            ++gFailures; \
+        } \
+    } while (0)
+
+/**
+ * Importer without dmabuf or EGL, every import gets a new texture id and an
+ * image handle, released handles are recorded
+ */
+class StubImporter : public TextureImporter {
+
+public:
+    StubImporter() : mNextId(1000), mIsFailing(false) { }
+
+    virtual bool isSupported() {
+        return true;
+    }
+
+    virtual int import(void *buffer, GLuint &texId, void *&image) {
+        if (buffer == NULL) {
+            return gError.set(Error::ERR_NULL_PARAMETER);
+        }
+
+        if (mIsFailing) {
+            return gError.set(Error::ERR_IMPORT_HARDWARE_BUFFER);
+        }
+
+        texId = mNextId++;
+        image = (void *)(size_t)texId;
+        mAlive.insert(image);
+        return Error::OK;
+    }
+
+    virtual void release(void *image) {
+        CHECK(mAlive.erase(image) == 1);
+        mReleased.push_back(image);
+    }
+
+    inline void setFailing(bool isFailing) {
+        mIsFailing = isFailing;
+    }
+
+    inline size_t aliveCount() {
+        return mAlive.size();
+    }
+
+    inline bool isAlive(GLuint texId) {
+        return mAlive.count((void *)(size_t)texId) > 0;
+    }
+
+    inline size_t releasedCount() {
+        return mReleased.size();
+    }
+
+private:
+    GLuint mNextId;
+    bool mIsFailing;
+    std::set<void *> mAlive;
+    std::vector<void *> mReleased;
+};
+
+/**
+ * Software backend which records live textures, so leaked and double
+ * deleted textures can be found
+ */
+class RecordingBackend : public SoftwareRenderBackend {
+
+public:
+    virtual GLuint createTexture(AndroidBitmapInfo &info, const void *data) {
+        GLuint id = SoftwareRenderBackend::createTexture(info, data);
+        if (id) {
+            mAlive.insert(id);
+        }
+        return id;
+    }
+
+    virtual void deleteTextures(int count, const GLuint *ids) {
+        for (int i = 0; i < count; ++i) {
+            CHECK(mAlive.erase(ids[i]) == 1 || ids[i] >= 1000);
+            mDeleted.insert(ids[i]);
+        }
+        SoftwareRenderBackend::deleteTextures(count, ids);
+    }
+
+    inline size_t aliveCount() {
+        return mAlive.size();
+    }
+
+    inline bool isDeleted(GLuint id) {
+        return mDeleted.count(id) > 0;
+    }
+
+private:
+    std::set<GLuint> mAlive;
+    std::set<GLuint> mDeleted;
+};
+
+static AndroidBitmapInfo bitmapInfo() {
+    AndroidBitmapInfo info;
+    info.width = 4;
+    info.height = 4;
+    info.stride = 16;
+    info.format = ANDROID_BITMAP_FORMAT_RGBA_8888;
+    info.flags = 0;
+    return info;
+}
+
+static void *buffer(int i) {
+    return (void *)(size_t)(0x100 + i);
+}
+
+/**
+ * Imported textures keep their images until they are recycled
+ */
+static void testImportAndRecycle() {
+    RecordingBackend backend;
+    StubImporter importer;
+    Textures textures;
+    textures.setBackend(&backend);
+
+    CHECK(textures.setFirstTexture(importer, buffer(0), 0xff808080) ==
+          Error::OK);
+    CHECK(textures.setSecondTexture(importer, buffer(1), 0xff808080) ==
+          Error::OK);
+    CHECK(textures.setBackTexture(importer, buffer(2), 0xff808080) ==
+          Error::OK);
+    CHECK(textures.isFirstTextureSet() && textures.isSecondTextureSet() &&
+          textures.isBackTextureSet());
+    CHECK(importer.aliveCount() == 3);
+
+    // first page is flipped over, its textures are queued, not released
+    const GLuint first = textures.firstTextureId();
+    const GLuint second = textures.secondTextureId();
+    textures.setFirstTextureWithSecond();
+    CHECK(textures.firstTextureId() == second);
+    CHECK(!textures.isSecondTextureSet());
+    CHECK(importer.isAlive(first));
+    CHECK(!backend.isDeleted(first));
+
+    textures.recycle();
+    CHECK(!importer.isAlive(first));
+    CHECK(backend.isDeleted(first));
+    CHECK(importer.isAlive(second));
+    CHECK(importer.aliveCount() == 2);
+
+    // recycling twice doesn't release anything again
+    textures.recycle();
+    CHECK(importer.releasedCount() == 1);
+
+    // removing back texture queues it too
+    const GLuint back = textures.backTextureId();
+    CHECK(textures.setBackTexture(importer, NULL, 0) == Error::OK);
+    CHECK(!textures.isBackTextureSet());
+    CHECK(textures.backTextureId() == second);
+    CHECK(importer.isAlive(back));
+    textures.recycle();
+    CHECK(!importer.isAlive(back));
+
+    textures.recycleAll();
+    CHECK(importer.aliveCount() == 0);
+    CHECK(importer.releasedCount() == 3);
+    CHECK(!textures.isFirstTextureSet());
+}
+
+/**
+ * A failed import leaves the slot untouched
+ */
+static void testFailedImport() {
+    RecordingBackend backend;
+    StubImporter importer;
+    Textures textures;
+    textures.setBackend(&backend);
+
+    CHECK(textures.setFirstTexture(importer, NULL, 0) ==
+          Error::ERR_NULL_PARAMETER);
+    CHECK(!textures.isFirstTextureSet());
+
+    CHECK(textures.setFirstTexture(importer, buffer(0), 0) == Error::OK);
+    const GLuint first = textures.firstTextureId();
+    importer.setFailing(true);
+    CHECK(textures.setSecondTexture(importer, buffer(1), 0) ==
+          Error::ERR_IMPORT_HARDWARE_BUFFER);
+    CHECK(!textures.isSecondTextureSet());
+    CHECK(textures.firstTextureId() == first);
+    CHECK(importer.aliveCount() == 1);
+
+    textures.recycleAll();
+    CHECK(importer.aliveCount() == 0);
+}
+
+/**
+ * Bitmap and imported textures share slots, only imported ones have images
+ * to release
+ */
+static void testMixedTextures() {
+    RecordingBackend backend;
+    StubImporter importer;
+    Textures textures;
+    textures.setBackend(&backend);
+
+    AndroidBitmapInfo info = bitmapInfo();
+    std::vector<unsigned char> pixels(64, 200);
+    CHECK(textures.setFirstTexture(info, &pixels[0]) == Error::OK);
+    CHECK(textures.setSecondTexture(importer, buffer(0), 0) == Error::OK);
+    CHECK(backend.aliveCount() == 1);
+
+    textures.setSecondTextureWithFirst();
+    textures.recycle();
+    CHECK(importer.aliveCount() == 0);
+    CHECK(backend.aliveCount() == 1);
+
+    // import into the slot which still holds the moved bitmap, the moved
+    // bitmap mustn't be deleted with it
+    CHECK(textures.setFirstTexture(importer, buffer(1), 0) == Error::OK);
+    textures.setFirstTextureWithSecond();
+    CHECK(importer.aliveCount() == 1);
+    textures.recycle();
+    CHECK(importer.aliveCount() == 0);
+    CHECK(importer.releasedCount() == 2);
+
+    textures.recycleAll();
+    CHECK(backend.aliveCount() == 0);
+}
+
+/**
+ * Swapping textures of two pages in double page mode moves images with
+ * their textures
+ */
+static void testSwapPages() {
+    RecordingBackend backend;
+    StubImporter importer;
+    Textures left, right;
+    left.setBackend(&backend);
+    right.setBackend(&backend);
+
+    CHECK(left.setFirstTexture(importer, buffer(0), 0) == Error::OK);
+    CHECK(left.setSecondTexture(importer, buffer(1), 0) == Error::OK);
+    CHECK(left.setBackTexture(importer, buffer(2), 0) == Error::OK);
+    CHECK(right.setFirstTexture(importer, buffer(3), 0) == Error::OK);
+    CHECK(right.setSecondTexture(importer, buffer(4), 0) == Error::OK);
+    CHECK(right.setBackTexture(importer, buffer(5), 0) == Error::OK);
+
+    const GLuint rightFirst = right.firstTextureId();
+    const GLuint rightBack = right.backTextureId();
+    const GLuint rightSecond = right.secondTextureId();
+    left.swapTexturesWith(right);
+    CHECK(left.firstTextureId() == rightBack);
+    CHECK(left.backTextureId() == rightFirst);
+    CHECK(right.firstTextureId() == rightSecond);
+    CHECK(!right.isSecondTextureSet() && !right.isBackTextureSet());
+
+    // the old second and back of left page are queued
+    CHECK(importer.aliveCount() == 6);
+    left.recycle();
+    right.recycle();
+    CHECK(importer.aliveCount() == 4);
+
+    left.recycleAll();
+    right.recycleAll();
+    CHECK(importer.aliveCount() == 0);
+    CHECK(importer.releasedCount() == 6);
+}
+
+int main() {
+    testImportAndRecycle();
+    testFailedImport();
+    testMixedTextures();
+    testSwapPages();
+
+    if (gFailures) {
+        fprintf(stderr, "%d checks failed\n", gFailures);
+        return 1;
+    }
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <string>
+#include "TraceRenderer.h"
+#include "PngImage.h"
+#include "Error.h"
+
+using namespace eschao;
+
+// ctest skips the test with this code if GL options are given without EGL
+static const int kSkipCode = 77;
+
+static void usage() {
+    fprintf(stderr,
+            "Usage:\n"
+            "  pageflip_trace render <trace> <out dir> [options]\n"
+            "      dump frames of trace to out dir\n"
+            "  pageflip_trace compare <a.png> <b.png> [max mean] [max off]\n"
+            "      compare two images\n"
+            "  pageflip_trace check <trace> <out dir> <options a> "
+            "<options b> [lag] [max mean] [max off]\n"
+            "      play trace with both options and compare frame i of a\n"
+            "      with frame i + lag of b\n"
+            "  pageflip_trace golden <trace> <golden dir> <out dir> "
+            "<options> [max mean] [max off]\n"
+            "      compare frames of trace with golden images\n"
+            "  pageflip_trace update <trace> <golden dir> <options>\n"
+            "      write golden images of trace\n"
+            "  pageflip_trace bench <trace> <out dir> <rounds> "
+            "<reference options> <options>...\n"
+            "      play trace rounds times with every options and print\n"
+            "      cost per flip frame and difference to reference\n"
+            "\n"
+            "max mean is the max mean channel difference, max off is the\n"
+            "max fraction of pixels differed more than %d, both are 0 by\n"
+            "default which means identical. Options are quoted in one\n"
+            "argument, e.g. \"--threads 4 --pipelined\", see TraceOptions.\n"
+            "It exits with %d if options need GL but there is no EGL\n",
+            ImageDiff::kOffPixelThreshold, kSkipCode);
+}
+
+static bool makeDir(const std::string &dir) {
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Can't create directory: %s\n", dir.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Is there any option set in arguments which draws with GL backend
+ */
+static bool isGLNeeded(int argc, char **argv) {
+    for (int i = 2; i < argc; ++i) {
+        TraceOptions options;
+        if (strncmp(argv[i], "--", 2) == 0 &&
+            options.parse(argv[i]) == Error::OK && options.glVersion > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static float argAt(int argc, char **argv, int index, float defaultValue) {
+    return index < argc ? (float)atof(argv[index]) : defaultValue;
+}
+
+/**
+ * Compare two image files and print the difference
+ *
+ * @return true if difference is within the given tolerance
+ */
+static bool compareFiles(const std::string &a, const std::string &b,
+                         float maxMean, float maxOff) {
+    PngImage imageA, imageB;
+    if (imageA.load(a.c_str()) != Error::OK ||
+        imageB.load(b.c_str()) != Error::OK) {
+        fprintf(stderr, "Can't load %s or %s\n", a.c_str(), b.c_str());
+        return false;
+    }
+
+    ImageDiff diff;
+    if (!imageA.compare(imageB, diff)) {
+        fprintf(stderr, "Size of %s and %s is different\n",
+                a.c_str(), b.c_str());
+        return false;
+    }
+
+    const bool isPassed = diff.meanDiff <= maxMean && diff.offPixels <= maxOff;
+    printf("%s %s vs %s: mean %.4f, off %.5f, max %d\n",
+           isPassed ? "PASS" : "FAIL", a.c_str(), b.c_str(),
+           diff.meanDiff, diff.offPixels, diff.maxDiff);
+    return isPassed;
+}
+
+static bool play(const char *trace, const std::string &outDir,
+                 const char *options, bool isCompressed,
+                 std::vector<std::string> &frames,
+                 TraceCost *cost = NULL) {
+    TraceOptions traceOptions;
+    if (traceOptions.parse(options) != Error::OK) {
+        fprintf(stderr, "Invalid options: %s\n", options);
+        return false;
+    }
+
+    if (!makeDir(outDir)) {
+        return false;
+    }
+
+    TraceRenderer renderer(traceOptions);
+    if (renderer.play(trace, outDir.c_str(), isCompressed) != Error::OK) {
+        fprintf(stderr, "Can't play %s with options: %s\n", trace, options);
+        return false;
+    }
+
+    frames = renderer.frames();
+    if (cost) {
+        *cost = renderer.cost();
+    }
+    return true;
+}
+
+/**
+ * Play trace with every option set and print its cost per flip frame
+ * together with its difference to the reference frames
+ * <p>Time is the minimum of rounds to filter out scheduling noise, the
+ * difference is the worst frame of trace.</p>
+ */
+static bool bench(const char *trace, const std::string &outDir, int rounds,
+                  const char *refOptions, char **options, int count) {
+    std::vector<std::string> refFrames, frames;
+    const std::string refDir = outDir + "/ref";
+    if (rounds < 1 || !makeDir(outDir) ||
+        !play(trace, refDir, refOptions, false, refFrames)) {
+        return false;
+    }
+
+    printf("%-36s %8s %10s %10s %8s %8s\n", "options", "meshes",
+           "event ms", "draw ms", "mean", "off");
+    for (int i = 0; i < count; ++i) {
+        char name[16];
+        snprintf(name, sizeof(name), "/%d", i);
+        const std::string dir = outDir + name;
+        double eventTime = 0, drawTime = 0;
+        TraceCost cost;
+        for (int r = 0; r < rounds; ++r) {
+            if (!play(trace, dir, options[i], false, frames, &cost) ||
+                cost.frames < 1) {
+                return false;
+            }
+
+            if (r == 0 || cost.eventTime < eventTime) {
+                eventTime = cost.eventTime;
+            }
+            if (r == 0 || cost.drawTime < drawTime) {
+                drawTime = cost.drawTime;
+            }
+        }
+
+        ImageDiff worst = { 0, 0, 0 };
+        for (size_t j = 0; j < frames.size() && j < refFrames.size(); ++j) {
+            PngImage image, refImage;
+            ImageDiff diff;
+            if (image.load((dir + "/" + frames[j] + ".png").c_str()) !=
+                    Error::OK ||
+                refImage.load((refDir + "/" + refFrames[j] + ".png").c_str())
+                    != Error::OK ||
+                !image.compare(refImage, diff)) {
+                return false;
+            }
+
+            if (diff.meanDiff > worst.meanDiff) {
+                worst.meanDiff = diff.meanDiff;
+            }
+            if (diff.offPixels > worst.offPixels) {
+                worst.offPixels = diff.offPixels;
+            }
+        }
+
+        printf("%-36s %8.1f %10.3f %10.3f %8.4f %8.5f\n", options[i],
+               (float)cost.meshCount / cost.frames, eventTime / cost.frames,
+               drawTime / cost.frames, worst.meanDiff, worst.offPixels);
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        usage();
+        return 2;
+    }
+
+    if (isGLNeeded(argc, argv) && !TraceRenderer::hasEGL()) {
+        fprintf(stderr, "SKIP: no EGL display for GL backend\n");
+        return kSkipCode;
+    }
+
+    const std::string cmd = argv[1];
+    std::vector<std::string> frames;
+    bool isPassed = true;
+    if (cmd == "render") {
+        isPassed = play(argv[2], argv[3], argc > 4 ? argv[4] : "", false,
+                        frames);
+    }
+    else if (cmd == "compare") {
+        isPassed = compareFiles(argv[2], argv[3], argAt(argc, argv, 4, 0),
+                                argAt(argc, argv, 5, 0));
+    }
+    else if (cmd == "check" && argc >= 6) {
+        const std::string dirA = std::string(argv[3]) + "/a";
+        const std::string dirB = std::string(argv[3]) + "/b";
+        const int lag = (int)argAt(argc, argv, 6, 0);
+        std::vector<std::string> framesB;
+        if (lag < 0 || !makeDir(argv[3]) ||
+            !play(argv[2], dirA, argv[4], false, frames) ||
+            !play(argv[2], dirB, argv[5], false, framesB)) {
+            return 1;
+        }
+
+        for (size_t i = 0; i + lag < frames.size(); ++i) {
+            isPassed &= compareFiles(dirA + "/" + frames[i] + ".png",
+                                     dirB + "/" + framesB[i + lag] + ".png",
+                                     argAt(argc, argv, 7, 0),
+                                     argAt(argc, argv, 8, 0));
+        }
+    }
+    else if (cmd == "golden" && argc >= 6) {
+        const std::string goldenDir = argv[3];
+        const std::string outDir = argv[4];
+        if (!play(argv[2], outDir, argv[5], false, frames)) {
+            return 1;
+        }
+
+        for (size_t i = 0; i < frames.size(); ++i) {
+            isPassed &= compareFiles(outDir + "/" + frames[i] + ".png",
+                                     goldenDir + "/" + frames[i] + ".png",
+                                     argAt(argc, argv, 6, 0),
+                                     argAt(argc, argv, 7, 0));
+        }
+    }
+    else if (cmd == "update" && argc >= 5) {
+        isPassed = play(argv[2], argv[3], argv[4], true, frames);
+    }
+    else if (cmd == "bench" && argc >= 7) {
+        isPassed = bench(argv[2], argv[3], atoi(argv[4]), argv[5], argv + 6,
+                         argc - 6);
+    }
+    else {
+        usage();
+        return 2;
+    }
+
+    return isPassed ? 0 : 1;
+}
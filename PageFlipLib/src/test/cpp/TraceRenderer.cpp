@@ -0,0 +1,497 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sstream>
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include "TraceRenderer.h"
+#include "PngImage.h"
+#include "PageFlip.h"
+#include "SoftwareRenderBackend.h"
+#include "Error.h"
+#include "Utility.h"
+
+namespace eschao {
+
+static const auto TAG = "TraceRenderer";
+
+// size of generated page textures
+static const int kTextureSize = 128;
+static const int kTextureCell = 16;
+
+/**
+ * Software backend which draws shadows without blend scissor
+ */
+class UnscissoredBackend : public SoftwareRenderBackend {
+
+public:
+    virtual void drawShadow(const float *vertexes,
+                            const float *gradients,
+                            int count,
+                            const ShadowColor &color,
+                            float vertexZ) {
+        mBlendScissor = NULL;
+        SoftwareRenderBackend::drawShadow(vertexes, gradients, count, color,
+                                          vertexZ);
+    }
+};
+
+/**
+ * Pbuffer context of EGL which GL backends draw in
+ */
+class PbufferContext {
+
+public:
+    PbufferContext()
+            : mDisplay(EGL_NO_DISPLAY),
+              mSurface(EGL_NO_SURFACE),
+              mContext(EGL_NO_CONTEXT) {
+    }
+
+    ~PbufferContext() {
+        if (mDisplay != EGL_NO_DISPLAY) {
+            eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                           EGL_NO_CONTEXT);
+            if (mContext != EGL_NO_CONTEXT) {
+                eglDestroyContext(mDisplay, mContext);
+            }
+            if (mSurface != EGL_NO_SURFACE) {
+                eglDestroySurface(mDisplay, mSurface);
+            }
+        }
+    }
+
+    /**
+     * Create pbuffer of surface size and make a context of given GLES
+     * version current
+     *
+     * @return Error::OK if successfully
+     */
+    int create(int width, int height, int version) {
+        mDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (mDisplay == EGL_NO_DISPLAY ||
+            !eglInitialize(mDisplay, NULL, NULL) ||
+            !eglBindAPI(EGL_OPENGL_ES_API)) {
+            LOGE(TAG, "Can't initialize EGL display");
+            return Error::ERR_GL_ERROR;
+        }
+
+        const EGLint configAttribs[] = {
+                EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE,
+                version >= 3 ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_ES2_BIT,
+                EGL_RED_SIZE, 8,
+                EGL_GREEN_SIZE, 8,
+                EGL_BLUE_SIZE, 8,
+                EGL_ALPHA_SIZE, 8,
+                EGL_DEPTH_SIZE, 16,
+                EGL_NONE
+        };
+        EGLConfig config;
+        EGLint count = 0;
+        if (!eglChooseConfig(mDisplay, configAttribs, &config, 1, &count) ||
+            count < 1) {
+            LOGE(TAG, "No EGL config of GLES%d pbuffer", version);
+            return Error::ERR_GL_ERROR;
+        }
+
+        const EGLint surfaceAttribs[] = {
+                EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE
+        };
+        const EGLint contextAttribs[] = {
+                EGL_CONTEXT_CLIENT_VERSION, version, EGL_NONE
+        };
+        mSurface = eglCreatePbufferSurface(mDisplay, config, surfaceAttribs);
+        mContext = eglCreateContext(mDisplay, config, EGL_NO_CONTEXT,
+                                    contextAttribs);
+        if (mSurface == EGL_NO_SURFACE || mContext == EGL_NO_CONTEXT ||
+            !eglMakeCurrent(mDisplay, mSurface, mSurface, mContext)) {
+            LOGE(TAG, "Can't make GLES%d pbuffer context current", version);
+            return Error::ERR_GL_ERROR;
+        }
+
+        return Error::OK;
+    }
+
+private:
+    EGLDisplay mDisplay;
+    EGLSurface mSurface;
+    EGLContext mContext;
+};
+
+/**
+ * Read pixels of GL frame, rows are flipped to top-down order of software
+ * backend
+ */
+static void readPixels(int width, int height,
+                       std::vector<unsigned char> &pixels) {
+    const size_t stride = (size_t)width * 4;
+    std::vector<unsigned char> rows(stride * height);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &rows[0]);
+
+    pixels.resize(rows.size());
+    for (int y = 0; y < height; ++y) {
+        memcpy(&pixels[stride * y], &rows[stride * (height - 1 - y)],
+               stride);
+    }
+}
+
+/**
+ * Generate checker texture with two colors and a gradient on red channel,
+ * so the flipped and the mapped parts of page are easy to tell apart
+ */
+static std::vector<unsigned char> generateTexture(const unsigned char *dark,
+                                                  const unsigned char *light) {
+    std::vector<unsigned char> pixels(kTextureSize * kTextureSize * 4);
+    for (int y = 0; y < kTextureSize; ++y) {
+        for (int x = 0; x < kTextureSize; ++x) {
+            unsigned char *p = &pixels[(y * kTextureSize + x) * 4];
+            const unsigned char *c = ((x / kTextureCell + y / kTextureCell) & 1)
+                                     ? light : dark;
+            p[0] = (unsigned char)((c[0] + x * 2) >> 1);
+            p[1] = c[1];
+            p[2] = c[2];
+            p[3] = 255;
+        }
+    }
+    return pixels;
+}
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static AndroidBitmapInfo bitmapInfo(int width, int height) {
+    AndroidBitmapInfo info;
+    info.width = (uint32_t)width;
+    info.height = (uint32_t)height;
+    info.stride = (uint32_t)width * 4;
+    info.format = ANDROID_BITMAP_FORMAT_RGBA_8888;
+    info.flags = 0;
+    return info;
+}
+
+TraceOptions::TraceOptions()
+        : threads(1),
+          meshPixels(0),
+          meshTolerance(0),
+          frameBudget(0),
+          isPipelined(false),
+          isAnalyticShadow(false),
+          isFoldClip(false),
+          isDepthFree(false),
+          isScissor(true),
+          glVersion(0),
+          isSinglePass(false) {
+}
+
+/**
+ * Parse options separated by spaces
+ *
+ * @return Error::OK if successfully
+ */
+int TraceOptions::parse(const char *options) {
+    std::istringstream in(options ? options : "");
+    std::string option;
+    while (in >> option) {
+        if (option == "--threads") {
+            if (!(in >> threads) || threads < 1) {
+                return Error::ERR_INVALID_PARAMETER;
+            }
+        }
+        else if (option == "--mesh-pixels") {
+            if (!(in >> meshPixels) || meshPixels < 1) {
+                return Error::ERR_INVALID_PARAMETER;
+            }
+        }
+        else if (option == "--adaptive") {
+            if (!(in >> meshTolerance) || meshTolerance <= 0) {
+                return Error::ERR_INVALID_PARAMETER;
+            }
+        }
+        else if (option == "--frame-budget") {
+            if (!(in >> frameBudget) || frameBudget <= 0) {
+                return Error::ERR_INVALID_PARAMETER;
+            }
+        }
+        else if (option == "--pipelined") {
+            isPipelined = true;
+        }
+        else if (option == "--analytic-shadow") {
+            isAnalyticShadow = true;
+        }
+        else if (option == "--fold-clip") {
+            isFoldClip = true;
+        }
+        else if (option == "--depth-free") {
+            isDepthFree = true;
+        }
+        else if (option == "--no-scissor") {
+            isScissor = false;
+        }
+        else if (option == "--gl") {
+            if (!(in >> glVersion) || glVersion < 2 || glVersion > 3) {
+                return Error::ERR_INVALID_PARAMETER;
+            }
+        }
+        else if (option == "--single-pass") {
+            isSinglePass = true;
+        }
+        else {
+            LOGE(TAG, "Unknown option: %s", option.c_str());
+            return Error::ERR_INVALID_PARAMETER;
+        }
+    }
+
+    // single pass is only drawn by GLES2 backend, frames of others would
+    // pass any check against multi-pass ones
+    if (isSinglePass && glVersion != 2) {
+        LOGE(TAG, "--single-pass needs --gl 2");
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    return Error::OK;
+}
+
+TraceCost::TraceCost()
+        : frames(0),
+          eventTime(0),
+          drawTime(0),
+          meshCount(0) {
+}
+
+TraceRenderer::TraceRenderer(const TraceOptions &options)
+        : mOptions(options) {
+}
+
+/**
+ * Is there an EGL display for GL backends, e.g. Mesa with
+ * EGL_PLATFORM=surfaceless
+ */
+bool TraceRenderer::hasEGL() {
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    return display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL);
+}
+
+/**
+ * Play trace and dump frames
+ *
+ * @param tracePath trace file
+ * @param outDir directory of dumped frames, it must exist
+ * @param isCompressed dump compressed PNG files, e.g. for golden images
+ * @return Error::OK if successfully
+ */
+int TraceRenderer::play(const char *tracePath, const char *outDir,
+                        bool isCompressed) {
+    FILE *file = fopen(tracePath, "r");
+    if (file == NULL) {
+        LOGE(TAG, "Can't open trace: %s", tracePath);
+        return Error::ERR_INVALID_PARAMETER;
+    }
+
+    SoftwareRenderBackend scissoredBackend;
+    UnscissoredBackend unscissoredBackend;
+    SoftwareRenderBackend &backend = mOptions.isScissor ? scissoredBackend
+                                                        : unscissoredBackend;
+    // pbuffer context outlives page flip which deletes GL objects in it
+    PbufferContext glContext;
+    PageFlip pageFlip;
+    std::vector<unsigned char> glPixels;
+    int width = 0;
+    int height = 0;
+    bool hasSurface = false;
+    int ret = Error::OK;
+    mFrames.clear();
+    mCost = TraceCost();
+
+    char line[256];
+    for (int lineNo = 1; ret == Error::OK && fgets(line, sizeof(line), file);
+         ++lineNo) {
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+
+        char cmd[32], name[128];
+        float x, y;
+        int a, b;
+        if (sscanf(line, "%31s", cmd) != 1) {
+            continue;
+        }
+
+        if (!hasSurface && strcmp(cmd, "surface") != 0) {
+            LOGE(TAG, "%s:%d: surface must be the first", tracePath, lineNo);
+            ret = Error::ERR_INVALID_PARAMETER;
+        }
+        else if (strcmp(cmd, "surface") == 0 &&
+                 sscanf(line, "%*s %d %d", &a, &b) == 2) {
+            width = a;
+            height = b;
+            if (mOptions.glVersion > 0) {
+                ret = glContext.create(width, height, mOptions.glVersion);
+                if (ret == Error::OK) {
+                    ret = pageFlip.setRenderBackendType(
+                            mOptions.glVersion >= 3 ? GLES3_RENDER_BACKEND
+                                                    : GLES2_RENDER_BACKEND);
+                }
+            }
+            else {
+                pageFlip.setRenderBackend(&backend);
+            }
+            pageFlip.enableAnalyticShadow(mOptions.isAnalyticShadow);
+            pageFlip.enableFoldClip(mOptions.isFoldClip);
+            pageFlip.enableDepthFree(mOptions.isDepthFree);
+            pageFlip.enableSinglePass(mOptions.isSinglePass);
+            if (mOptions.meshPixels > 0) {
+                pageFlip.setPixelsOfMesh(mOptions.meshPixels);
+            }
+            if (mOptions.meshTolerance > 0) {
+                ret = pageFlip.setMeshDensityMode(ADAPTIVE_MESH_DENSITY);
+                if (ret == Error::OK) {
+                    ret = pageFlip.setMeshTolerance(mOptions.meshTolerance);
+                }
+            }
+            if (ret == Error::OK && mOptions.frameBudget > 0) {
+                ret = pageFlip.setFrameBudget(mOptions.frameBudget);
+            }
+
+            if (ret == Error::OK) {
+                ret = pageFlip.onSurfaceCreated();
+            }
+            // GLES3 backend silently falls back to GLES2 one
+            if (ret == Error::OK && mOptions.glVersion >= 3 &&
+                pageFlip.renderBackendType() != GLES3_RENDER_BACKEND) {
+                LOGE(TAG, "GLES3 backend isn't supported");
+                ret = Error::ERR_UNSUPPORT_GLES3;
+            }
+            if (ret == Error::OK) {
+                pageFlip.onSurfaceChanged(a, b);
+                ret = pageFlip.setGeometryThreads(mOptions.threads);
+            }
+
+            if (ret == Error::OK) {
+                ret = pageFlip.enablePipelinedGeometry(mOptions.isPipelined);
+            }
+
+            if (ret == Error::OK) {
+                static const unsigned char colors[][3] = {
+                        { 200, 40, 40 }, { 250, 220, 200 },
+                        { 40, 60, 200 }, { 200, 220, 250 },
+                        { 90, 90, 90 }, { 230, 230, 230 },
+                };
+                std::vector<unsigned char> first =
+                        generateTexture(colors[0], colors[1]);
+                std::vector<unsigned char> second =
+                        generateTexture(colors[2], colors[3]);
+                std::vector<unsigned char> back =
+                        generateTexture(colors[4], colors[5]);
+                AndroidBitmapInfo info = bitmapInfo(kTextureSize,
+                                                    kTextureSize);
+                Page *page = pageFlip.getPage(true);
+                page->textures.setFirstTexture(info, &first[0]);
+                page->textures.setSecondTexture(info, &second[0]);
+                page->textures.setBackTexture(info, &back[0]);
+
+                // light is strong at fold and fades out
+                std::vector<unsigned char> light(256 * 4, 0);
+                for (int i = 0; i < 256; ++i) {
+                    light[i * 4 + 3] = (unsigned char)(255 - i);
+                }
+                info = bitmapInfo(256, 1);
+                ret = pageFlip.setGradientLightTexture(info, &light[0]);
+            }
+            hasSurface = true;
+        }
+        else if (strcmp(cmd, "stack") == 0 &&
+                 sscanf(line, "%*s %d %f", &a, &x) == 2) {
+            ret = pageFlip.setPageStack(a, x);
+        }
+        else if (strcmp(cmd, "progress") == 0 &&
+                 sscanf(line, "%*s %f", &x) == 1) {
+            ret = pageFlip.setBookProgress(x);
+        }
+        else if (strcmp(cmd, "down") == 0 &&
+                 sscanf(line, "%*s %f %f", &x, &y) == 2) {
+            const double start = now();
+            pageFlip.onFingerDown(x, y);
+            mCost.eventTime += now() - start;
+        }
+        else if (strcmp(cmd, "move") == 0 &&
+                 sscanf(line, "%*s %f %f", &x, &y) == 2) {
+            const double start = now();
+            pageFlip.onFingerMove(x, y, true, false);
+            mCost.eventTime += now() - start;
+        }
+        else if (strcmp(cmd, "up") == 0 &&
+                 sscanf(line, "%*s %f %f %d", &x, &y, &a) == 3) {
+            const double start = now();
+            pageFlip.onFingerUp(x, y, a, true, false);
+            mCost.eventTime += now() - start;
+        }
+        else if ((strcmp(cmd, "frame") == 0 || strcmp(cmd, "page") == 0) &&
+                 sscanf(line, "%*s %127s", name) == 1) {
+            if (cmd[0] == 'f') {
+                const double start = now();
+                pageFlip.drawFlipFrame();
+                mCost.drawTime += now() - start;
+                mCost.meshCount += pageFlip.meshCount();
+                ++mCost.frames;
+            }
+            else {
+                pageFlip.drawPageFrame();
+            }
+
+            std::string path = std::string(outDir) + "/" + name + ".png";
+            if (mOptions.glVersion > 0) {
+                readPixels(width, height, glPixels);
+                PngImage image;
+                ret = image.set(width, height, &glPixels[0],
+                                (size_t)width * 4);
+                if (ret == Error::OK) {
+                    ret = image.save(path.c_str());
+                }
+            }
+            else if (isCompressed) {
+                PngImage image;
+                ret = image.set(backend.width(), backend.height(),
+                                backend.pixels(), (size_t)backend.width() * 4);
+                if (ret == Error::OK) {
+                    ret = image.save(path.c_str());
+                }
+            }
+            else {
+                ret = backend.writePNG(path.c_str());
+            }
+            mFrames.push_back(name);
+        }
+        else {
+            LOGE(TAG, "%s:%d: invalid command: %s", tracePath, lineNo, line);
+            ret = Error::ERR_INVALID_PARAMETER;
+        }
+    }
+
+    fclose(file);
+    return ret;
+}
+
+}
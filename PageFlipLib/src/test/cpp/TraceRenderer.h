@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_TRACERENDERER_H
+#define ANDROID_PAGEFLIP_TRACERENDERER_H
+
+#include <string>
+#include <vector>
+
+namespace eschao {
+
+/**
+ * PageFlip options applied before a trace is played
+ * <p>Options are parsed from one string, e.g. "--threads 4 --fold-clip":
+ * <ul>
+ *     <li>--threads n: geometry threads</li>
+ *     <li>--mesh-pixels n: pixels of mesh</li>
+ *     <li>--adaptive tolerance: adaptive mesh density with tolerance</li>
+ *     <li>--frame-budget ms: frame budget of adaptive mesh density</li>
+ *     <li>--pipelined: compute geometry in worker thread</li>
+ *     <li>--analytic-shadow: cast fold shadows in page shading</li>
+ *     <li>--fold-clip: clip flat page by fold line</li>
+ *     <li>--depth-free: draw meshes back to front without depth test</li>
+ *     <li>--no-scissor: don't scissor blended shadow passes</li>
+ *     <li>--gl version: draw with built-in GL backend of GLES 2 or 3 in
+ *     a pbuffer of EGL instead of software backend</li>
+ *     <li>--single-pass: draw flip frame by one draw call, it only works
+ *     with --gl 2</li>
+ * </ul></p>
+ */
+struct TraceOptions {
+    int threads;
+    int meshPixels;
+    // 0 means fixed mesh density
+    float meshTolerance;
+    // 0 means the default frame budget
+    float frameBudget;
+    bool isPipelined;
+    bool isAnalyticShadow;
+    bool isFoldClip;
+    bool isDepthFree;
+    bool isScissor;
+    // 0 means software backend
+    int glVersion;
+    bool isSinglePass;
+
+    TraceOptions();
+    int parse(const char *options);
+};
+
+/**
+ * Cost of played trace, only flip frames are counted
+ */
+struct TraceCost {
+    int frames;
+    // time of finger events which compute meshes
+    double eventTime;
+    // time of drawing flip frames
+    double drawTime;
+    // sum of mesh counts of flip frames
+    int meshCount;
+
+    TraceCost();
+};
+
+/**
+ * Play a trace of finger events with the software render backend, or GL
+ * backend with option --gl, and dump the drawn frames to PNG files
+ * <p>Trace is a text file, every line is one command and '#' starts a
+ * comment:
+ * <ul>
+ *     <li>surface width height: create surface, it must be the first</li>
+ *     <li>stack layers width: set page stack</li>
+ *     <li>progress ratio: set book progress of page stack</li>
+ *     <li>down x y, move x y, up x y duration: finger events, the flip can
+ *     only go forward</li>
+ *     <li>frame name: draw flip frame and dump it to name.png</li>
+ *     <li>page name: draw page frame and dump it to name.png</li>
+ * </ul>
+ * Textures of pages are generated patterns, so traces don't need image
+ * files</p>
+ */
+class TraceRenderer {
+
+public:
+    TraceRenderer(const TraceOptions &options);
+
+    static bool hasEGL();
+    int play(const char *tracePath, const char *outDir, bool isCompressed);
+
+    // inline
+    inline const std::vector<std::string>& frames() const {
+        return mFrames;
+    }
+
+    inline const TraceCost& cost() const {
+        return mCost;
+    }
+
+private:
+    TraceOptions mOptions;
+    // names of dumped frames in trace order
+    std::vector<std::string> mFrames;
+    TraceCost mCost;
+};
+
+}
+#endif //ANDROID_PAGEFLIP_TRACERENDERER_H
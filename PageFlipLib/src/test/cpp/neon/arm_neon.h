@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2016 eschao <esc.chao@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PAGEFLIP_TEST_ARM_NEON_H
+#define ANDROID_PAGEFLIP_TEST_ARM_NEON_H
+
+/**
+ * Scalar emulation of the NEON intrinsics used by Vec4.h and Matrix.cpp
+ * <p>It is only for host tests on machines without ARM toolchain: NEON code
+ * paths are compiled with -D__ARM_NEON and this header instead of the real
+ * one, so lane order and logic of them are checked against scalar code.
+ * Every intrinsic follows the lane semantics of ARM reference, it says
+ * nothing about speed or about compiling with the real arm_neon.h</p>
+ */
+
+typedef struct { float lane[2]; } float32x2_t;
+typedef struct { float lane[4]; } float32x4_t;
+typedef struct { float32x4_t val[2]; } float32x4x2_t;
+
+static inline float32x2_t vdup_n_f32(float s) {
+    float32x2_t r = {{ s, s }};
+    return r;
+}
+
+static inline float32x4_t vdupq_n_f32(float s) {
+    float32x4_t r = {{ s, s, s, s }};
+    return r;
+}
+
+#define vset_lane_f32(s, v, i) neonSetLane2((s), (v), (i))
+
+static inline float32x2_t neonSetLane2(float s, float32x2_t v, int i) {
+    v.lane[i] = s;
+    return v;
+}
+
+static inline float32x4_t vcombine_f32(float32x2_t low, float32x2_t high) {
+    float32x4_t r = {{ low.lane[0], low.lane[1], high.lane[0], high.lane[1] }};
+    return r;
+}
+
+static inline float32x2_t vget_low_f32(float32x4_t v) {
+    float32x2_t r = {{ v.lane[0], v.lane[1] }};
+    return r;
+}
+
+static inline float32x2_t vget_high_f32(float32x4_t v) {
+    float32x2_t r = {{ v.lane[2], v.lane[3] }};
+    return r;
+}
+
+static inline float32x4_t vld1q_f32(const float *p) {
+    float32x4_t r = {{ p[0], p[1], p[2], p[3] }};
+    return r;
+}
+
+static inline void vst1q_f32(float *p, float32x4_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = v.lane[i];
+}
+
+static inline float32x4_t vaddq_f32(float32x4_t a, float32x4_t b) {
+    for (int i = 0; i < 4; ++i) a.lane[i] += b.lane[i];
+    return a;
+}
+
+static inline float32x4_t vsubq_f32(float32x4_t a, float32x4_t b) {
+    for (int i = 0; i < 4; ++i) a.lane[i] -= b.lane[i];
+    return a;
+}
+
+static inline float32x4_t vmulq_f32(float32x4_t a, float32x4_t b) {
+    for (int i = 0; i < 4; ++i) a.lane[i] *= b.lane[i];
+    return a;
+}
+
+static inline float32x4_t vdivq_f32(float32x4_t a, float32x4_t b) {
+    for (int i = 0; i < 4; ++i) a.lane[i] /= b.lane[i];
+    return a;
+}
+
+static inline float32x4_t vmulq_n_f32(float32x4_t a, float s) {
+    for (int i = 0; i < 4; ++i) a.lane[i] *= s;
+    return a;
+}
+
+// vmla isn't fused, it rounds the product before adding
+static inline float32x4_t vmlaq_n_f32(float32x4_t a, float32x4_t b, float s) {
+    for (int i = 0; i < 4; ++i) {
+        const float p = b.lane[i] * s;
+        a.lane[i] += p;
+    }
+    return a;
+}
+
+// transpose 2x2 blocks: ({a0, b0, a2, b2}, {a1, b1, a3, b3})
+static inline float32x4x2_t vtrnq_f32(float32x4_t a, float32x4_t b) {
+    float32x4x2_t r = {{
+            {{ a.lane[0], b.lane[0], a.lane[2], b.lane[2] }},
+            {{ a.lane[1], b.lane[1], a.lane[3], b.lane[3] }}
+    }};
+    return r;
+}
+
+#endif //ANDROID_PAGEFLIP_TEST_ARM_NEON_H
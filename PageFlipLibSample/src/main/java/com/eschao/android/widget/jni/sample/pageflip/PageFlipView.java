@@ -71,6 +71,10 @@ public class PageFlipView extends GLSurfaceView implements Renderer {
         PageFlipLib.enableAutoPage(isAuto);
         setEGLContextClientVersion(2);
 
+        // pages are drawn from back to front, no depth buffer is needed
+        PageFlipLib.enableDepthFree(true);
+        setEGLConfigChooser(8, 8, 8, 0, 0, 0);
+
         // init others
         mPageNo = 1;
         mDrawLock = new ReentrantLock();